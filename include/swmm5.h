@@ -75,6 +75,106 @@ int  DLLEXPORT   swmm_start(int saveFlag);
 */
 int  DLLEXPORT   swmm_step(double* elapsedTime);
 
+/**
+ @brief Step SWMM simulation forward by many routing steps in one call
+ @param n maximum number of routing steps to take (not negative)
+ @param[out] elapsedTime elapsed simulation time [decimal days], 0 once the
+ simulation has ended
+ @return error code (501 if n is negative, which also ends the run like any
+ other error)
+ The call returns early when the simulation ends or a stop condition (see
+ swmm_addStopCondition) becomes true.
+*/
+int  DLLEXPORT   swmm_stepN(int n, double* elapsedTime);
+
+/**
+ @brief Step SWMM simulation forward until an elapsed time is reached
+ @param targetTime elapsed simulation time to advance to [decimal days]
+ (not negative)
+ @param[out] elapsedTime elapsed simulation time [decimal days], 0 once the
+ simulation has ended
+ @return error code (501 if targetTime is negative, which also ends the run
+ like any other error)
+ The call returns early when the simulation ends or a stop condition (see
+ swmm_addStopCondition) becomes true.
+*/
+int  DLLEXPORT   swmm_stepUntil(double targetTime, double* elapsedTime);
+
+/**
+ @brief Register a condition that stops swmm_stepN and swmm_stepUntil
+ @param type object type code (SM_NODE, SM_LINK or SM_SUBCATCH), or
+ SM_CONTROL to stop whenever a control rule action is taken
+ @param index index of the node, link or subcatchment
+ @param result result code of the object (SM_NodeResult, SM_LinkResult or
+ SM_SubcResult in toolkitAPI.h)
+ @param relation 1 to stop when the result rises to or above threshold,
+ -1 to stop when it falls to or below threshold
+ @param threshold value of the result in user units
+ @return API error code
+ A condition stops the simulation at the step in which it becomes true, not
+ at every step for which it remains true. Conditions remain registered until
+ swmm_clearStopConditions or swmm_close is called.
+*/
+int  DLLEXPORT   swmm_addStopCondition(int type, int index, int result,
+                 int relation, double threshold);
+
+/**
+ @brief Remove all registered stop conditions
+ @return API error code
+*/
+int  DLLEXPORT   swmm_clearStopConditions(void);
+
+/**
+ @brief Get the stop condition that ended the last multi-step call
+ @param[out] condition index of the condition in order of registration, or
+ -1 if the call was not ended by a stop condition
+ @return API error code
+*/
+int  DLLEXPORT   swmm_getStopCondition(int* condition);
+
+/**
+ @brief Points in a routing time step at which step callbacks are called
+*/
+typedef enum {
+    SM_BEFORECONTROLS = 0, /**< Before control rules are evaluated */
+    SM_AFTERROUTING   = 1, /**< After flow routing */
+    SM_AFTERQUALITY   = 2, /**< After water quality routing */
+    SM_REPORTTIME     = 3  /**< At each reporting time (after its results are
+                                saved, if results are being saved) */
+} SM_StepPoint;
+
+/**
+ @brief A user function called at a point in each routing time step
+ @param point the point reached (SM_StepPoint)
+ @param elapsedTime elapsed simulation time of the state [decimal days]
+ @param userData the pointer given to swmm_setStepCallback
+*/
+typedef void (*SM_StepCallback)(int point, double elapsedTime, void* userData);
+
+/**
+ @brief Register a function called at a point in each routing time step
+ @param point the point at which to call it (SM_StepPoint)
+ @param callback the function to call, or NULL to remove the current one
+ @param userData pointer passed back to the callback
+ @return API error code
+ The callback runs within swmm_step and may read and change the simulation
+ state through the toolkit API (e.g., swmm_getStateView, swmm_setLinkSettings
+ or swmm_setNodeInflows). Link settings changed before controls are subject
+ to the project's control rules in the same step. The before controls, after
+ routing and after quality points are only reached when flow is routed: they
+ are never reached in runs with no nodes or with routing ignored (e.g.,
+ runoff-only runs), and the after routing and after quality points are
+ skipped in steps that fall between routing events. The reporting time point
+ is reached in every run, whether or not swmm_start was asked to save
+ results.
+ A callback must not run, end or close the simulation: while it runs,
+ swmm_run, swmm_open, swmm_start, swmm_step, swmm_stepN, swmm_stepUntil,
+ swmm_end, swmm_report and swmm_close do nothing and return error 511.
+ Callbacks remain registered until swmm_close is called.
+*/
+int  DLLEXPORT   swmm_setStepCallback(int point, SM_StepCallback callback,
+                 void* userData);
+
 /**
  @brief End SWMM simulation
  @return error code
@@ -299,6 +299,22 @@ typedef struct
    double        pctError;        // continuity error (%)
 }  SM_RunoffTotals;
 
+/// Version of the state view structure defined by this header
+#define SM_STATEVIEW_VERSION 1
+
+/// Read-only view of a result held for every object of a type. The value
+/// of object k is the double at data + k*stride bytes and is converted to
+/// user units by multiplying it by scale. The view stays valid and its
+/// values are updated in place by each swmm_step until swmm_close.
+typedef struct
+{
+   int           version;          // version of structure (SM_STATEVIEW_VERSION)
+   int           count;            // number of objects
+   int           stride;           // bytes from one object's value to next
+   const void*   data;             // address of first object's value
+   double        scale;            // factor converting values to user units
+}  SM_StateView;
+
 
 // --- Declare SWMM toolkit API Function
 
@@ -512,6 +528,58 @@ int DLLEXPORT swmm_getLinkResult(int index, int type, double *result);
 */
 int DLLEXPORT swmm_getSubcatchResult(int index, int type, double *result);
 
+/**
+ @brief Get a result value for many nodes in one call.
+ @param type The property type code (See @ref SM_NodeResult)
+ @param indexes The indexes of the nodes, or NULL for nodes 0 to count-1
+ @param count The number of nodes
+ @param[out] results The value of each node's property. results must be
+ pre-allocated by the caller to hold count values.
+ @return Error code
+*/
+int DLLEXPORT swmm_getNodeResults(int type, const int *indexes, int count,
+                                  double *results);
+
+/**
+ @brief Get a result value for many links in one call.
+ @param type The property type code (See @ref SM_LinkResult)
+ @param indexes The indexes of the links, or NULL for links 0 to count-1
+ @param count The number of links
+ @param[out] results The value of each link's property. results must be
+ pre-allocated by the caller to hold count values.
+ @return Error code
+*/
+int DLLEXPORT swmm_getLinkResults(int type, const int *indexes, int count,
+                                  double *results);
+
+/**
+ @brief Get a result value for many subcatchments in one call.
+ @param type The property type code (See @ref SM_SubcResult)
+ @param indexes The indexes of the subcatchments, or NULL for subcatchments
+ 0 to count-1
+ @param count The number of subcatchments
+ @param[out] results The value of each subcatchment's property. results must
+ be pre-allocated by the caller to hold count values.
+ @return Error code
+*/
+int DLLEXPORT swmm_getSubcatchResults(int type, const int *indexes, int count,
+                                      double *results);
+
+/**
+ @brief Get a read-only view of a result of every node, link or subcatchment
+ that can be read after each time step without copying it.
+ @param type The object type (SM_NODE, SM_LINK or SM_SUBCATCH)
+ @param result The result code (See @ref SM_NodeResult, @ref SM_LinkResult
+ and @ref SM_SubcResult). SM_NODEHEAD is not held by the engine and has no
+ view; add the invert elevation (@ref SM_INVERTEL) to the node depth instead.
+ @param version The version of the view structure the caller was built with
+ (SM_STATEVIEW_VERSION). Unsupported versions are rejected.
+ @param[out] view The view of the result (see @ref SM_StateView)
+ @return Error code
+*/
+int DLLEXPORT swmm_getStateView(int type, int result, int version,
+                                SM_StateView *view);
+
 /**
  @brief Get a node statistics.
  @param index The index of a node
@@ -643,6 +711,31 @@ int DLLEXPORT swmm_setLinkSetting(int index, double setting);
 */
 int DLLEXPORT swmm_setNodeInflow(int index, double flowrate);
 
+/**
+ @brief Set the settings of many links in one call (see
+ @ref swmm_setLinkSetting). No setting is changed if any index is invalid.
+ @param indexes The link indexes, or NULL for links 0 to count-1
+ @param count The number of links
+ @param settings The new setting of each link
+ @return Error code
+*/
+int DLLEXPORT swmm_setLinkSettings(const int *indexes, int count,
+                                   const double *settings);
+
+/**
+ @brief Set the inflow rates of many nodes in one call (see
+ @ref swmm_setNodeInflow). No inflow is changed if any index is invalid.
+ Otherwise the nodes are set in turn, so if one node's inflow cannot be set
+ (e.g., for lack of memory) the nodes before it keep their new inflows and
+ the nodes after it are left unchanged.
+ @param indexes The node indexes, or NULL for nodes 0 to count-1
+ @param count The number of nodes
+ @param flowrates The new inflow rate of each node
+ @return Error code
+*/
+int DLLEXPORT swmm_setNodeInflows(const int *indexes, int count,
+                                  const double *flowrates);
+
 /**
  @brief Set outfall stage.
  @param index The outfall node index. 
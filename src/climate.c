@@ -27,6 +27,20 @@
 //             
 //   Build 5.1.011:
 //   - Monthly adjustment for hyd. conductivity <= 0 is ignored.
+//
+//   The daily values of a climate file are parsed only once, when the file
+//   is opened, into a table indexed by the number of days elapsed since the
+//   start of the simulation. The table can be saved to (or re-used from) a
+//   binary climate table file named in the [FILES] section:
+//     USE/SAVE  CLIMATE  FileName
+//   Its layout is:
+//     File stamp ("SWMM5-CLIM") (10 bytes)
+//     Size of the climate file (8-byte double)
+//     Last modification time of the climate file (8-byte double)
+//     Unit system (4-byte int)
+//     Date of first table entry (8-byte double)
+//     Number of days in table (4-byte int)
+//     For each day: TMIN, TMAX, EVAP and WIND values (4 8-byte doubles)
 ///-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -105,13 +119,19 @@ static int      FileFieldPos[4];       // start of data fields for file record /
 static int      FileDateFieldPos;      // start of date field for file record  //(5.1.007)
 static int      FileWindType;          // wind speed type;                     //(5.1.007)
 
+// Climate table variables
+static double*  FileTable;             // daily climate data by elapsed day
+static int      FileTableDays;         // number of days in FileTable
+static DateTime FileTableStart;        // date of first day in FileTable
+
 //-----------------------------------------------------------------------------
 //  External functions (defined in funcs.h)
 //-----------------------------------------------------------------------------
 //  climate_readParams                 // called by input_parseLine
 //  climate_readEvapParams             // called by input_parseLine
 //  climate_validate                   // called by project_validate
-//  climate_openFile                   // called by runoff_open
+//  climate_openFile                   // called by climate_validate
+//  climate_closeFile                  // called by project_close
 //  climate_initState                  // called by project_init
 //  climate_setState                   // called by runoff_execute
 //  climate_getNextEvapDate            // called by runoff_getTimeStep         //(5.1.008)
@@ -125,6 +145,11 @@ static void readUserFileLine(int *year, int *month);
 static void readTD3200FileLine(int *year, int *month);
 static void readDLY0204FileLine(int *year, int *month);
 static void readFileValues(void);
+static void createFileTable(void);
+static int  readFileTable(void);
+static void saveFileTable(void);
+static void initFileValues(void);
+static int  fileTableIsCurrent(void);
 
 static void setNextEvapDate(DateTime thedate);                                 //(5.1.008)
 static void setEvap(DateTime theDate);
@@ -482,10 +507,56 @@ void climate_openFile()
 //
 //  Input:   none
 //  Output:  none
-//  Purpose: opens a climate file and reads in first set of values.
+//  Purpose: opens a climate file and tabulates its daily values.
 //
 {
-    int i, m, y;
+    // --- find the date where the climate table begins
+    FileTable = NULL;
+    FileTableDays = (int)(floor(EndDateTime) - floor(StartDateTime)) + 1;
+    if ( Temp.fileStartDate == NO_DATE )
+        datetime_decodeDate(StartDate, &FileYear, &FileMonth, &FileDay);
+    else
+        datetime_decodeDate(Temp.fileStartDate, &FileYear, &FileMonth, &FileDay);
+    FileTableStart = datetime_encodeDate(FileYear, FileMonth, FileDay);
+
+    // --- re-use a previously saved climate table if it is still current
+    if ( Fclimcache.mode == USE_FILE && readFileTable() )
+    {
+        initFileValues();
+        return;
+    }
+
+    // --- otherwise parse the table from the climate file
+    createFileTable();
+    if ( ErrorCode ) return;
+    if ( Fclimcache.mode != NO_FILE ) saveFileTable();
+    initFileValues();
+}
+
+//=============================================================================
+
+void climate_closeFile()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the table of daily climate file values.
+//
+{
+    FREE(FileTable);
+    FileTableDays = 0;
+}
+
+//=============================================================================
+
+void createFileTable()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: reads the daily values of the climate file that span the
+//           simulation period into FileTable.
+//
+{
+    int i, k, m, y;
 
     // --- open the file
     if ( (Fclimate.file = fopen(Fclimate.name, "rt")) == NULL )
@@ -494,13 +565,6 @@ void climate_openFile()
         return;
     }
 
-    // --- initialize values of file's climate variables
-    //     (Temp.ta was previously initialized in project.c)
-    FileValue[TMIN] = Temp.ta;
-    FileValue[TMAX] = Temp.ta;
-    FileValue[EVAP] = 0.0;
-    FileValue[WIND] = 0.0;
-
     // --- find climate file's format
     FileFormat = getFileFormat();
     if ( FileFormat == UNKNOWN_FORMAT )
@@ -513,10 +577,6 @@ void climate_openFile()
     //     month/year or at start of simulation period.
     rewind(Fclimate.file);
     strcpy(FileLine, "");
-    if ( Temp.fileStartDate == NO_DATE )
-        datetime_decodeDate(StartDate, &FileYear, &FileMonth, &FileDay);
-    else
-        datetime_decodeDate(Temp.fileStartDate, &FileYear, &FileMonth, &FileDay);
     while ( !feof(Fclimate.file) )
     {
         strcpy(FileLine, "");
@@ -529,18 +589,179 @@ void climate_openFile()
         return;
     }
 
-    // --- initialize file dates and current climate variable values
-    if ( !ErrorCode )
+    // --- allocate the climate table
+    FileTable = (double *) calloc(FileTableDays * MAXCLIMATEVARS,
+                                  sizeof(double));
+    if ( FileTable == NULL )
     {
-        FileElapsedDays = 0;
-        FileLastDay = datetime_daysPerMonth(FileYear, FileMonth);
-        readFileValues();
-        for (i=TMIN; i<=WIND; i++)
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+    }
+
+    // --- copy each day's values into the table, reading in another
+    //     month of data from the file whenever a new month begins
+    FileLastDay = datetime_daysPerMonth(FileYear, FileMonth);
+    readFileValues();
+    for (k = 0; k < FileTableDays && !ErrorCode; k++)
+    {
+        if ( FileDay > FileLastDay )
+        {
+            FileMonth++;
+            if ( FileMonth > 12 )
+            {
+                FileMonth = 1;
+                FileYear++;
+            }
+            readFileValues();
+            FileDay = 1;
+            FileLastDay = datetime_daysPerMonth(FileYear, FileMonth);
+        }
+        for (i = TMIN; i <= WIND; i++)
         {
-            if ( FileData[i][FileDay] == MISSING ) continue;
-            FileValue[i] = FileData[i][FileDay];
+            FileTable[k*MAXCLIMATEVARS + i] = FileData[i][FileDay];
         }
+        FileDay++;
     }
+
+    // --- the climate file is no longer needed
+    fclose(Fclimate.file);
+    Fclimate.file = NULL;
+}
+
+
+//=============================================================================
+
+int readFileTable()
+//
+//  Input:   none
+//  Output:  returns TRUE if climate table was read, FALSE if not
+//  Purpose: reads the climate table from a climate table file if that
+//           file was made from the current climate file and covers the
+//           simulation period.
+//
+{
+    char     fileStamp[] = "SWMM5-CLIM";
+    char     fStamp[] = "SWMM5-CLIM";
+    int      n, units, ndays;
+    double   size, mtime, stamp[2];
+    DateTime startDate;
+    FILE*    f;
+
+    // --- check that the file's stamp and header match the climate file
+    if ( !getFileStamp(Fclimate.name, &size, &mtime) ) return FALSE;
+    if ( (f = fopen(Fclimcache.name, "rb")) == NULL ) return FALSE;
+    n = (int)fread(fStamp, sizeof(char), strlen(fileStamp), f);
+    n += (int)fread(stamp, sizeof(double), 2, f);
+    n += (int)fread(&units, sizeof(int), 1, f);
+    n += (int)fread(&startDate, sizeof(DateTime), 1, f);
+    n += (int)fread(&ndays, sizeof(int), 1, f);
+    if ( n != (int)strlen(fileStamp) + 5 ||
+         strcmp(fStamp, fileStamp) != 0 ||
+         stamp[0] != size || stamp[1] != mtime ||
+         units != UnitSystem ||
+         startDate != FileTableStart ||
+         ndays < FileTableDays )
+    {
+        fclose(f);
+        return FALSE;
+    }
+
+    // --- read the table's daily values
+    FileTable = (double *) calloc(FileTableDays * MAXCLIMATEVARS,
+                                  sizeof(double));
+    if ( FileTable == NULL )
+    {
+        fclose(f);
+        return FALSE;
+    }
+    n = (int)fread(FileTable, sizeof(double), FileTableDays * MAXCLIMATEVARS,
+                   f);
+    fclose(f);
+    if ( n != FileTableDays * MAXCLIMATEVARS )
+    {
+        FREE(FileTable);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+void saveFileTable()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: writes the climate table to a climate table file.
+//
+{
+    char   fileStamp[] = "SWMM5-CLIM";
+    double stamp[2];
+    FILE*  f;
+
+    if ( FileTable == NULL ) return;
+    if ( (f = fopen(Fclimcache.name, "wb")) == NULL )
+    {
+        // --- failing to refresh a USE file just means it isn't re-used
+        if ( Fclimcache.mode == SAVE_FILE )
+            report_writeErrorMsg(ERR_CLIMATE_FILE_OPEN, Fclimcache.name);
+        return;
+    }
+    getFileStamp(Fclimate.name, &stamp[0], &stamp[1]);
+    fwrite(fileStamp, sizeof(char), strlen(fileStamp), f);
+    fwrite(stamp, sizeof(double), 2, f);
+    fwrite(&UnitSystem, sizeof(int), 1, f);
+    fwrite(&FileTableStart, sizeof(DateTime), 1, f);
+    fwrite(&FileTableDays, sizeof(int), 1, f);
+    fwrite(FileTable, sizeof(double), FileTableDays * MAXCLIMATEVARS, f);
+    fclose(f);
+}
+
+//=============================================================================
+
+void initFileValues()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: sets the current climate file values to those of the first
+//           day of the simulation.
+//
+{
+    int i;
+
+    // --- initialize values of file's climate variables
+    //     (Temp.ta was previously initialized in project.c)
+    FileValue[TMIN] = Temp.ta;
+    FileValue[TMAX] = Temp.ta;
+    FileValue[EVAP] = 0.0;
+    FileValue[WIND] = 0.0;
+
+    // --- assign values for first day, skipping missing ones
+    FileElapsedDays = 0;
+    if ( FileTable == NULL ) return;
+    for (i = TMIN; i <= WIND; i++)
+    {
+        if ( FileTable[i] == MISSING ) continue;
+        FileValue[i] = FileTable[i];
+    }
+}
+
+//=============================================================================
+
+int fileTableIsCurrent()
+//
+//  Input:   none
+//  Output:  returns TRUE if the climate table covers the simulation period
+//  Purpose: checks that the climate table still starts on the same date and
+//           spans all days of the simulation period.
+//
+{
+    int y, m, d;
+
+    if ( FileTable == NULL ) return FALSE;
+    if ( Temp.fileStartDate == NO_DATE ) datetime_decodeDate(StartDate, &y, &m, &d);
+    else datetime_decodeDate(Temp.fileStartDate, &y, &m, &d);
+    if ( datetime_encodeDate(y, m, d) != FileTableStart ) return FALSE;
+    return (int)(floor(EndDateTime) - floor(StartDateTime)) + 1 <= FileTableDays;
 }
 
 //=============================================================================
@@ -560,6 +781,19 @@ void climate_initState()
     NextEvapDate = StartDate;
     NextEvapRate = 0.0;
 
+    // --- re-start climate file values from the first day of the table,
+    //     re-building the table if the simulation dates were changed
+    //     (through the toolkit API) after it was made
+    if ( Fclimate.mode == USE_FILE )
+    {
+        if ( fileTableIsCurrent() ) initFileValues();
+        else
+        {
+            climate_closeFile();
+            climate_openFile();
+        }
+    }
+
     // --- initialize variables for time series evaporation
     if ( Evap.type == TIMESERIES_EVAP && Evap.tSeries >= 0  )
     {
@@ -693,44 +927,31 @@ void updateFileValues(DateTime theDate)
 //
 //  Input:   theDate = current simulation date
 //  Output:  none
-//  Purpose: updates daily climate variables for new day or reads in
-//           another month worth of values if a new month begins.
+//  Purpose: updates daily climate variables for new day from the
+//           climate table.
 //
-//  NOTE:    counters FileElapsedDays, FileDay, FileMonth, FileYear and
-//           FileLastDay were initialized in climate_openFile().
+//  NOTE:    FileElapsedDays was initialized in initFileValues().
 //
 {
     int i;
     int deltaDays;
+    double* values;
 
     // --- see if a new day has begun
     deltaDays = (int)(floor(theDate) - floor(StartDateTime));
     if ( deltaDays > FileElapsedDays )
     {
-        // --- advance day counters
+        // --- advance day counter
         FileElapsedDays++;
-        FileDay++;
-
-        // --- see if new month of data needs to be read from file
-        if ( FileDay > FileLastDay )
-        {
-            FileMonth++;
-            if ( FileMonth > 12 )
-            {
-                FileMonth = 1;
-                FileYear++;
-            }
-            readFileValues();
-            FileDay = 1;
-            FileLastDay = datetime_daysPerMonth(FileYear, FileMonth);
-        }
+        if ( FileTable == NULL || FileElapsedDays >= FileTableDays ) return;
 
         // --- set climate variables for new day
+        values = &FileTable[FileElapsedDays*MAXCLIMATEVARS];
         for (i=TMIN; i<=WIND; i++)
         {
             // --- no change in current value if its missing
-            if ( FileData[i][FileDay] == MISSING ) continue;
-            FileValue[i] = FileData[i][FileDay];
+            if ( values[i] == MISSING ) continue;
+            FileValue[i] = values[i];
         }
     }
 }
@@ -86,7 +86,8 @@
       HOTSTART_FILE,                   // hotstart file
       RDII_FILE,                       // RDII file
       INFLOWS_FILE,                    // inflows interface file
-      OUTFLOWS_FILE};                  // outflows interface file
+      OUTFLOWS_FILE,                   // outflows interface file
+      CLIMATE_FILE};                   // climate table file
 
 //-------------------------------------
 // File usage types
@@ -97,12 +98,20 @@
       USE_FILE,                        // use previously saved file
       SAVE_FILE};                      // save file currently in use
 
+//-------------------------------------
+// Interface file formats
+//-------------------------------------
+ enum FileFormatType {
+      TEXT_FILE,                       // formatted text file
+      BINARY_FILE};                    // binary file
+
 //-------------------------------------
 // Rain gage data types
 //-------------------------------------
  enum GageDataType {
       RAIN_TSERIES,                    // rainfall from user-supplied time series
       RAIN_FILE,                       // rainfall from external file
+      RAIN_GRID,                       // rainfall from binary rain grid file
       RAIN_API}; 		       // rainfall from API(Modify rainfall mid simulation)
 
 //-------------------------------------
@@ -446,7 +455,8 @@ enum  CompatibilityType {
       s_COORDINATE,   s_VERTICES,     s_POLYGON,      s_LABEL,
       s_SYMBOL,       s_BACKDROP,     s_TAG,          s_PROFILE,
       s_MAP,          s_LID_CONTROL,  s_LID_USAGE,    s_GWF,                   //(5.1.007)
-      s_ADJUST,       s_EVENT};                                                //(5.1.011)
+      s_ADJUST,       s_EVENT,                                                 //(5.1.011)
+      s_RAINCELLS,    s_OUTPUT_PROFILES,  s_OUTPUT_TOLERANCES};
 
  enum InputOptionType {
       FLOW_UNITS,        INFIL_MODEL,       ROUTE_MODEL, 
@@ -462,7 +472,9 @@ enum  CompatibilityType {
       IGNORE_SNOWMELT,   IGNORE_GWATER,     IGNORE_ROUTING,
       IGNORE_QUALITY,    MAX_TRIALS,        HEAD_TOL,
       SYS_FLOW_TOL,      LAT_FLOW_TOL,      IGNORE_RDII,                       //(5.1.004)
-      MIN_ROUTE_STEP,    NUM_THREADS};                                         //(5.1.008)
+      MIN_ROUTE_STEP,    NUM_THREADS,                                          //(5.1.008)
+      TSERIES_CACHE,     TRANSPOSED_OUTPUT, COMPRESSED_OUTPUT,
+      OUTPUT_SUMMARY,    RESULTS_STREAM,    STREAM_PERIODS};
 
 enum  NoYesType {
       NO,
@@ -487,3 +499,15 @@ enum  OpeningParams {
       ORIFICE_COEFF,
       FREE_WEIR_COEFF,
       SUBMERGED_WEIR_COEFF};
+
+//-------------------------------------
+// Points in a time step at which user step callbacks are invoked
+// (must match SM_StepPoint in swmm5.h)
+//-------------------------------------
+enum  StepPointType {
+      BEFORE_CONTROLS,
+      AFTER_ROUTING,
+      AFTER_QUALITY,
+      AT_REPORT_TIME};
+
+#define NUM_STEP_POINTS 4
@@ -179,6 +179,19 @@
 #define ERR508 "\n API Key Error: Invalid Timeseries Index"
 #define ERR509 "\n API Key Error: Invalid Pattern Index"
 
+#define ERR160 "\n  ERROR 160: invalid rain grid cells for Subcatchment %s."
+#define ERR322 "\n  ERROR 322: cannot open or read rain grid file %s."
+
+#define ERR162 \
+"\n  ERROR 162: output profile interval %s is not a multiple of the reporting" \
+"\n             time step."
+
+#define ERR365 "\n  ERROR 365: cannot open results stream %s."
+
+#define ERR510 "\n API Key Error: Unsupported State View Version"
+
+#define ERR511 "\n API Key Error: Function Not Allowed Within a Step Callback"
+
 ////////////////////////////////////////////////////////////////////////////
 //  NOTE: Need to update ErrorMsgs[], ErrorCodes[], and ErrorType
 //        (in error.h) whenever a new error message is added.
@@ -197,7 +210,8 @@ char* ErrorMsgs[] =
       ERR327, ERR329, ERR330, ERR331, ERR333, ERR335, ERR336, ERR337, ERR338,
       ERR339, ERR341, ERR343, ERR345, ERR351, ERR353, ERR355, ERR357, ERR361,
       ERR363, ERR401, ERR402, ERR403, ERR405, ERR501, ERR502, ERR503, ERR504,
-	  ERR505, ERR506, ERR507, ERR508, ERR509};
+	  ERR505, ERR506, ERR507, ERR508, ERR509, ERR160, ERR322, ERR162,
+      ERR365, ERR510, ERR511};
 
 int ErrorCodes[] =
     { 0,      101,    103,    105,    107,    108,    109,    110,    111,
@@ -212,7 +226,8 @@ int ErrorCodes[] =
       327,    329,    330,    331,    333,    335,    336,    337,    338,
       339,    341,    343,    345,    351,    353,    355,    357,    361,
       363,    401,    402,    403,    405,    501,    502,    503,    504,
-	  505,    506,    507,    508,    509};
+	  505,    506,    507,    508,    509,    160,    322,    162,
+      365,    510,    511};
 
 char  ErrString[256];
 
@@ -170,6 +170,22 @@ enum  ErrorType {
 	  ERR_API_INFLOWTYPE,       //507  110
 	  ERR_API_TSERIES_INDEX,    //508  111
 	  ERR_API_PATTERN_INDEX,    //509  112
+
+  //... Rain Grid Errors
+      ERR_RAIN_GRID_CELLS,      //160  113
+      ERR_RAIN_GRID_FILE,       //322  114
+
+  //... Output Profile Errors
+      ERR_OUTPUT_INTERVAL,      //162  115
+
+  //... Results Stream Errors
+      ERR_STREAM_OPEN,          //365  116
+
+  //... State View Errors
+      ERR_API_VIEW_VERSION,     //510  117
+
+  //... Step Callback Errors
+      ERR_API_IN_CALLBACK,      //511  118
       MAXERRMSG};
       
 char* error_getMsg(int i);
@@ -129,6 +129,7 @@ int      climate_readEvapParams(char* tok[], int ntoks);
 int      climate_readAdjustments(char* tok[], int ntoks);                      //(5.1.007)
 void     climate_validate(void);
 void     climate_openFile(void);
+void     climate_closeFile(void);
 void     climate_initState(void);
 void     climate_setState(DateTime aDate);
 DateTime climate_getNextEvapDate(void);                                        //(5.1.008)
@@ -139,6 +140,16 @@ DateTime climate_getNextEvapDate(void);                                        /
 void    rain_open(void);
 void    rain_close(void);
 
+//-----------------------------------------------------------------------------
+//   Rain Grid Methods
+//-----------------------------------------------------------------------------
+int     raingrid_open(int gage);
+void    raingrid_close(int gage);
+void    raingrid_rewind(TRainGrid* grid);
+int     raingrid_readFrame(TRainGrid* grid, DateTime* aDate, double* rain);
+void    raingrid_swapFrames(TRainGrid* grid);
+double  raingrid_getRainfall(TRainGrid* grid, TRainCells* cells, int frame);
+
 //-----------------------------------------------------------------------------
 //   Snowmelt Processing Methods
 //-----------------------------------------------------------------------------
@@ -182,9 +193,21 @@ void    output_close(void);
 void    output_checkFileSize(void);
 void    output_saveResults(double reportTime);
 void    output_readDateTime(int period, DateTime *aDate);
-void    output_readSubcatchResults(int period, int area);
-void    output_readNodeResults(int period, int node);
-void    output_readLinkResults(int period, int link);
+int     output_readSubcatchResults(int period, int area);
+int     output_readNodeResults(int period, int node);
+int     output_readLinkResults(int period, int link);
+int     output_readProfile(char* tok[], int ntoks);
+void    output_deleteProfiles(void);
+int     output_readTolerance(char* tok[], int ntoks);
+void    output_deleteTolerances(void);
+
+//-----------------------------------------------------------------------------
+//   Live Results Stream Methods
+//-----------------------------------------------------------------------------
+int     stream_open(int count[], int results[], int periodBytes);
+void    stream_publish(char* period);
+void    stream_end(int status);
+void    stream_close(void);
 
 //-----------------------------------------------------------------------------
 //   Groundwater Methods
@@ -319,6 +342,9 @@ void     gage_validate(int gage);
 void     gage_initState(int gage);
 void     gage_setState(int gage, DateTime aDate);
 double   gage_getPrecip(int gage, double *rainfall, double *snowfall);
+double   gage_getCellPrecip(int gage, TRainCells* cells, double *rainfall,
+         double *snowfall);
+double   gage_getCellReportRainfall(int gage, TRainCells* cells);
 void     gage_setReportRainfall(int gage, DateTime aDate);
 DateTime gage_getNextRainDate(int gage, DateTime aDate);
 
@@ -329,6 +355,7 @@ int     subcatch_readParams(int subcatch, char* tok[], int ntoks);
 int     subcatch_readSubareaParams(char* tok[], int ntoks);
 int     subcatch_readLanduseParams(char* tok[], int ntoks);
 int     subcatch_readInitBuildup(char* tok[], int ntoks);
+int     subcatch_readRainCells(char* tok[], int ntoks);
 
 void    subcatch_validate(int subcatch);
 void    subcatch_initState(int subcatch);
@@ -414,6 +441,8 @@ void    inflow_initDwfPattern(int pattern);
 double  inflow_getExtInflow(TExtInflow* inflow, DateTime aDate);
 double  inflow_getDwfInflow(TDwfInflow* inflow, int m, int d, int h);
 double  inflow_getPatternFactor(int p, int month, int day, int hour);
+void    inflow_initPatternValues(void);
+void    inflow_setPatternValues(DateTime aDate);
 
 void    inflow_deleteExtInflows(int node);
 void    inflow_deleteDwfInflows(int node);
@@ -530,6 +559,7 @@ int     table_addEntry(TTable* table, double x, double y);
 int     table_getFirstEntry(TTable* table, double* x, double* y);
 int     table_getNextEntry(TTable* table, double* x, double* y);
 void    table_deleteEntries(TTable* table);
+void    table_deleteSharedData(void);
 
 void    table_init(TTable* table);
 int     table_validate(TTable* table);
@@ -544,6 +574,9 @@ double  table_getSlope(TTable *table, double x);
 double  table_getMaxY(TTable *table, double x);
 double  table_getArea(TTable* table, double x);
 double  table_getInverseArea(TTable* table, double a);
+void    table_getAreas(TTable* table, double* areas);
+double  table_lookupArea(TTable* table, double* areas, double x);
+double  table_lookupInverseArea(TTable* table, double* areas, double a);
 
 void    table_tseriesInit(TTable *table);
 double  table_tseriesLookup(TTable* table, double t, char extend);
@@ -556,6 +589,8 @@ int      getInt(char *s, int *y);             // get integer from string
 int      getFloat(char *s, float *y);         // get float from string
 int      getDouble(char *s, double *y);       // get double from string
 char*    getTempFileName(char *s);            // get temporary file name
+int      getFileStamp(char *s, double *size,
+         double *mtime);                      // get file size & mod. time
 int      findmatch(char *s, char *keyword[]); // search for matching keyword
 int      match(char *str, char *substr);      // true if substr matches part of str
 int      strcomp(char *s1, char *s2);         // case insensitive string compare
@@ -563,6 +598,8 @@ char*    sstrncpy(char *dest, const char *src,
          size_t maxlen);                      // safe string copy
 void     writecon(char *s);                   // writes string to console
 DateTime getDateTime(double elapsedMsec);     // convert elapsed time to date
+void     callStepCallback(int point,          // invoke user's step callback
+         double elapsedMsec);
 void     getElapsedTime(DateTime aDate,       // convert elapsed date
          int* days, int* hrs, int* mins);
 void     getSemVersion(char* semver);         // get semantic version
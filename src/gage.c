@@ -12,6 +12,11 @@
 //   Build 5.1.007:
 //   - Support for monthly rainfall adjustments added.
 //
+//   A gage can also get its data from a binary rain grid file (see
+//   raingrid.c) in which case its rainfall is the average over all grid
+//   cells and each subcatchment that uses it receives the rainfall of the
+//   grid cells assigned to it.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -23,6 +28,7 @@
 //  Constants
 //-----------------------------------------------------------------------------
 const double OneSecond = 1.1574074e-5;
+static const int RainRecdSize = sizeof(DateTime) + sizeof(float);  // bytes
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
@@ -32,6 +38,8 @@ const double OneSecond = 1.1574074e-5;
 //  gage_initState         (called by project_init)
 //  gage_setState          (called by runoff_execute & getRainfall in rdii.c)
 //  gage_getPrecip         (called by subcatch_getRunoff)
+//  gage_getCellPrecip     (called by getNetPrecip & snow_addSnowFall)
+//  gage_getCellReportRainfall (called by subcatch_getResults)
 //  gage_getNextRainDate   (called by runoff_getTimeStep)
 
 //-----------------------------------------------------------------------------
@@ -39,8 +47,10 @@ const double OneSecond = 1.1574074e-5;
 //-----------------------------------------------------------------------------
 static int    readGageSeriesFormat(char* tok[], int ntoks, double x[]);
 static int    readGageFileFormat(char* tok[], int ntoks, double x[]);
+static int    readGageGridFormat(char* tok[], int ntoks, double x[]);
 static int    getFirstRainfall(int gage);
 static int    getNextRainfall(int gage);
+static int    skipToStartRainfall(int gage);
 static double convertRainfall(int gage, double rain);
 
 
@@ -57,6 +67,7 @@ int gage_readParams(int j, char* tok[], int ntoks)
 //  Data formats are:
 //    Name RainType RecdFreq SCF TIMESERIES SeriesName
 //    Name RainType RecdFreq SCF FILE FileName Station Units StartDate
+//    Name RainType RecdFreq SCF GRID FileName Units
 //
 {
     int      k, err;
@@ -94,6 +105,12 @@ int gage_readParams(int j, char* tok[], int ntoks)
         sstrncpy(staID, tok[6], MAXMSG);
         err = readGageFileFormat(tok, ntoks, x);
     }
+    else if ( k == RAIN_GRID )
+    {
+        if ( ntoks < 7 ) return error_setInpError(ERR_ITEMS, "");
+        sstrncpy(fname, tok[5], MAXFNAME);
+        err = readGageGridFormat(tok, ntoks, x);
+    }
     else return error_setInpError(ERR_KEYWORD, tok[4]);
 
     // --- save parameters to rain gage object
@@ -104,8 +121,7 @@ int gage_readParams(int j, char* tok[], int ntoks)
     Gage[j].rainInterval = (int)x[2];
     Gage[j].snowFactor   = x[3];
     Gage[j].rainUnits    = (int)x[6];
-    if ( Gage[j].tSeries >= 0 ) Gage[j].dataSource = RAIN_TSERIES;
-    else                        Gage[j].dataSource = RAIN_FILE;
+    Gage[j].dataSource   = k;
     if ( Gage[j].dataSource == RAIN_FILE )
     {
         sstrncpy(Gage[j].fname, fname, MAXFNAME);
@@ -113,6 +129,10 @@ int gage_readParams(int j, char* tok[], int ntoks)
         Gage[j].startFileDate = x[4];
         Gage[j].endFileDate = x[5];
     }
+    if ( Gage[j].dataSource == RAIN_GRID )
+    {
+        sstrncpy(Gage[j].fname, fname, MAXFNAME);
+    }
     Gage[j].unitsFactor = 1.0;
     Gage[j].coGage = -1;
     Gage[j].isUsed = FALSE;
@@ -197,6 +217,51 @@ int readGageFileFormat(char* tok[], int ntoks, double x[])
 
 //=============================================================================
 
+int readGageGridFormat(char* tok[], int ntoks, double x[])
+//
+//  Input:   tok[] = array of string tokens
+//           ntoks = number of tokens
+//  Output:  x[] = array of rain gage parameters;
+//           returns an error code
+//  Purpose: reads the parameters of a rain gage whose data come from a
+//           rain grid file.
+//
+//  Data format is:
+//    Name RainType RecdFreq SCF GRID FileName Units
+//
+{
+    int   m, u;
+    DateTime aTime;
+
+    // --- determine type of rain data
+    //     (cumulative values can't be stored as a sparse grid)
+    m = findmatch(tok[1], RainTypeWords);
+    if ( m < 0 || m == CUMULATIVE_RAINFALL )
+        return error_setInpError(ERR_KEYWORD, tok[1]);
+    x[1] = (double)m;
+
+    // --- get data time interval & convert to seconds
+    if ( getDouble(tok[2], &x[2]) ) x[2] = floor(x[2]*3600 + 0.5);
+    else if ( datetime_strToTime(tok[2], &aTime) )
+    {
+        x[2] = floor(aTime*SECperDAY + 0.5);
+    }
+    else return error_setInpError(ERR_DATETIME, tok[2]);
+    if ( x[2] <= 0.0 ) return error_setInpError(ERR_DATETIME, tok[2]);
+
+    // --- get snow catch deficiency factor
+    if ( !getDouble(tok[3], &x[3]) )
+        return error_setInpError(ERR_NUMBER, tok[3]);
+
+    // --- get rain depth units
+    u = findmatch(tok[6], RainUnitsWords);
+    if ( u < 0 ) return error_setInpError(ERR_KEYWORD, tok[6]);
+    x[6] = (double)u;
+    return 0;
+}
+
+//=============================================================================
+
 void  gage_validate(int j)
 //
 //  Input:   j = rain gage index
@@ -250,6 +315,16 @@ void  gage_validate(int j)
             }
         }
     }
+
+    // --- for gage with rain grid data:
+    if ( Gage[j].dataSource == RAIN_GRID )
+    {
+        if ( Gage[j].rainInterval < WetStep )
+        {
+            report_writeWarningMsg(WARN01, Gage[j].ID);
+            WetStep = Gage[j].rainInterval;
+        }
+    }
 }
 
 //=============================================================================
@@ -281,6 +356,21 @@ void  gage_initState(int j)
         if ( UnitSystem == SI ) Gage[j].unitsFactor = MMperINCH;
     }
 
+    // --- for gage with rain grid data:
+    if ( Gage[j].dataSource == RAIN_GRID && Gage[j].grid )
+    {
+        // --- position grid at its first frame
+        raingrid_rewind(Gage[j].grid);
+
+        // --- assign units conversion factor
+        //     (rain depths on grid file are in gage's rain units)
+        if ( Gage[j].rainUnits != UnitSystem )
+        {
+            if ( UnitSystem == SI ) Gage[j].unitsFactor = MMperINCH;
+            else                    Gage[j].unitsFactor = 1.0 / MMperINCH;
+        }
+    }
+
     // --- get first & next rainfall values
     if ( getFirstRainfall(j) )
     {
@@ -299,9 +389,13 @@ void  gage_initState(int j)
             Gage[j].startDate = StartDateTime;
             Gage[j].endDate = Gage[j].nextDate;
             Gage[j].rainfall = 0.0;
+            if ( Gage[j].dataSource == RAIN_GRID )
+                raingrid_swapFrames(Gage[j].grid);
         }
 
-        // --- otherwise find next recorded rainfall
+        // --- otherwise find next recorded rainfall, skipping directly
+        //     over any rain file records that end before the simulation
+        else if ( skipToStartRainfall(j) ) return;
         else if ( !getNextRainfall(j) ) Gage[j].nextDate = NO_DATE;
     }
     else Gage[j].startDate = NO_DATE;
@@ -378,6 +472,7 @@ void gage_setState(int j, DateTime t)
 	Gage[j].endDate = datetime_addSeconds(Gage[j].startDate,
 			  Gage[j].rainInterval);
 	Gage[j].rainfall = Gage[j].nextRainfall;
+	if ( Gage[j].dataSource == RAIN_GRID ) raingrid_swapFrames(Gage[j].grid);
 
 	if ( !getNextRainfall(j) ) Gage[j].nextDate = NO_DATE;
     }
@@ -423,6 +518,63 @@ double gage_getPrecip(int j, double *rainfall, double *snowfall)
 
 //=============================================================================
 
+double gage_getCellPrecip(int j, TRainCells* cells, double *rainfall,
+                          double *snowfall)
+//
+//  Input:   j = rain gage index
+//           cells = ptr. to rain grid cells covering a subcatchment
+//  Output:  rainfall = rainfall rate (ft/sec)
+//           snowfall = snow fall rate (ft/sec)
+//           returns total precipitation (ft/sec)
+//  Purpose: determines the rain or snow falling on a subcatchment from the
+//           grid cells that cover it.
+//
+{
+    double r = 0.0;
+
+    // --- use gage's rainfall if it has no rain grid or no cells are given
+    if ( Gage[j].dataSource != RAIN_GRID || Gage[j].grid == NULL ||
+         cells->count == 0 ) return gage_getPrecip(j, rainfall, snowfall);
+
+    // --- only look at the cells while the gage's grid has rainfall
+    if ( Gage[j].rainfall > 0.0 )
+    {
+        r = Gage[j].grid->factor *
+            raingrid_getRainfall(Gage[j].grid, cells, 0);
+    }
+    *rainfall = 0.0;
+    *snowfall = 0.0;
+    if ( !IgnoreSnowmelt && Temp.ta <= Snow.snotmp )
+    {
+       *snowfall = r * Gage[j].snowFactor / UCF(RAINFALL);
+    }
+    else *rainfall = r / UCF(RAINFALL);
+    return (*rainfall) + (*snowfall);
+}
+
+//=============================================================================
+
+double gage_getCellReportRainfall(int j, TRainCells* cells)
+//
+//  Input:   j = rain gage index
+//           cells = ptr. to rain grid cells covering a subcatchment
+//  Output:  returns rainfall at current reporting time (in/hr or mm/hr)
+//  Purpose: finds the rainfall reported for a subcatchment from the grid
+//           cells that cover it.
+//
+{
+    TRainGrid* grid = Gage[j].grid;
+
+    if ( Gage[j].dataSource != RAIN_GRID || grid == NULL ||
+         cells->count == 0 ) return Gage[j].reportRainfall;
+    if ( grid->reportFrame < 0 ) return 0.0;
+    if ( grid->reportFrame == 0 )
+        return grid->factor * raingrid_getRainfall(grid, cells, 0);
+    return grid->nextFactor * raingrid_getRainfall(grid, cells, 1);
+}
+
+//=============================================================================
+
 void gage_setReportRainfall(int j, DateTime reportDate)
 //
 //  Input:   j = rain gage index
@@ -432,6 +584,7 @@ void gage_setReportRainfall(int j, DateTime reportDate)
 //
 {
     double result;
+    int    frame;
 
     // --- use value from co-gage if it exists
     if ( Gage[j].coGage >= 0)
@@ -446,15 +599,30 @@ void gage_setReportRainfall(int j, DateTime reportDate)
 
     // --- use current rainfall if report date/time is before end
     //     of current rain interval
-    if ( reportDate < Gage[j].endDate ) result = Gage[j].rainfall;
+    if ( reportDate < Gage[j].endDate )
+    {
+        result = Gage[j].rainfall;
+        frame = 0;
+    }
 
     // --- use 0.0 if report date/time is before start of next rain interval
-    else if ( reportDate < Gage[j].nextDate ) result = 0.0;
+    else if ( reportDate < Gage[j].nextDate )
+    {
+        result = 0.0;
+        frame = -1;
+    }
 
     // --- otherwise report date/time falls right on end of current rain
     //     interval and start of next interval so use next interval's rainfall
-    else result = Gage[j].nextRainfall;
+    else
+    {
+        result = Gage[j].nextRainfall;
+        frame = 1;
+    }
     Gage[j].reportRainfall = result;
+
+    // --- note which rain grid frame supplies the reported rainfall
+    if ( Gage[j].grid ) Gage[j].grid->reportFrame = (result > 0.0) ? frame : -1;
 }
 
 //=============================================================================
@@ -495,6 +663,21 @@ int getFirstRainfall(int j)
         return 0;
     }
 
+    // --- use rain grid file if applicable
+    if ( Gage[j].dataSource == RAIN_GRID )
+    {
+        if ( Gage[j].grid &&
+             raingrid_readFrame(Gage[j].grid, &Gage[j].startDate, &rFirst) )
+        {
+            // --- make frame the grid's current one & find its intensity
+            Gage[j].grid->nextFactor = convertRainfall(j, 1.0);
+            raingrid_swapFrames(Gage[j].grid);
+            Gage[j].rainfall = Gage[j].grid->factor * rFirst;
+            return 1;
+        }
+        return 0;
+    }
+
     // --- otherwise access user-supplied rainfall time series
     else
     {
@@ -566,6 +749,14 @@ int getNextRainfall(int j)
 		    else return 0;
 		}
 
+		else if (Gage[j].dataSource == RAIN_GRID)
+		{
+		    if ( Gage[j].grid == NULL ||
+			 !raingrid_readFrame(Gage[j].grid, &Gage[j].nextDate,
+			 &rNext) ) return 0;
+		    Gage[j].grid->nextFactor = convertRainfall(j, 1.0);
+		    rNext *= Gage[j].grid->nextFactor;
+		}
 
 	    } while (rNext == 0.0);
     }
@@ -575,6 +766,70 @@ int getNextRainfall(int j)
 
 //=============================================================================
 
+int skipToStartRainfall(int j)
+//
+//  Input:   j = rain gage index
+//  Output:  returns TRUE if the gage's rainfall record was advanced
+//  Purpose: positions a gage's rain file record at its last non-zero
+//           rainfall that ends before the simulation starts.
+//
+//  Note: rain file records have a fixed size so the record can be found
+//        by a binary search instead of reading every earlier record. The
+//        gage is left in the same state that gage_setState would reach by
+//        marching through those records at the start of the simulation.
+//
+{
+    long     n, lo, hi, mid;
+    long     pos;
+    float    v;
+    double   rainFactor;
+    DateTime aDate;
+
+    if ( Gage[j].dataSource != RAIN_FILE || !Frain.file ) return FALSE;
+    n = (Gage[j].endFilePos - Gage[j].startFilePos) / RainRecdSize;
+
+    // --- find the last record whose interval ends by the start date
+    lo = 0;
+    hi = n - 1;
+    while ( lo < hi )
+    {
+        mid = (lo + hi + 1) / 2;
+        fseek(Frain.file, Gage[j].startFilePos + mid*RainRecdSize, SEEK_SET);
+        fread(&aDate, sizeof(DateTime), 1, Frain.file);
+        if ( datetime_addSeconds(aDate, Gage[j].rainInterval) <= StartDateTime )
+            lo = mid;
+        else hi = mid - 1;
+    }
+
+    // --- back up to a record with non-zero rainfall
+    //     (zero rainfall records are skipped over by getNextRainfall)
+    for ( ; lo >= 2; lo-- )
+    {
+        pos = Gage[j].startFilePos + lo*RainRecdSize;
+        fseek(Frain.file, pos, SEEK_SET);
+        fread(&aDate, sizeof(DateTime), 1, Frain.file);
+        fread(&v, sizeof(float), 1, Frain.file);
+        if ( v != 0.0f ) break;
+    }
+
+    // --- the first two records are read when the gage is initialized
+    if ( lo < 2 ) return FALSE;
+
+    // --- make this the current rainfall, using the rainfall adjustment
+    //     for the start of the simulation that later records would receive
+    rainFactor = Adjust.rainFactor;
+    Adjust.rainFactor = Adjust.rain[datetime_monthOfYear(StartDateTime)-1];
+    Gage[j].startDate = aDate;
+    Gage[j].endDate = datetime_addSeconds(aDate, Gage[j].rainInterval);
+    Gage[j].rainfall = convertRainfall(j, (double)v);
+    Gage[j].currentFilePos = ftell(Frain.file);
+    if ( !getNextRainfall(j) ) Gage[j].nextDate = NO_DATE;
+    Adjust.rainFactor = rainFactor;
+    return TRUE;
+}
+
+//=============================================================================
+
 double convertRainfall(int j, double r)
 //
 //  Input:   j = rain gage index
@@ -38,6 +38,7 @@ EXTERN TFile
                   Fout,                     // Output file
                   Frpt,                     // Report file
                   Fclimate,                 // Climate file
+                  Fclimcache,               // Climate table file
                   Frain,                    // Rainfall file
                   Frunoff,                  // Runoff file
                   Frdii,                    // RDII inflow file
@@ -49,13 +50,15 @@ EXTERN TFile
 EXTERN long
                   Nperiods,                 // Number of reporting periods
                   StepCount,                // Number of routing steps used
+                  RuleActionCount,          // Number of control actions taken
                   NonConvergeCount;         // Number of non-converging steps
 
 EXTERN char
                   Msg[MAXMSG+1],            // Text of output message
                   ErrorMsg[MAXMSG+1],       // Text of error message           //(5.1.011)
                   Title[MAXTITLE][MAXMSG+1],// Project title
-                  TempDir[MAXFNAME+1];      // Temporary file directory
+                  TempDir[MAXFNAME+1],      // Temporary file directory
+                  StreamName[MAXFNAME+1];   // Shared memory for live results
 
 EXTERN TRptFlags
                   RptFlags;                 // Reporting options
@@ -82,6 +85,10 @@ EXTERN int
                   IgnoreGwater,             // Ignore groundwater
                   IgnoreRouting,            // Ignore flow routing
                   IgnoreQuality,            // Ignore water quality
+                  TseriesCache,             // Save time series files in binary
+                  TransposedOutput,         // Add time series layout to output
+                  CompressedOutput,         // Save results in compressed chunks
+                  OutputSummary,            // Add summary of results to output
                   ErrorCode,                // Error code number
                   Warnings,                 // Number of warning messages      //(5.1.011)
                   WetStep,                  // Runoff wet time step (sec)
@@ -91,6 +98,7 @@ EXTERN int
                   SweepEnd,                 // Day of year when sweeping ends
                   MaxTrials,                // Max. trials for DW routing
                   NumThreads,               // Number of parallel threads used //(5.1.008)
+                  StreamPeriods,            // Periods held in results stream
                   NumEvents;                // Number of detailed events       //(5.1.011)
                 //InSteadyState;            // System flows remain constant    //(5.1.012)
 
@@ -7,6 +7,31 @@
 //   Author:   L. Rossman
 //
 //   Routing interface file functions.
+//
+//   An outflows interface file is saved as formatted text unless the
+//   BINARY format is requested in the [FILES] section, e.g.:
+//     SAVE OUTFLOWS "outflows.bin" BINARY
+//   An inflows interface file can have either format, which is recognized
+//   from the start of the file. The layout of a binary interface file is:
+//     File stamp ("SWMM5-IFACE") (11 bytes)
+//     Reporting time step (sec) (4-byte int)
+//     Flow units code (4-byte int)
+//     Number of pollutants (4-byte int)
+//     Number of nodes (4-byte int)
+//     For each pollutant:
+//       number of characters in name (4-byte int)
+//       name (chars)
+//       concentration units code (4-byte int)
+//     For each node:
+//       number of characters in name (4-byte int)
+//       name (chars)
+//     For each reporting period (all of the same size):
+//       date/time (8-byte double)
+//       for each node, its flow and then the concentration of each
+//       pollutant (4-byte floats)
+//   Since all periods take up the same number of bytes, a run that starts
+//   after the first period of a binary file seeks directly to the periods
+//   it needs.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -14,6 +39,13 @@
 #include <string.h>
 #include "headers.h"
 
+//-----------------------------------------------------------------------------
+//  Constants
+//-----------------------------------------------------------------------------
+#define INT4  int
+#define REAL4 float
+#define IFACE_FILE_STAMP "SWMM5-IFACE"
+
 //-----------------------------------------------------------------------------
 //  Imported variables
 //-----------------------------------------------------------------------------
@@ -39,6 +71,9 @@ static double** NewIfaceValues;        // interface flows & WQ at next time
 static double   IfaceFrac;             // fraction of interface file time step
 static DateTime OldIfaceDate;          // previous date of interface values
 static DateTime NewIfaceDate;          // next date of interface values
+static int      OutflowsFormat;        // TEXT_FILE or BINARY_FILE
+static int      InflowsFormat;         // TEXT_FILE or BINARY_FILE
+static REAL4*   IfaceBuffer;           // values of a binary file's period
 
 //-----------------------------------------------------------------------------
 //  External Functions (declared in funcs.h)
@@ -63,6 +98,15 @@ static void  setOldIfaceValues(void);
 static void  readNewIfaceValues(void);
 static int   isOutletNode(int node);
 
+static void  writeBinaryFileHeader(void);
+static void  saveBinaryOutletResults(DateTime reportDate, FILE* file);
+static void  writeIfaceName(char* name, FILE* file);
+static int   readTextFileHeader(void);
+static int   readBinaryFileHeader(void);
+static int   readIfaceName(char* name);
+static void  seekBinaryFileStart(long dataPos, long periodSize);
+static void  readNewBinaryIfaceValues(void);
+
 
 //=============================================================================
 
@@ -74,7 +118,7 @@ int iface_readFileParams(char* tok[], int ntoks)
 //  Purpose: reads interface file information from a line of input data.
 //
 //  Data format is:
-//  USE/SAVE  FileType  FileName
+//  USE/SAVE  FileType  FileName  (TEXT/BINARY)
 //
 {
     char  k;
@@ -129,6 +173,20 @@ int iface_readFileParams(char* tok[], int ntoks)
         if ( k != SAVE_FILE ) return error_setInpError(ERR_ITEMS, "");
         Foutflows.mode = k;
         sstrncpy(Foutflows.name, tok[2], MAXFNAME);
+        OutflowsFormat = TEXT_FILE;
+        if ( ntoks > 3 )
+        {
+            OutflowsFormat = findmatch(tok[3], FileFormatWords);
+            if ( OutflowsFormat < 0 )
+                return error_setInpError(ERR_KEYWORD, tok[3]);
+        }
+        break;
+
+      case CLIMATE_FILE:
+        if ( k != USE_FILE && k != SAVE_FILE )
+            return error_setInpError(ERR_ITEMS, "");
+        Fclimcache.mode = k;
+        sstrncpy(Fclimcache.name, tok[2], MAXFNAME);
         break;
     }
     return 0;
@@ -150,6 +208,8 @@ void iface_openRoutingFiles()
     IfaceNodes = NULL;
     OldIfaceValues = NULL;
     NewIfaceValues = NULL;
+    IfaceBuffer = NULL;
+    InflowsFormat = TEXT_FILE;
 
     // --- check that inflows & outflows files are not the same
     if ( Foutflows.mode != NO_FILE && Finflows.mode != NO_FILE )
@@ -177,6 +237,7 @@ void iface_closeRoutingFiles()
 {
     FREE(IfacePolluts);
     FREE(IfaceNodes);
+    FREE(IfaceBuffer);
     if ( OldIfaceValues != NULL ) project_freeMatrix(OldIfaceValues);
     if ( NewIfaceValues != NULL ) project_freeMatrix(NewIfaceValues);
     if ( Finflows.file )  fclose(Finflows.file);
@@ -289,6 +350,12 @@ void iface_saveOutletResults(DateTime reportDate, FILE* file)
 {
     int i, p, yr, mon, day, hr, min, sec;
     char theDate[25];
+
+    if ( OutflowsFormat == BINARY_FILE )
+    {
+        saveBinaryOutletResults(reportDate, file);
+        return;
+    }
     datetime_decodeDate(reportDate, &yr, &mon, &day);
     datetime_decodeTime(reportDate, &hr, &min, &sec);
     sprintf(theDate, " %04d %02d  %02d  %02d  %02d  %02d ",
@@ -320,6 +387,23 @@ void openFileForOutput()
 {
     int i, n;
 
+    // --- open the routing file for writing binary values
+    if ( OutflowsFormat == BINARY_FILE )
+    {
+        Foutflows.file = fopen(Foutflows.name, "wb");
+        if ( Foutflows.file == NULL )
+        {
+            report_writeErrorMsg(ERR_ROUTING_FILE_OPEN, Foutflows.name);
+            return;
+        }
+        writeBinaryFileHeader();
+        if ( ReportStart == StartDateTime )
+        {
+            iface_saveOutletResults(ReportStart, Foutflows.file);
+        }
+        return;
+    }
+
     // --- open the routing file for writing text
     Foutflows.file = fopen(Foutflows.name, "wt");
     if ( Foutflows.file == NULL )
@@ -383,49 +467,34 @@ void openFileForInput()
 //
 {
     int   err;                         // error code
-    char  line[MAXLINE+1];             // line from Routing interface file
-    char  s[MAXLINE+1];                // general string variable
+    char  fStamp[] = IFACE_FILE_STAMP; // binary file stamp
 
-    // --- open the routing interface file for reading text
-    Finflows.file = fopen(Finflows.name, "rt");
+    // --- open the routing interface file & check if it is a binary file
+    Finflows.file = fopen(Finflows.name, "rb");
     if ( Finflows.file == NULL )
     {
         report_writeErrorMsg(ERR_ROUTING_FILE_OPEN, Finflows.name);
         return;
     }
-
-    // --- check for correct file type
-    fgets(line, MAXLINE, Finflows.file);
-    sscanf(line, "%s", s);
-    if ( !strcomp(s, "SWMM5") )
+    if ( fread(fStamp, sizeof(char), strlen(fStamp), Finflows.file) ==
+         strlen(fStamp) && strcmp(fStamp, IFACE_FILE_STAMP) == 0 )
     {
-        report_writeErrorMsg(ERR_ROUTING_FILE_FORMAT, Finflows.name);
-        return;
+        InflowsFormat = BINARY_FILE;
+        err = readBinaryFileHeader();
     }
 
-    // --- skip title line
-    fgets(line, MAXLINE, Finflows.file);
-
-    // --- read reporting time step (sec)
-    IfaceStep = 0;
-    fgets(line, MAXLINE, Finflows.file);
-    sscanf(line, "%d", &IfaceStep);
-    if ( IfaceStep <= 0 )
+    // --- otherwise re-open the file for reading text
+    else
     {
-        report_writeErrorMsg(ERR_ROUTING_FILE_FORMAT, Finflows.name);
-        return;
-    }
-
-    // --- match constituents in file with those in project
-    err = getIfaceFilePolluts();
-    if ( err > 0 )
-    {
-        report_writeErrorMsg(err, Finflows.name);
-        return;
+        fclose(Finflows.file);
+        Finflows.file = fopen(Finflows.name, "rt");
+        if ( Finflows.file == NULL )
+        {
+            report_writeErrorMsg(ERR_ROUTING_FILE_OPEN, Finflows.name);
+            return;
+        }
+        err = readTextFileHeader();
     }
-
-    // --- match nodes in file with those in project
-    err = getIfaceFileNodes();
     if ( err > 0 )
     {
         report_writeErrorMsg(err, Finflows.name);
@@ -450,6 +519,41 @@ void openFileForInput()
 
 //=============================================================================
 
+int readTextFileHeader()
+//
+//  Input:   none
+//  Output:  returns an error code
+//  Purpose: reads the header of a text routing interface file.
+//
+{
+    int   err;                         // error code
+    char  line[MAXLINE+1];             // line from Routing interface file
+    char  s[MAXLINE+1];                // general string variable
+
+    // --- check for correct file type
+    fgets(line, MAXLINE, Finflows.file);
+    sscanf(line, "%s", s);
+    if ( !strcomp(s, "SWMM5") ) return ERR_ROUTING_FILE_FORMAT;
+
+    // --- skip title line
+    fgets(line, MAXLINE, Finflows.file);
+
+    // --- read reporting time step (sec)
+    IfaceStep = 0;
+    fgets(line, MAXLINE, Finflows.file);
+    sscanf(line, "%d", &IfaceStep);
+    if ( IfaceStep <= 0 ) return ERR_ROUTING_FILE_FORMAT;
+
+    // --- match constituents in file with those in project
+    err = getIfaceFilePolluts();
+    if ( err > 0 ) return err;
+
+    // --- match nodes in file with those in project
+    return getIfaceFileNodes();
+}
+
+//=============================================================================
+
 int  getIfaceFilePolluts()
 //
 //  Input:   none
@@ -557,6 +661,12 @@ void readNewIfaceValues()
 		   hr = 0, min = 0, sec = 0;   // year, month, day, hour, minute, second
     char   line[MAXLINE+1];            // line from interface file
 
+    if ( InflowsFormat == BINARY_FILE )
+    {
+        readNewBinaryIfaceValues();
+        return;
+    }
+
     // --- read a line for each interface node
     NewIfaceDate = NO_DATE;
     for (i=0; i<NumIfaceNodes; i++)
@@ -643,3 +753,245 @@ int  isOutletNode(int i)
     // --- otherwise outlets are nodes with no outflow links (degree is 0)
     else return (Node[i].degree == 0);
 }
+
+//=============================================================================
+
+void writeBinaryFileHeader()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: writes the header of a binary outflows interface file.
+//
+{
+    int   i;
+    INT4  k;
+    FILE* f = Foutflows.file;
+
+    // --- write file stamp, reporting time step & flow units
+    fwrite(IFACE_FILE_STAMP, sizeof(char), strlen(IFACE_FILE_STAMP), f);
+    k = ReportStep;
+    fwrite(&k, sizeof(INT4), 1, f);
+    k = FlowUnits;
+    fwrite(&k, sizeof(INT4), 1, f);
+
+    // --- write number of pollutants & of outlet nodes
+    k = Nobjects[POLLUT];
+    fwrite(&k, sizeof(INT4), 1, f);
+    k = 0;
+    for (i=0; i<Nobjects[NODE]; i++)
+    {
+        if ( isOutletNode(i) ) k++;
+    }
+    fwrite(&k, sizeof(INT4), 1, f);
+
+    // --- write name & units of each pollutant
+    for (i=0; i<Nobjects[POLLUT]; i++)
+    {
+        writeIfaceName(Pollut[i].ID, f);
+        k = Pollut[i].units;
+        fwrite(&k, sizeof(INT4), 1, f);
+    }
+
+    // --- write name of each outlet node
+    for (i=0; i<Nobjects[NODE]; i++)
+    {
+        if ( isOutletNode(i) ) writeIfaceName(Node[i].ID, f);
+    }
+}
+
+//=============================================================================
+
+void saveBinaryOutletResults(DateTime reportDate, FILE* file)
+//
+//  Input:   reportDate = reporting date/time
+//           file = ptr. to interface file
+//  Output:  none
+//  Purpose: saves system outflows to a binary routing interface file.
+//
+{
+    int   i, p;
+    REAL4 x;
+
+    fwrite(&reportDate, sizeof(DateTime), 1, file);
+    for (i=0; i<Nobjects[NODE]; i++)
+    {
+        if ( !isOutletNode(i) ) continue;
+        x = (REAL4)(Node[i].inflow * UCF(FLOW));
+        fwrite(&x, sizeof(REAL4), 1, file);
+        for ( p = 0; p < Nobjects[POLLUT]; p++ )
+        {
+            x = (REAL4)Node[i].newQual[p];
+            fwrite(&x, sizeof(REAL4), 1, file);
+        }
+    }
+}
+
+//=============================================================================
+
+void writeIfaceName(char* name, FILE* file)
+//
+//  Input:   name = an object's ID name
+//           file = ptr. to interface file
+//  Output:  none
+//  Purpose: writes the length and characters of a name to a binary file.
+//
+{
+    INT4 n = (INT4)strlen(name);
+    fwrite(&n, sizeof(INT4), 1, file);
+    fwrite(name, sizeof(char), n, file);
+}
+
+//=============================================================================
+
+int readBinaryFileHeader()
+//
+//  Input:   none
+//  Output:  returns an error code
+//  Purpose: reads the header of a binary inflows interface file and moves
+//           to the first reporting period needed by the simulation.
+//
+{
+    int   i, j;
+    INT4  n[4];                        // time step, units, polluts & nodes
+    INT4  units;                       // pollutant units code
+    long  dataPos;                     // file position of first period
+    long  periodSize;                  // bytes saved per period
+    char  s[MAXLINE+1];                // object name
+    FILE* f = Finflows.file;
+
+    // --- read reporting time step, flow units & numbers of items
+    if ( fread(n, sizeof(INT4), 4, f) < 4 ) return ERR_ROUTING_FILE_FORMAT;
+    IfaceStep = n[0];
+    IfaceFlowUnits = n[1];
+    NumIfacePolluts = n[2];
+    NumIfaceNodes = n[3];
+    if ( IfaceStep <= 0 || IfaceFlowUnits < 0 || IfaceFlowUnits > MLD
+    ||   NumIfacePolluts < 0 || NumIfaceNodes <= 0 )
+        return ERR_ROUTING_FILE_FORMAT;
+
+    // --- allocate memory for pollutant & node index arrays
+    if ( Nobjects[POLLUT] > 0 )
+    {
+        IfacePolluts = (int *) calloc(Nobjects[POLLUT], sizeof(int));
+        if ( !IfacePolluts ) return ERR_MEMORY;
+        for (i=0; i<Nobjects[POLLUT]; i++) IfacePolluts[i] = -1;
+    }
+    IfaceNodes = (int *) calloc(NumIfaceNodes, sizeof(int));
+    IfaceBuffer = (REAL4 *) calloc(NumIfaceNodes * (1+NumIfacePolluts),
+                                   sizeof(REAL4));
+    if ( !IfaceNodes || !IfaceBuffer ) return ERR_MEMORY;
+
+    // --- check each pollutant on file against project's pollutants
+    for (i=0; i<NumIfacePolluts; i++)
+    {
+        if ( !readIfaceName(s) ||
+             fread(&units, sizeof(INT4), 1, f) < 1 )
+            return ERR_ROUTING_FILE_FORMAT;
+        if ( Nobjects[POLLUT] > 0 )
+        {
+            j = project_findObject(POLLUT, s);
+            if ( j < 0 ) continue;
+            if ( units != Pollut[j].units ) return ERR_ROUTING_FILE_NOMATCH;
+            IfacePolluts[j] = i;
+        }
+    }
+
+    // --- save index of each node on file
+    for (i=0; i<NumIfaceNodes; i++)
+    {
+        if ( !readIfaceName(s) ) return ERR_ROUTING_FILE_FORMAT;
+        IfaceNodes[i] = project_findObject(NODE, s);
+    }
+
+    // --- move to first period needed by the simulation
+    dataPos = ftell(f);
+    periodSize = sizeof(DateTime) +
+                 NumIfaceNodes * (1+NumIfacePolluts) * sizeof(REAL4);
+    seekBinaryFileStart(dataPos, periodSize);
+    return 0;
+}
+
+//=============================================================================
+
+int readIfaceName(char* name)
+//
+//  Input:   none
+//  Output:  name = an object's ID name;
+//           returns 1 if successful, 0 if not
+//  Purpose: reads a name written by writeIfaceName from a binary file.
+//
+{
+    INT4 n;
+    if ( fread(&n, sizeof(INT4), 1, Finflows.file) < 1 ) return 0;
+    if ( n < 0 || n > MAXLINE ) return 0;
+    if ( fread(name, sizeof(char), n, Finflows.file) < (size_t)n ) return 0;
+    name[n] = '\0';
+    return 1;
+}
+
+//=============================================================================
+
+void seekBinaryFileStart(long dataPos, long periodSize)
+//
+//  Input:   dataPos = file position of first reporting period
+//           periodSize = number of bytes saved per reporting period
+//  Output:  none
+//  Purpose: positions a binary inflows file at the last reporting period
+//           before the start of the simulation (or at its first period).
+//
+//  Only the periods from the last one before the start date onward are
+//  ever used to interpolate inflows, so a binary search over the dates of
+//  the file's periods replaces reading all of the earlier ones.
+//
+{
+    long     lo = 0, hi, mid;
+    DateTime aDate;
+
+    // --- find number of complete periods on file
+    fseek(Finflows.file, 0, SEEK_END);
+    hi = (ftell(Finflows.file) - dataPos) / periodSize - 1;
+
+    // --- find last period whose date is before the start date
+    while ( lo < hi )
+    {
+        mid = (lo + hi + 1) / 2;
+        fseek(Finflows.file, dataPos + mid*periodSize, SEEK_SET);
+        if ( fread(&aDate, sizeof(DateTime), 1, Finflows.file) < 1 ) break;
+        if ( aDate < StartDateTime ) lo = mid;
+        else hi = mid - 1;
+    }
+    fseek(Finflows.file, dataPos + lo*periodSize, SEEK_SET);
+}
+
+//=============================================================================
+
+void readNewBinaryIfaceValues()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: reads data from a binary inflows interface file for next date.
+//
+{
+    int    i, j, k;
+    int    n = NumIfaceNodes * (1+NumIfacePolluts);
+
+    // --- read date & values of next reporting period
+    NewIfaceDate = NO_DATE;
+    if ( fread(&NewIfaceDate, sizeof(DateTime), 1, Finflows.file) < 1 ||
+         fread(IfaceBuffer, sizeof(REAL4), n, Finflows.file) < (size_t)n )
+    {
+        NewIfaceDate = NO_DATE;
+        return;
+    }
+
+    // --- save each node's flow & pollutant values
+    k = 0;
+    for (i=0; i<NumIfaceNodes; i++)
+    {
+        NewIfaceValues[i][0] = IfaceBuffer[k++] / Qcf[IfaceFlowUnits];
+        for (j=1; j<=NumIfacePolluts; j++)
+        {
+            NewIfaceValues[i][j] = IfaceBuffer[k++];
+        }
+    }
+}
@@ -8,6 +8,11 @@
 //
 //   Manages any Direct External or Dry Weather Flow inflows
 //   that have been assigned to nodes of the drainage system.
+//
+//   Time pattern factors only change when the month, day of week or hour
+//   of day does, so the pattern adjusted value of each inflow is saved and
+//   only re-computed by inflow_setPatternValues when a new time period
+//   begins.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -15,6 +20,13 @@
 #include <string.h>
 #include "headers.h"
 
+//-----------------------------------------------------------------------------
+//  Shared variables
+//-----------------------------------------------------------------------------
+static int PatternMonth;     // month of year of saved pattern values
+static int PatternDay;       // day of week of saved pattern values
+static int PatternHour;      // hour of day of saved pattern values
+
 //-----------------------------------------------------------------------------
 //  External Functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
@@ -26,6 +38,8 @@
 //  inflow_getExtInflow     (called by addExternalInflows in routing.c)
 //  inflow_getDwfInflow     (called by addDryWeatherInflows in routing.c)
 //  inflow_getPatternFactor
+//  inflow_initPatternValues (called by routing_open)
+//  inflow_setPatternValues  (called by routing_execute)
 
 //=============================================================================
 
@@ -223,6 +237,8 @@ int inflow_setExtInflow(int j, int param, int type, int tseries, int basePat,
 		inflow->baseline = baseline;
 		inflow->basePat  = basePat;
 		inflow->extIfaceInflow = 0.0;
+		inflow->baseValue = baseline;
+		if ( basePat >= 0 ) PatternMonth = -1;
 	}
     return(errcode);
 }
@@ -257,23 +273,17 @@ double inflow_getExtInflow(TExtInflow* inflow, DateTime aDate)
 //  Purpose: retrieves the value of an external inflow at a specific
 //           date and time.
 //
+//  NOTE: the inflow's baseline value is the one adjusted by its time
+//        pattern in inflow_setPatternValues.
+//
 {
-    int    month, day, hour;
-    int    p = inflow->basePat;      // baseline pattern
     int    k = inflow->tSeries;      // time series index
     double cf = inflow->cFactor;     // units conversion factor
     double sf = inflow->sFactor;     // scaling factor
-    double blv = inflow->baseline;   // baseline value
+    double blv = inflow->baseValue;  // baseline value adjusted by pattern
     double tsv = 0.0;                // time series value
 	double extIfaceInflow = inflow->extIfaceInflow;// external interfacing inflow
 
-    if ( p >= 0 )
-    {
-        month = datetime_monthOfYear(aDate) - 1;
-        day   = datetime_dayOfWeek(aDate) - 1;
-        hour  = datetime_hourOfDay(aDate);
-        blv  *= inflow_getPatternFactor(p, month, day, hour);
-    }
     if ( k >= 0 ) tsv = table_tseriesLookup(&Tseries[k], aDate, FALSE) * sf;
     return cf * (tsv + blv) + cf * extIfaceInflow;
 }
@@ -348,6 +358,7 @@ int inflow_readDwfInflow(char* tok[], int ntoks)
     // --- assign property values to the inflow object
     inflow->param = k;
     inflow->avgValue = x;
+    inflow->value = x;
     for (i=0; i<4; i++) inflow->patterns[i] = pats[i];
     return 0;
 }
@@ -529,4 +540,61 @@ double inflow_getPatternFactor(int p, int month, int day, int hour)
     return 1.0;
 }
 
-//=============================================================================
\ No newline at end of file
+//=============================================================================
+
+void inflow_initPatternValues()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: makes the next call to inflow_setPatternValues re-compute the
+//           pattern adjusted values of all inflows.
+//
+{
+    PatternMonth = -1;
+    PatternDay = -1;
+    PatternHour = -1;
+}
+
+//=============================================================================
+
+void inflow_setPatternValues(DateTime aDate)
+//
+//  Input:   aDate = current simulation date/time
+//  Output:  none
+//  Purpose: updates the pattern adjusted values of all external and dry
+//           weather inflows when a new pattern time period begins.
+//
+{
+    int    j, month, day, hour;
+    TExtInflow* extInflow;
+    TDwfInflow* dwfInflow;
+
+    // --- return if still in the same month, day of week & hour of day
+    month = datetime_monthOfYear(aDate) - 1;
+    day   = datetime_dayOfWeek(aDate) - 1;
+    hour  = datetime_hourOfDay(aDate);
+    if ( month == PatternMonth && day == PatternDay && hour == PatternHour )
+        return;
+    PatternMonth = month;
+    PatternDay = day;
+    PatternHour = hour;
+
+    // --- re-compute the pattern adjusted value of each inflow
+    for (j = 0; j < Nobjects[NODE]; j++)
+    {
+        extInflow = Node[j].extInflow;
+        while ( extInflow )
+        {
+            extInflow->baseValue = extInflow->baseline;
+            if ( extInflow->basePat >= 0 ) extInflow->baseValue *=
+                inflow_getPatternFactor(extInflow->basePat, month, day, hour);
+            extInflow = extInflow->next;
+        }
+        dwfInflow = Node[j].dwfInflow;
+        while ( dwfInflow )
+        {
+            dwfInflow->value = inflow_getDwfInflow(dwfInflow, month, day, hour);
+            dwfInflow = dwfInflow->next;
+        }
+    }
+}
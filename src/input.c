@@ -597,6 +597,15 @@ int  parseLine(int sect, char *line)
       case s_EVENT:
         return readEvent(Tok, Ntokens);                                        //(5.1.011)
 
+      case s_RAINCELLS:
+        return subcatch_readRainCells(Tok, Ntokens);
+
+      case s_OUTPUT_PROFILES:
+        return output_readProfile(Tok, Ntokens);
+
+      case s_OUTPUT_TOLERANCES:
+        return output_readTolerance(Tok, Ntokens);
+
       default: return 0;
     }
 }
@@ -111,6 +111,14 @@ void inputrpt_writeInput()
                     RainTypeWords[Gage[i].rainType],
                     (Gage[i].rainInterval)/60);
             }
+            else if ( Gage[i].dataSource == RAIN_GRID )
+            {
+                fprintf(Frpt.file, "\n  %-20s %-30s ",
+                    Gage[i].ID, Gage[i].fname);
+                fprintf(Frpt.file, "%-10s %3d min.",
+                    RainTypeWords[Gage[i].rainType],
+                    (Gage[i].rainInterval)/60);
+            }
             else fprintf(Frpt.file, "\n  %-20s %-30s",
                 Gage[i].ID, Gage[i].fname);
         }
@@ -48,18 +48,23 @@ char* EvapTypeWords[]      = { w_CONSTANT, w_MONTHLY, w_TIMESERIES,
                                w_TEMPERATURE, w_FILE, w_RECOVERY,
                                w_DRYONLY, NULL};
 char* FileTypeWords[]      = { w_RAINFALL, w_RUNOFF, w_HOTSTART, w_RDII,
-                               w_INFLOWS, w_OUTFLOWS, NULL};
+                               w_INFLOWS, w_OUTFLOWS, w_CLIMATE, NULL};
 char* FileModeWords[]      = { w_NO, w_SCRATCH, w_USE, w_SAVE, NULL};
+char* FileFormatWords[]    = { w_TEXT, w_BINARY, NULL};
 char* FlowUnitWords[]      = { w_CFS, w_GPM, w_MGD, w_CMS, w_LPS, w_MLD, NULL};
 char* ForceMainEqnWords[]  = { w_H_W, w_D_W, NULL};
-char* GageDataWords[]      = { w_TIMESERIES, w_FILE, NULL};
+char* GageDataWords[]      = { w_TIMESERIES, w_FILE, w_GRID, NULL};
 char* InfilModelWords[]    = { w_HORTON, w_MOD_HORTON, w_GREEN_AMPT,
                                w_MOD_GREEN_AMPT, w_CURVE_NUMEBR, NULL};        //(5.1.010)
 char* InertDampingWords[]  = { w_NONE, w_PARTIAL, w_FULL, NULL};
 char* LinkOffsetWords[]    = { w_DEPTH, w_ELEVATION, NULL};
+char* LinkResultWords[]    = { w_FLOW, w_DEPTH, w_VELOCITY, w_VOLUME,
+                               w_CAPACITY, NULL};
 char* LinkTypeWords[]      = { w_CONDUIT, w_PUMP, w_ORIFICE,
                                w_WEIR, w_OUTLET };
 char* LoadUnitsWords[]     = { w_LBS, w_KG, w_LOGN };
+char* NodeResultWords[]    = { w_DEPTH, w_HEAD, w_VOLUME, w_LAT_INFLOW,
+                               w_INFLOW, w_FLOODING, NULL};
 char* NodeTypeWords[]      = { w_JUNCTION, w_OUTFALL,
                                w_STORAGE, w_DIVIDER };
 char* NoneAllWords[]       = { w_NONE, w_ALL, NULL};
@@ -88,7 +93,10 @@ char* OptionWords[]        = { w_FLOW_UNITS,        w_INFIL_MODEL,
                                w_MAX_TRIALS,        w_HEAD_TOL,
                                w_SYS_FLOW_TOL,      w_LAT_FLOW_TOL,
                                w_IGNORE_RDII,       w_MIN_ROUTE_STEP,          //(5.1.008)
-                               w_NUM_THREADS,       NULL};                     //(5.1.008)
+                               w_NUM_THREADS,       w_TSERIES_CACHE,           //(5.1.008)
+                               w_TRANSPOSED_OUTPUT, w_COMPRESSED_OUTPUT,
+                               w_OUTPUT_SUMMARY,    w_RESULTS_STREAM,
+                               w_STREAM_PERIODS,    NULL};
 char* OrificeTypeWords[]   = { w_SIDE, w_BOTTOM, NULL};
 char* OutfallTypeWords[]   = { w_FREE, w_NORMAL, w_FIXED, w_TIDAL,
                                w_TIMESERIES, NULL};
@@ -134,8 +142,12 @@ char* SectWords[]          = { ws_TITLE,          ws_OPTION,
                                ws_MAP,            ws_LID_CONTROL,
                                ws_LID_USAGE,      ws_GWF,                      //(5.1.007)
                                ws_ADJUST,         ws_EVENT,                    //(5.1.011)
-                               NULL};                       
+                               ws_RAINCELLS,      ws_OUTPUT_PROFILES,
+                               ws_OUTPUT_TOLERANCES, NULL};                       
 char* SnowmeltWords[]      = { w_PLOWABLE, w_IMPERV, w_PERV, w_REMOVAL, NULL};
+char* SubcatchResultWords[] = { w_RAINFALL, w_SNOW_DEPTH, w_EVAP, w_INFIL,
+                               w_RUNOFF, w_GW_FLOW, w_GW_ELEV, w_SOIL_MOIST,
+                               NULL};
 char* TempKeyWords[]       = { w_TIMESERIES, w_FILE, w_WINDSPEED, w_SNOWMELT,
                                w_ADC, NULL};
 char* TransectKeyWords[]   = { w_NC, w_X1, w_GR, NULL};
@@ -19,6 +19,7 @@ extern char* DividerTypeWords[];
 extern char* DynWaveMethodWords[];
 extern char* EvapTypeWords[];
 extern char* FileModeWords[];
+extern char* FileFormatWords[];
 extern char* FileTypeWords[];
 extern char* FlowUnitWords[];
 extern char* ForceMainEqnWords[];
@@ -26,8 +27,10 @@ extern char* GageDataWords[];
 extern char* InertDampingWords[];
 extern char* InfilModelWords[];
 extern char* LinkOffsetWords[];
+extern char* LinkResultWords[];
 extern char* LinkTypeWords[];
 extern char* LoadUnitsWords[];
+extern char* NodeResultWords[];
 extern char* NodeTypeWords[];
 extern char* NoneAllWords[];
 extern char* NormalFlowWords[];
@@ -51,6 +54,7 @@ extern char* RouteModelWords[];
 extern char* RuleKeyWords[];
 extern char* SectWords[];
 extern char* SnowmeltWords[];
+extern char* SubcatchResultWords[];
 extern char* TempKeyWords[];
 extern char* TransectKeyWords[];
 extern char* TreatTypeWords[];
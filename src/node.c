@@ -72,6 +72,7 @@ static int    outfall_readParams(int j, int k, char* tok[], int ntoks);
 static void   outfall_setOutletDepth(int j, double yNorm, double yCrit, double z);
 
 static int    storage_readParams(int j, int k, char* tok[], int ntoks);
+static void   storage_validate(int j);
 static double storage_getDepth(int j, double v);
 static double storage_getVolume(int j, double d);
 static double storage_getSurfArea(int j, double d);
@@ -206,6 +207,7 @@ void  node_validate(int j)
         report_writeErrorMsg(ERR_NODE_DEPTH, Node[j].ID);
 
     if ( Node[j].type == DIVIDER ) divider_validate(j);
+    if ( Node[j].type == STORAGE ) storage_validate(j);
 
     // --- initialize dry weather inflows
     inflow = Node[j].dwfInflow;
@@ -739,6 +741,30 @@ int storage_readParams(int j, int k, char* tok[], int ntoks)
 
 //=============================================================================
 
+void  storage_validate(int j)
+//
+//  Input:   j = node index
+//  Output:  none
+//  Purpose: tabulates the volume held below each depth of a storage unit's
+//           area v. depth curve.
+//
+{
+    int k = Node[j].subIndex;
+    int i = Storage[k].aCurve;
+
+    if ( i < 0 || Curve[i].nEntries == 0 ) return;
+    FREE(Storage[k].aVolume);
+    Storage[k].aVolume = (double *) calloc(Curve[i].nEntries, sizeof(double));
+    if ( Storage[k].aVolume == NULL )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+    }
+    table_getAreas(&Curve[i], Storage[k].aVolume);
+}
+
+//=============================================================================
+
 double storage_getDepth(int j, double v)
 //
 //  Input:   j = node index
@@ -760,7 +786,8 @@ double storage_getDepth(int j, double v)
 
     // --- use tabular area v. depth curve
     if ( i >= 0 )
-        return table_getInverseArea(&Curve[i], v*UCF(VOLUME)) / UCF(LENGTH);
+        return table_lookupInverseArea(&Curve[i], Storage[k].aVolume,
+                                       v*UCF(VOLUME)) / UCF(LENGTH);
 
     // --- use functional area v. depth relation
     else
@@ -837,9 +864,10 @@ double storage_getVolume(int j, double d)
     if ( d >= Node[j].fullDepth
     &&   Node[j].fullVolume > 0.0 ) return Node[j].fullVolume;
 
-    // --- use table integration if area v. depth table exists
+    // --- use tabulated volumes if area v. depth table exists
     if ( i >= 0 )
-        return table_getArea(&Curve[i], d*UCF(LENGTH)) / UCF(VOLUME);
+        return table_lookupArea(&Curve[i], Storage[k].aVolume,
+                                d*UCF(LENGTH)) / UCF(VOLUME);
 
     // --- otherwise use functional area v. depth relation
     else
@@ -64,15 +64,19 @@ typedef struct
 }  TFile;
 
 //-----------------------------------------
-// LINKED LIST ENTRY FOR TABLES/TIME SERIES
+// SHARED DATA FROM A TIME SERIES FILE
 //-----------------------------------------
-struct  TableEntry
+typedef struct
 {
-   double  x;
-   double  y;
-   struct  TableEntry* next;
-};
-typedef struct TableEntry TTableEntry;
+   char          name[MAXFNAME+1]; // name of time series file
+   double        fileSize;        // size of file (bytes)
+   double        fileTime;        // last modification time of file
+   DateTime      startDate;       // date given to entries without one
+   int           count;           // number of entries
+   int           isComplete;      // TRUE if all of file's lines were read
+   double*       x;               // date of each entry
+   double*       y;               // value of each entry
+}  TTableData;
 
 
 //-------------------------
@@ -87,13 +91,38 @@ typedef struct
    double        lastDate;        // last input date for time series
    double        x1, x2;          // current bracket on x-values
    double        y1, y2;          // current bracket on y-values
-   TTableEntry*  firstEntry;      // first data point
-   TTableEntry*  lastEntry;       // last data point
-   TTableEntry*  thisEntry;       // current data point
+   int           nEntries;        // number of data points
+   int           maxEntries;      // size of data point arrays
+   int           thisEntry;       // index of current data point
+   double*       xData;           // x-value of each data point
+   double*       yData;           // y-value of each data point
    TFile         file;            // external data file
+   TTableData*   data;            // shared data read from external file
 }  TTable;
 
 
+//-----------------------
+// GRIDDED RAINFALL DATA
+//-----------------------
+typedef struct
+{
+   FILE*         file;            // binary rain grid file
+   int           nCells;          // number of grid cells
+   int           nFrames;         // number of frames in file
+   int           frame;           // index of next frame to read
+   long          startPos;        // byte position of first frame
+   float*        rain;            // current rainfall in each cell
+   float*        nextRain;        // next rainfall in each cell
+   int*          wetCells;        // cells with current rainfall
+   int*          nextWetCells;    // cells with next rainfall
+   int           nWetCells;       // number of cells with current rainfall
+   int           nNextWetCells;   // number of cells with next rainfall
+   char*         buffer;          // buffer for reading a frame's data
+   double        factor;          // converts current rainfall to intensity
+   double        nextFactor;      // converts next rainfall to intensity
+   int           reportFrame;     // frame used for reported rainfall
+}  TRainGrid;
+
 //-----------------
 // RAIN GAGE OBJECT
 //-----------------
@@ -126,6 +155,7 @@ typedef struct
    int           coGage;          // index of gage with same rain timeseries
    int           isUsed;          // TRUE if gage used by any subcatchment
    int           isCurrent;       // TRUE if gage's rainfall is current 
+   TRainGrid*    grid;            // gridded rainfall data
 }  TGage;
 
 
@@ -367,6 +397,18 @@ typedef struct
 }  TLandFactor;
 
 
+//---------------------------
+// SUBCATCHMENT RAIN GRID CELLS
+//---------------------------
+typedef struct
+{
+   int           count;           // number of grid cells
+   int           size;            // allocated size of arrays
+   int*          cell;            // index of each grid cell
+   double*       weight;          // fraction of area in each grid cell
+}  TRainCells;
+
+
 //--------------------
 // SUBCATCHMENT OBJECT
 //--------------------
@@ -390,6 +432,7 @@ typedef struct
    MathExpr*     gwLatFlowExpr;   // user-supplied lateral outflow expression  //(5.1.007)
    MathExpr*     gwDeepFlowExpr;  // user-supplied deep percolation expression //(5.1.007)
    TSnowpack*    snowpack;        // associated snow pack data
+   TRainCells    rainCells;       // rain grid cells covering subcatchment
    //-----------------------------
    double        lidArea;         // area devoted to LIDs (ft2)
    double        rainfall;        // current rainfall (ft/sec)
@@ -432,6 +475,7 @@ struct ExtInflow
    double         baseline;      // constant baseline value
    double         sFactor;       // time series scaling factor
    double         extIfaceInflow;// external interfacing inflow
+   double         baseValue;     // baseline value adjusted by its pattern
    struct ExtInflow* next;       // pointer to next inflow data object
 };
 typedef struct ExtInflow TExtInflow;
@@ -465,6 +509,7 @@ struct DwfInflow
    int            param;          // pollutant index (flow = -1)
    double         avgValue;       // average value (cfs or concen.)
    int            patterns[4];    // monthly, daily, hourly, weekend time patterns
+   double         value;          // value adjusted by its time patterns
    struct DwfInflow* next;        // pointer to next inflow data object
 };
 typedef struct DwfInflow TDwfInflow;
@@ -578,6 +623,7 @@ typedef struct
    double      aCoeff;            // coeff. of area v. height curve
    double      aExpon;            // exponent of area v. height curve
    int         aCurve;            // index of tabulated area v. height curve
+   double*     aVolume;           // volume below each point of area curve
    TExfil*     exfil;             // ptr. to exfiltration object               //(5.1.007)
    //-----------------------------
    double      hrt;               // hydraulic residence time (sec)
@@ -17,9 +17,93 @@
 //   Build 5.1.010:
 //   - Potentional ET added to list of system-wide variables saved to file.
 //
+//   The results for each reporting period are assembled in one of two period
+//   buffers and handed to a background writer thread, which saves the buffer
+//   to the binary file with a single write while the simulation goes on to
+//   fill the other buffer. Results are written directly if the thread cannot
+//   be started.
+//
+//   When the TRANSPOSED_OUTPUT option is selected, a copy of the results is
+//   added after the last reporting period (just ahead of the file's closing
+//   records) in which each value's time series is stored contiguously:
+//     Stamp identifying the transposed results (4-byte int)
+//     Number of periods per block (4-byte int)
+//     For each block of consecutive periods:
+//       For each value saved in a period (excluding its date):
+//         the value in each period of the block (4-byte floats)
+//   Each block holds the full number of periods except possibly the last.
+//
+//   Objects can be assigned output profiles in the [OUTPUT_PROFILES] section
+//   of the input file, each selecting which of their result variables are
+//   saved and every how many reporting periods. When any profiles are used,
+//   the following is written after the codes of the system result variables
+//   (just ahead of the starting report date):
+//     Stamp identifying the profiles (4-byte int)
+//     Number of profiles (4-byte int)
+//     For each profile:
+//       Object type (0 = subcatchment, 1 = node, 2 = link) (4-byte int)
+//       Number of reporting periods between saved results (4-byte int)
+//       Number of result variables saved (4-byte int)
+//       Index of each result variable saved (4-byte ints)
+//     Profile of each subcatchment, node & link reported on (4-byte ints)
+//   and each reporting period then consists of its date, the results of the
+//   objects of each profile saved in that period (profiles in order, objects
+//   in order within a profile) and the system results. A profile's results
+//   are saved in the first period and in every n-th one after it. Objects of
+//   a type with no profile assigned to them save all results every period.
+//   Results are not transposed when profiles are used.
+//
+//   When the COMPRESSED_OUTPUT option is selected, the reporting periods are
+//   saved in compressed chunks of consecutive periods. Within a chunk, each
+//   4-byte word of a period is replaced by its exclusive-or with the same
+//   word of the previous period, the chunk's bytes are regrouped by their
+//   place within a word (all first bytes, then all second bytes, etc.) and
+//   the result is run-length encoded (PackBits). The chunks are followed
+//   (just ahead of the file's closing records) by:
+//     Compressed size of each chunk (4-byte ints)
+//     Number of periods per chunk (4-byte int)
+//     Number of chunks (4-byte int)
+//     Stamp identifying compressed results (4-byte int)
+//   Compressed results are not transposed. Tolerances listed in the
+//   [OUTPUT_TOLERANCES] section round a result variable to the nearest
+//   multiple of twice its tolerance before it is saved, so that slowly
+//   varying results compress better.
+//
+//   When the OUTPUT_SUMMARY option is selected, the values saved in each
+//   reporting period (excluding its date) are summarized as the simulation
+//   runs and the summary is written last (just ahead of the file's closing
+//   records), so it can be read without touching the periods:
+//     For each value saved in a period:
+//       minimum, maximum & mean over all periods (4-byte floats)
+//       index of first period with the maximum (4-byte int)
+//     Number of values summarized (4-byte int)
+//     Stamp identifying the summary (4-byte int)
+//   All results of the objects reported on are summarized over every
+//   reporting period, including results that profiles leave unsaved.
+//
+//   Each period's results can also be published to other processes as the
+//   simulation runs through the live results stream of stream.c (see the
+//   RESULTS_STREAM option).
+//
+//   The results of the individual objects are interpolated to the reporting
+//   time and placed in the period buffer in parallel. Each object's share of
+//   the system-wide results is saved along the way and these shares are then
+//   summed in object order, so the totals do not depend on the number of
+//   threads used.
+//
+//   The time series tables of the status report are read back one object at
+//   a time. Rather than seeking to each object's results in every period,
+//   the results of a block of consecutive objects for all periods (along
+//   with the date of each period) are read in a single pass through the
+//   file, and the object's values are then served from memory.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <pthread.h>
+#endif
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -31,6 +115,26 @@
 #define REAL4 float
 #define REAL8 double
 
+// Stamp at start of transposed results & size of buffer used to create them
+#define TRANSPOSED_STAMP  516114523
+#define TRANSPOSE_BUFFER  33554432
+
+// Stamp at start of output profiles
+#define PROFILE_STAMP     516114524
+
+// Stamp at end of compressed results & size of results compressed at once
+#define COMPRESSED_STAMP  516114525
+#define CHUNK_BUFFER      1048576
+
+// Stamp at end of summary of results
+#define SUMMARY_STAMP     516114526
+
+// Number of shares of system results saved for each subcatchment
+#define SUBCATCH_SHARES   7
+
+// Size of buffer holding the reported results of a block of objects
+#define SERIES_BUFFER     33554432
+
 enum InputDataType {INPUT_TYPE_CODE, INPUT_AREA, INPUT_INVERT, INPUT_MAX_DEPTH,
                     INPUT_OFFSET, INPUT_LENGTH};
 
@@ -50,6 +154,104 @@ static INT4      NumLinks;             // number of links reported on
 static INT4      NumPolluts;           // number of pollutants reported on
 static REAL4     SysResults[MAX_SYS_RESULTS];    // values of system output vars.
 
+//-----------------------------------------------------------------------------
+//  Period buffers & background writer
+//-----------------------------------------------------------------------------
+static char*     PeriodBuffer[2];      // buffers holding a period's results
+static int       FillBuffer;           // index of buffer being filled
+static char*     WriteBuffer;          // buffer waiting to be written
+static INT4      WriteSize;            // bytes of buffer to be written
+static int       WriterStarted;        // TRUE if writer thread is running
+static int       WriterDone;           // TRUE if writer thread should stop
+static int       WriteFailed;          // TRUE if a buffer was not written
+#ifdef _WIN32
+static HANDLE             WriterThread;
+static CRITICAL_SECTION   WriterLock;
+static CONDITION_VARIABLE WriterSignal;
+#else
+static pthread_t          WriterThread;
+static pthread_mutex_t    WriterLock;
+static pthread_cond_t     WriterSignal;
+#endif
+
+//-----------------------------------------------------------------------------
+//  Placement of object results within a period
+//-----------------------------------------------------------------------------
+static int*      SubcatchSlot;         // results slot of each subcatchment
+static int*      NodeSlot;             // results slot of each node
+static int*      LinkSlot;             // results slot of each link
+static REAL4*    ScratchResults;       // results of objects not reported on
+static REAL4*    SysShares;            // objects' shares of system results
+
+//-----------------------------------------------------------------------------
+//  Output profiles
+//-----------------------------------------------------------------------------
+typedef struct
+{
+    int    type;                       // SUBCATCH, NODE or LINK
+    int    subType;                    // node or link type applied to (or -1)
+    int    index;                      // object applied to (or -1)
+    int    isAll;                      // TRUE if applied to all objects
+    int    interval;                   // seconds between saved results
+    char*  isSaved;                    // TRUE for each result variable saved
+}  TProfileLine;
+
+typedef struct
+{
+    int    type;                       // SUBCATCH, NODE or LINK
+    INT4   periods;                    // reporting periods between savings
+    INT4   nVars;                      // number of result variables saved
+    INT4*  vars;                       // index of each result variable saved
+    INT4   count;                      // number of objects with the profile
+    int*   values;                     // position of each value saved among
+                                       // all of a period's results
+}  TProfile;
+
+static TProfileLine* ProfileLines;     // profiles read from input file
+static int       NumProfileLines;      // number of profiles read
+static TProfile* Profiles;             // profiles of results saved to file
+static int       NumProfiles;          // number of profiles (0 if none)
+static int*      RptProfile;           // profile of each object reported on
+static int*      RptRank;              // rank of object among its profile's
+static char*     FullPeriod;           // all of a period's results
+
+//-----------------------------------------------------------------------------
+//  Compressed chunks of periods
+//-----------------------------------------------------------------------------
+static int       ChunkPeriods;         // reporting periods per chunk
+static int       ChunkFill;            // periods held in chunk being filled
+static INT4      ChunkBytes;           // bytes of results held in chunk
+static INT4*     ChunkPeriodSize;      // bytes of each period held in chunk
+static char*     ChunkData;            // results of the periods in a chunk
+static char*     ChunkWork;            // chunk's bytes grouped by word place
+static char*     ChunkCode;            // compressed chunk
+static int       NumChunks;            // number of chunks written
+static int       MaxChunks;            // number of chunks arrays can hold
+static INT4*     ChunkLength;          // compressed size of each chunk
+static INT4*     ChunkPos;             // file position of each chunk
+static INT4*     ChunkStart;           // position of each chunk's results
+                                       // were they saved uncompressed
+static int       CachedChunk;          // chunk held in ChunkData (or -1)
+static double*   Tolerances[LINK+1];   // rounding tolerance of each variable
+
+//-----------------------------------------------------------------------------
+//  Summary of results over all periods
+//-----------------------------------------------------------------------------
+static INT4      SummaryCount;         // number of values summarized
+static REAL4*    SummaryMin;           // minimum of each value
+static REAL4*    SummaryMax;           // maximum of each value
+static REAL8*    SummarySum;           // sum of each value
+static INT4*     SummaryMaxPeriod;     // first period with maximum value
+
+//-----------------------------------------------------------------------------
+//  Results read back for reporting
+//-----------------------------------------------------------------------------
+static REAL8*    SeriesDates;          // date/time of each reporting period
+static REAL4*    SeriesResults;        // results of a block of objects
+static int       SeriesType;           // type of objects in block
+static int       SeriesFirst;          // index of first object in block
+static int       SeriesCount;          // number of objects in block
+
 //-----------------------------------------------------------------------------
 //  Exportable variables (shared with report.c)
 //-----------------------------------------------------------------------------
@@ -63,9 +265,53 @@ REAL4*           LinkResults;
 //-----------------------------------------------------------------------------
 static void output_openOutFile(void);
 static void output_saveID(char* id, FILE* file);
-static void output_saveSubcatchResults(double reportTime, FILE* file);
-static void output_saveNodeResults(double reportTime, FILE* file);
-static void output_saveLinkResults(double reportTime, FILE* file);
+static void output_saveSubcatchResults(double reportTime, REAL4* buffer);
+static void output_saveNodeResults(double reportTime, REAL4* buffer);
+static void output_saveLinkResults(double reportTime, REAL4* buffer);
+static void output_saveTransposedResults(void);
+static int  output_openSlots(void);
+static void output_setSlots(int* slot, int nObjects, int type);
+static REAL4* output_getSlot(int slot, REAL4* buffer, int nResults);
+static int  output_findResultVariable(int type, char* s);
+static int  output_openProfiles(void);
+static void output_closeProfiles(void);
+static void output_saveProfiles(void);
+static int  output_findProfileLine(int type, int j);
+static INT4 output_packPeriod(char* results, char* buffer);
+static INT4 output_getPeriodPos(int period);
+static int  output_readProfileResults(int period, int index, int nResults,
+            REAL4* results);
+static void output_roundResults(REAL4* x);
+static int  output_openChunks(void);
+static void output_closeChunks(void);
+static int  output_writePeriod(char* buffer, INT4 size);
+static int  output_writeChunk(void);
+static void output_saveChunkIndex(void);
+static INT4 output_encodeChunk(INT4* sizes, int n, INT4 bytes);
+static int  output_decodeChunk(INT4* sizes, int n, INT4 bytes, INT4 length);
+static int  output_loadChunk(int c);
+static int  output_readResults(INT4 bytePos, void* data, INT4 size);
+static int  output_openSummary(void);
+static void output_closeSummary(void);
+static void output_updateSummary(REAL4* x);
+static void output_saveSummary(void);
+static int  output_getSeriesResults(int type, int period, int index,
+            REAL4* results);
+static int  output_readSeriesBlock(int type, int first);
+static void output_freeSeries(void);
+static void output_startWriter(void);
+static void output_stopWriter(void);
+static void output_queueBuffer(char* buffer, INT4 size);
+static void output_writeBuffers(void);
+static void output_lockWriter(void);
+static void output_unlockWriter(void);
+static void output_waitForWriter(void);
+static void output_signalWriter(void);
+#ifdef _WIN32
+static DWORD WINAPI output_writerThread(LPVOID arg);
+#else
+static void* output_writerThread(void* arg);
+#endif
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
@@ -79,6 +325,10 @@ static void output_saveLinkResults(double reportTime, FILE* file);
 //  output_readSubcatchResults    (called by report_Subcatchments)
 //  output_readNodeResults        (called by report_Nodes)
 //  output_readLinkResults        (called by report_Links)
+//  output_readProfile            (called by parseLine in input.c)
+//  output_deleteProfiles         (called by deleteObjects in project.c)
+//  output_readTolerance          (called by parseLine in input.c)
+//  output_deleteTolerances       (called by deleteObjects in project.c)
 
 
 //=============================================================================
@@ -95,6 +345,8 @@ int output_open()
     INT4  k;
     REAL4 x;
     REAL8 z;
+    int   count[3];
+    int   results[4];
 
     // --- open binary output file
     output_openOutFile();
@@ -130,6 +382,7 @@ int output_open()
         + NumLinks * NlinkResults * sizeof(REAL4)
         + MAX_SYS_RESULTS * sizeof(REAL4);
     Nperiods = 0;
+    output_freeSeries();
 
     SubcatchResults = NULL;
     NodeResults = NULL;
@@ -137,11 +390,17 @@ int output_open()
     SubcatchResults = (REAL4 *) calloc(NsubcatchResults, sizeof(REAL4));
     NodeResults = (REAL4 *) calloc(NnodeResults, sizeof(REAL4));
     LinkResults = (REAL4 *) calloc(NlinkResults, sizeof(REAL4));
-    if ( !SubcatchResults || !NodeResults || !LinkResults )
+    PeriodBuffer[0] = (char *) calloc(BytesPerPeriod, sizeof(char));
+    PeriodBuffer[1] = (char *) calloc(BytesPerPeriod, sizeof(char));
+    if ( !SubcatchResults || !NodeResults || !LinkResults ||
+         !PeriodBuffer[0] || !PeriodBuffer[1] || !output_openSlots() )
     {
         report_writeErrorMsg(ERR_MEMORY, "");
         return ErrorCode;
     }
+    if ( !output_openProfiles() ) return ErrorCode;
+    if ( !output_openChunks() ) return ErrorCode;
+    if ( !output_openSummary() ) return ErrorCode;
 
     fseek(Fout.file, 0, SEEK_SET);
     k = MAGICNUMBER;
@@ -331,6 +590,9 @@ int output_open()
     fwrite(&k, sizeof(INT4), 1, Fout.file);
     for (k=0; k<MAX_SYS_RESULTS; k++) fwrite(&k, sizeof(INT4), 1, Fout.file);
 
+    // --- save the output profiles used
+    output_saveProfiles();
+
     // --- save starting report date & report step
     //     (if reporting start date > simulation start date then
     //      make saved starting report date one reporting period
@@ -351,6 +613,17 @@ int output_open()
     }
     OutputStartPos = ftell(Fout.file);
     if ( Fout.mode == SCRATCH_FILE ) output_checkFileSize();
+
+    // --- open the stream that each period's results are published to
+    count[0] = NumSubcatch;
+    count[1] = NumNodes;
+    count[2] = NumLinks;
+    results[0] = NsubcatchResults;
+    results[1] = NnodeResults;
+    results[2] = NlinkResults;
+    results[3] = MAX_SYS_RESULTS;
+    if ( !ErrorCode ) stream_open(count, results, BytesPerPeriod);
+    if ( !ErrorCode ) output_startWriter();
     return ErrorCode;
 }
 
@@ -364,11 +637,20 @@ void  output_checkFileSize()
 //           to access using an integer file pointer variable.
 //
 {
+    int    k;
+    double bytes = BytesPerPeriod;     // average bytes saved per period
+
+    if ( NumProfiles > 0 )
+    {
+        bytes = sizeof(REAL8) + MAX_SYS_RESULTS * sizeof(REAL4);
+        for (k = 0; k < NumProfiles; k++) bytes += (double)Profiles[k].count *
+            Profiles[k].nVars * sizeof(REAL4) / Profiles[k].periods;
+    }
     if ( RptFlags.subcatchments != NONE ||
          RptFlags.nodes != NONE ||
          RptFlags.links != NONE )
     {
-        if ( (double)OutputStartPos + (double)BytesPerPeriod * TotalDuration
+        if ( (double)OutputStartPos + bytes * TotalDuration
              / 1000.0 / (double)ReportStep >= (double)MAXFILESIZE )
         {
             report_writeErrorMsg(ERR_FILE_SIZE, "");
@@ -419,18 +701,44 @@ void output_saveResults(double reportTime)
     int i;
     DateTime reportDate = getDateTime(reportTime);
     REAL8 date;
+    char* buffer;
+    INT4  size = BytesPerPeriod;
+    REAL4* x;
 
     if ( reportDate < ReportStart ) return;
+
+    // --- assemble the period's results in the buffer being filled
+    //     (or first in a full period's buffer when profiles are used)
+    buffer = PeriodBuffer[FillBuffer];
+    if ( NumProfiles > 0 ) buffer = FullPeriod;
     for (i=0; i<MAX_SYS_RESULTS; i++) SysResults[i] = 0.0f;
     date = reportDate;
-    fwrite(&date, sizeof(REAL8), 1, Fout.file);
+    memcpy(buffer, &date, sizeof(REAL8));
+    x = (REAL4 *)(buffer + sizeof(REAL8));
     if (Nobjects[SUBCATCH] > 0)
-        output_saveSubcatchResults(reportTime, Fout.file);
+        output_saveSubcatchResults(reportTime, x);
+    x += NumSubcatch * NsubcatchResults;
     if (Nobjects[NODE] > 0)
-        output_saveNodeResults(reportTime, Fout.file);
+        output_saveNodeResults(reportTime, x);
+    x += NumNodes * NnodeResults;
     if (Nobjects[LINK] > 0)
-        output_saveLinkResults(reportTime, Fout.file);
-    fwrite(SysResults, sizeof(REAL4), MAX_SYS_RESULTS, Fout.file);
+        output_saveLinkResults(reportTime, x);
+    x += NumLinks * NlinkResults;
+    memcpy(x, SysResults, MAX_SYS_RESULTS * sizeof(REAL4));
+    output_roundResults((REAL4 *)(buffer + sizeof(REAL8)));
+    output_updateSummary((REAL4 *)(buffer + sizeof(REAL8)));
+    stream_publish(buffer);
+
+    // --- keep only the results saved in this period under each profile
+    if ( NumProfiles > 0 )
+    {
+        buffer = PeriodBuffer[FillBuffer];
+        size = output_packPeriod(FullPeriod, buffer);
+    }
+
+    // --- hand the buffer to the writer & begin filling the other one
+    output_queueBuffer(buffer, size);
+    FillBuffer = 1 - FillBuffer;
     if ( Foutflows.mode == SAVE_FILE && !IgnoreRouting ) 
         iface_saveOutletResults(reportDate, Foutflows.file);
     Nperiods++;
@@ -446,6 +754,15 @@ void output_end()
 //
 {
     INT4 k;
+
+    // --- wait for all saved periods to be written
+    output_stopWriter();
+    if ( WriteFailed ) report_writeErrorMsg(ERR_OUT_WRITE, "");
+    else if ( CompressedOutput ) output_saveChunkIndex();
+    else if ( TransposedOutput && NumProfiles == 0 )
+        output_saveTransposedResults();
+    if ( !WriteFailed ) output_saveSummary();
+
     fwrite(&IDStartPos, sizeof(INT4), 1, Fout.file);
     fwrite(&InputStartPos, sizeof(INT4), 1, Fout.file);
     fwrite(&OutputStartPos, sizeof(INT4), 1, Fout.file);
@@ -458,6 +775,7 @@ void output_end()
     {
         report_writeErrorMsg(ERR_OUT_WRITE, "");
     }
+    stream_end(ErrorCode ? 2 : 1);
 }
 
 //=============================================================================
@@ -469,9 +787,22 @@ void output_close()
 //  Purpose: frees memory used for accessing the binary file.
 //
 {
+    output_stopWriter();
+    stream_close();
+    output_freeSeries();
+    output_closeProfiles();
+    output_closeChunks();
+    output_closeSummary();
     FREE(SubcatchResults);
     FREE(NodeResults);
     FREE(LinkResults);
+    FREE(PeriodBuffer[0]);
+    FREE(PeriodBuffer[1]);
+    FREE(SubcatchSlot);
+    FREE(NodeSlot);
+    FREE(LinkSlot);
+    FREE(ScratchResults);
+    FREE(SysShares);
 }
 
 //=============================================================================
@@ -491,18 +822,20 @@ void output_saveID(char* id, FILE* file)
 
 //=============================================================================
 
-void output_saveSubcatchResults(double reportTime, FILE* file)
+void output_saveSubcatchResults(double reportTime, REAL4* buffer)
 //
 //  Input:   reportTime = elapsed simulation time (millisec)
-//           file = ptr. to binary output file
+//           buffer = place in period buffer for subcatchment results
 //  Output:  none
-//  Purpose: writes computed subcatchment results to binary file.
+//  Purpose: adds computed subcatchment results to a period buffer.
 //
 {
     int      j;
     double   f;
     double   area;
     REAL4    totalArea = 0.0f; 
+    REAL4*   x;
+    REAL4*   share;
     DateTime reportDate = getDateTime(reportTime);
 
     // --- update reported rainfall at each rain gage
@@ -514,28 +847,42 @@ void output_saveSubcatchResults(double reportTime, FILE* file)
     // --- find where current reporting time lies between latest runoff times
     f = (reportTime - OldRunoffTime) / (NewRunoffTime - OldRunoffTime);
 
-    // --- write subcatchment results to file
+    // --- add subcatchment results to buffer
+#pragma omp parallel num_threads(NumThreads)
+{
+    #pragma omp for private(x, area, share)
     for ( j=0; j<Nobjects[SUBCATCH]; j++)
     {
-        // --- retrieve interpolated results for reporting time & write to file
-        subcatch_getResults(j, f, SubcatchResults);
-        if ( Subcatch[j].rptFlag )
-            fwrite(SubcatchResults, sizeof(REAL4), NsubcatchResults, file);
+        // --- retrieve interpolated results for reporting time & save them
+        x = output_getSlot(SubcatchSlot[j], buffer, NsubcatchResults);
+        subcatch_getResults(j, f, x);
 
-        // --- update system-wide results
+        // --- save subcatchment's share of system-wide results
         area = Subcatch[j].area * UCF(LANDAREA);
-        totalArea += (REAL4)area;
-        SysResults[SYS_RAINFALL] +=
-            (REAL4)(SubcatchResults[SUBCATCH_RAINFALL] * area);
-        SysResults[SYS_SNOWDEPTH] +=
-            (REAL4)(SubcatchResults[SUBCATCH_SNOWDEPTH] * area);
-        SysResults[SYS_EVAP] +=
-            (REAL4)(SubcatchResults[SUBCATCH_EVAP] * area);
-        if ( Subcatch[j].groundwater ) SysResults[SYS_EVAP] += 
+        share = SysShares + j * SUBCATCH_SHARES;
+        share[0] = (REAL4)area;
+        share[1] = (REAL4)(x[SUBCATCH_RAINFALL] * area);
+        share[2] = (REAL4)(x[SUBCATCH_SNOWDEPTH] * area);
+        share[3] = (REAL4)(x[SUBCATCH_EVAP] * area);
+        share[4] = 0.0f;
+        if ( Subcatch[j].groundwater ) share[4] =
             (REAL4)(Subcatch[j].groundwater->evapLoss * UCF(EVAPRATE) * area);
-        SysResults[SYS_INFIL] +=
-            (REAL4)(SubcatchResults[SUBCATCH_INFIL] * area);
-        SysResults[SYS_RUNOFF] += (REAL4)SubcatchResults[SUBCATCH_RUNOFF];
+        share[5] = (REAL4)(x[SUBCATCH_INFIL] * area);
+        share[6] = x[SUBCATCH_RUNOFF];
+    }
+}
+
+    // --- update system-wide results in subcatchment order
+    for ( j=0; j<Nobjects[SUBCATCH]; j++)
+    {
+        share = SysShares + j * SUBCATCH_SHARES;
+        totalArea += share[0];
+        SysResults[SYS_RAINFALL] += share[1];
+        SysResults[SYS_SNOWDEPTH] += share[2];
+        SysResults[SYS_EVAP] += share[3];
+        if ( Subcatch[j].groundwater ) SysResults[SYS_EVAP] += share[4];
+        SysResults[SYS_INFIL] += share[5];
+        SysResults[SYS_RUNOFF] += share[6];
     }
 
     // --- normalize system-wide results to catchment area
@@ -557,33 +904,38 @@ void output_saveSubcatchResults(double reportTime, FILE* file)
 
 //=============================================================================
 
-void output_saveNodeResults(double reportTime, FILE* file)
+void output_saveNodeResults(double reportTime, REAL4* buffer)
 //
 //  Input:   reportTime = elapsed simulation time (millisec)
-//           file = ptr. to binary output file
+//           buffer = place in period buffer for node results
 //  Output:  none
-//  Purpose: writes computed node results to binary file.
+//  Purpose: adds computed node results to a period buffer.
 //
 {
     extern TRoutingTotals StepFlowTotals;  // defined in massbal.c
     int j;
+    REAL4* x;
 
     // --- find where current reporting time lies between latest routing times
     double f = (reportTime - OldRoutingTime) /
                (NewRoutingTime - OldRoutingTime);
 
-    // --- write node results to file
+    // --- add node results to buffer
+#pragma omp parallel num_threads(NumThreads)
+{
+    #pragma omp for private(x)
     for (j=0; j<Nobjects[NODE]; j++)
     {
-        // --- retrieve interpolated results for reporting time & write to file
-        node_getResults(j, f, NodeResults);
-        if ( Node[j].rptFlag )
-            fwrite(NodeResults, sizeof(REAL4), NnodeResults, file);
-        stats_updateMaxNodeDepth(j, NodeResults[NODE_DEPTH]);                 //(5.1.008)
-
-        // --- update system-wide storage volume 
-        SysResults[SYS_STORAGE] += NodeResults[NODE_VOLUME];
+        // --- retrieve interpolated results for reporting time & save them
+        x = output_getSlot(NodeSlot[j], buffer, NnodeResults);
+        node_getResults(j, f, x);
+        stats_updateMaxNodeDepth(j, x[NODE_DEPTH]);                           //(5.1.008)
+        SysShares[j] = x[NODE_VOLUME];
     }
+}
+
+    // --- update system-wide storage volume in node order
+    for (j=0; j<Nobjects[NODE]; j++) SysResults[SYS_STORAGE] += SysShares[j];
 
     // --- update system-wide flows 
     SysResults[SYS_FLOODING] = (REAL4) (StepFlowTotals.flooding * UCF(FLOW));
@@ -601,33 +953,390 @@ void output_saveNodeResults(double reportTime, FILE* file)
 
 //=============================================================================
 
-void output_saveLinkResults(double reportTime, FILE* file)
+void output_saveLinkResults(double reportTime, REAL4* buffer)
 //
 //  Input:   reportTime = elapsed simulation time (millisec)
-//           file = ptr. to binary output file
+//           buffer = place in period buffer for link results
 //  Output:  none
-//  Purpose: writes computed link results to binary file.
+//  Purpose: adds computed link results to a period buffer.
 //
 {
     int j;
     double f;
     double z;
+    REAL4* x;
 
     // --- find where current reporting time lies between latest routing times
     f = (reportTime - OldRoutingTime) / (NewRoutingTime - OldRoutingTime);
 
-    // --- write link results to file
+    // --- add link results to buffer
+#pragma omp parallel num_threads(NumThreads)
+{
+    #pragma omp for private(x, z)
     for (j=0; j<Nobjects[LINK]; j++)
     {
-        // --- retrieve interpolated results for reporting time & write to file
-        link_getResults(j, f, LinkResults);
-        if ( Link[j].rptFlag ) 
-            fwrite(LinkResults, sizeof(REAL4), NlinkResults, file);
-
-        // --- update system-wide results
+        // --- retrieve interpolated results for reporting time & save them
+        x = output_getSlot(LinkSlot[j], buffer, NlinkResults);
+        link_getResults(j, f, x);
         z = ((1.0-f)*Link[j].oldVolume + f*Link[j].newVolume) * UCF(VOLUME);
-        SysResults[SYS_STORAGE] += (REAL4)z;
+        SysShares[j] = (REAL4)z;
+    }
+}
+
+    // --- update system-wide storage volume in link order
+    for (j=0; j<Nobjects[LINK]; j++) SysResults[SYS_STORAGE] += SysShares[j];
+}
+
+//=============================================================================
+
+int output_openSlots()
+//
+//  Input:   none
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: allocates and assigns the slots in which the results of each
+//           object are placed when saving a reporting period.
+//
+{
+    int n;
+
+    // --- size scratch area to hold results of all objects not reported on
+    n = (Nobjects[SUBCATCH] - NumSubcatch) * NsubcatchResults;
+    n = MAX(n, (Nobjects[NODE] - NumNodes) * NnodeResults);
+    n = MAX(n, (Nobjects[LINK] - NumLinks) * NlinkResults);
+    ScratchResults = (REAL4 *) calloc(MAX(n, 1), sizeof(REAL4));
+
+    // --- size array of system-wide shares to hold those of any object type
+    n = Nobjects[SUBCATCH] * SUBCATCH_SHARES;
+    n = MAX(n, Nobjects[NODE]);
+    n = MAX(n, Nobjects[LINK]);
+    SysShares = (REAL4 *) calloc(MAX(n, 1), sizeof(REAL4));
+
+    SubcatchSlot = (int *) calloc(MAX(Nobjects[SUBCATCH], 1), sizeof(int));
+    NodeSlot = (int *) calloc(MAX(Nobjects[NODE], 1), sizeof(int));
+    LinkSlot = (int *) calloc(MAX(Nobjects[LINK], 1), sizeof(int));
+    if ( !ScratchResults || !SysShares || !SubcatchSlot || !NodeSlot ||
+         !LinkSlot ) return FALSE;
+    output_setSlots(SubcatchSlot, Nobjects[SUBCATCH], SUBCATCH);
+    output_setSlots(NodeSlot, Nobjects[NODE], NODE);
+    output_setSlots(LinkSlot, Nobjects[LINK], LINK);
+    return TRUE;
+}
+
+//=============================================================================
+
+void output_setSlots(int* slot, int nObjects, int type)
+//
+//  Input:   slot = array of results slots
+//           nObjects = number of objects of a given type
+//           type = SUBCATCH, NODE or LINK
+//  Output:  slot = results slot of each object
+//  Purpose: numbers the objects reported on in the order their results are
+//           saved (0, 1, 2, ...) and the others in scratch order (-1, -2, ...).
+//
+{
+    int j, rptFlag;
+    int reported = 0;
+    int scratch = 0;
+
+    for (j = 0; j < nObjects; j++)
+    {
+        if ( type == SUBCATCH ) rptFlag = Subcatch[j].rptFlag;
+        else if ( type == NODE ) rptFlag = Node[j].rptFlag;
+        else rptFlag = Link[j].rptFlag;
+        if ( rptFlag ) slot[j] = reported++;
+        else slot[j] = -(++scratch);
+    }
+}
+
+//=============================================================================
+
+REAL4* output_getSlot(int slot, REAL4* buffer, int nResults)
+//
+//  Input:   slot = an object's results slot
+//           buffer = place in period buffer for results of object's type
+//           nResults = number of results per object
+//  Output:  returns address where object's results are placed
+//  Purpose: finds where an object's results go when saving a period.
+//
+{
+    if ( slot >= 0 ) return buffer + (size_t)slot * nResults;
+    return ScratchResults + (size_t)(-slot - 1) * nResults;
+}
+
+//=============================================================================
+
+void output_saveTransposedResults()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: adds a copy of all saved results, arranged by time series
+//           within blocks of periods, to the end of the binary file.
+//
+{
+    int    i, k, n, p;
+    INT4   nValues;                    // number of values in a period
+    INT4   blockPeriods;               // number of periods per block
+    INT4   stamp = TRANSPOSED_STAMP;
+    long   readPos;                    // file position of next block to read
+    long   writePos;                   // file position of next block to write
+    char*  periods;                    // block of saved periods
+    REAL4* values;                     // block of transposed values
+    REAL4* x;
+
+    // --- skip if no results were saved or file would become too large
+    if ( Nperiods == 0 ) return;
+    if ( (double)OutputStartPos + 2.0 * (double)BytesPerPeriod * Nperiods
+         + 10.0 * sizeof(INT4) >= (double)MAXFILESIZE ) return;
+
+    // --- allocate buffers for a block of periods
+    nValues = (BytesPerPeriod - sizeof(REAL8)) / sizeof(REAL4);
+    blockPeriods = MAX(1, TRANSPOSE_BUFFER / BytesPerPeriod);
+    blockPeriods = MIN(blockPeriods, Nperiods);
+    periods = (char *) malloc((size_t)blockPeriods * BytesPerPeriod);
+    values = (REAL4 *) malloc((size_t)blockPeriods * nValues * sizeof(REAL4));
+    if ( !periods || !values )
+    {
+        FREE(periods);
+        FREE(values);
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+    }
+
+    // --- write header of transposed results
+    readPos = OutputStartPos;
+    writePos = OutputStartPos + Nperiods * BytesPerPeriod;
+    fseek(Fout.file, writePos, SEEK_SET);
+    fwrite(&stamp, sizeof(INT4), 1, Fout.file);
+    fwrite(&blockPeriods, sizeof(INT4), 1, Fout.file);
+    writePos += 2 * sizeof(INT4);
+
+    // --- transpose each block of periods
+    for (k = 0; k < Nperiods; k += n)
+    {
+        n = MIN(blockPeriods, Nperiods - k);
+        fseek(Fout.file, readPos, SEEK_SET);
+        if ( fread(periods, BytesPerPeriod, n, Fout.file) < (size_t)n ) break;
+        readPos += n * BytesPerPeriod;
+        for (p = 0; p < n; p++)
+        {
+            x = (REAL4 *)(periods + p * BytesPerPeriod + sizeof(REAL8));
+            for (i = 0; i < nValues; i++) values[i*n + p] = x[i];
+        }
+        fseek(Fout.file, writePos, SEEK_SET);
+        if ( fwrite(values, sizeof(REAL4), n * nValues, Fout.file)
+             < (size_t)(n * nValues) ) break;
+        writePos += n * nValues * sizeof(REAL4);
+    }
+    if ( k < Nperiods ) report_writeErrorMsg(ERR_OUT_WRITE, "");
+    fseek(Fout.file, writePos, SEEK_SET);
+    free(periods);
+    free(values);
+}
+
+//=============================================================================
+
+void output_startWriter()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: starts the thread that writes filled period buffers to the
+//           binary output file.
+//
+{
+    FillBuffer = 0;
+    WriteBuffer = NULL;
+    WriterDone = FALSE;
+    WriteFailed = FALSE;
+    WriterStarted = FALSE;
+
+#ifdef _WIN32
+    InitializeCriticalSection(&WriterLock);
+    InitializeConditionVariable(&WriterSignal);
+    WriterThread = CreateThread(NULL, 0, output_writerThread, NULL, 0, NULL);
+    if ( WriterThread != NULL ) WriterStarted = TRUE;
+    else DeleteCriticalSection(&WriterLock);
+#else
+    if ( pthread_mutex_init(&WriterLock, NULL) != 0 ) return;
+    if ( pthread_cond_init(&WriterSignal, NULL) != 0 )
+    {
+        pthread_mutex_destroy(&WriterLock);
+        return;
+    }
+    if ( pthread_create(&WriterThread, NULL, output_writerThread, NULL) == 0 )
+        WriterStarted = TRUE;
+    else
+    {
+        pthread_cond_destroy(&WriterSignal);
+        pthread_mutex_destroy(&WriterLock);
+    }
+#endif
+}
+
+//=============================================================================
+
+void output_stopWriter()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: waits for the writer thread to save any pending period buffer
+//           and then ends the thread.
+//
+{
+    if ( !WriterStarted ) return;
+    output_lockWriter();
+    WriterDone = TRUE;
+    output_signalWriter();
+    output_unlockWriter();
+
+#ifdef _WIN32
+    WaitForSingleObject(WriterThread, INFINITE);
+    CloseHandle(WriterThread);
+    DeleteCriticalSection(&WriterLock);
+#else
+    pthread_join(WriterThread, NULL);
+    pthread_cond_destroy(&WriterSignal);
+    pthread_mutex_destroy(&WriterLock);
+#endif
+    WriterStarted = FALSE;
+}
+
+//=============================================================================
+
+void output_queueBuffer(char* buffer, INT4 size)
+//
+//  Input:   buffer = a filled period buffer
+//           size = number of bytes filled
+//  Output:  none
+//  Purpose: passes a filled period buffer to the writer thread once it has
+//           finished writing the previous one.
+//
+{
+    if ( !WriterStarted )
+    {
+        if ( !output_writePeriod(buffer, size) ) WriteFailed = TRUE;
+        return;
+    }
+    output_lockWriter();
+    while ( WriteBuffer != NULL ) output_waitForWriter();
+    WriteBuffer = buffer;
+    WriteSize = size;
+    output_signalWriter();
+    output_unlockWriter();
+}
+
+//=============================================================================
+
+void output_writeBuffers()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: writes each period buffer passed to the writer thread to the
+//           binary output file until told to stop.
+//
+{
+    char*  buffer;
+    INT4   size;
+    int    written;
+
+    output_lockWriter();
+    for (;;)
+    {
+        while ( WriteBuffer == NULL && !WriterDone ) output_waitForWriter();
+        if ( WriteBuffer == NULL ) break;
+        buffer = WriteBuffer;
+        size = WriteSize;
+        output_unlockWriter();
+
+        written = output_writePeriod(buffer, size);
+
+        output_lockWriter();
+        if ( !written ) WriteFailed = TRUE;
+        WriteBuffer = NULL;
+        output_signalWriter();
     }
+    output_unlockWriter();
+}
+
+//=============================================================================
+
+#ifdef _WIN32
+DWORD WINAPI output_writerThread(LPVOID arg)
+#else
+void* output_writerThread(void* arg)
+#endif
+//
+//  Input:   arg = not used
+//  Output:  none
+//  Purpose: entry point of the writer thread.
+//
+{
+    output_writeBuffers();
+    return 0;
+}
+
+//=============================================================================
+
+void output_lockWriter()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: acquires the lock that guards the writer thread's state.
+//
+{
+#ifdef _WIN32
+    EnterCriticalSection(&WriterLock);
+#else
+    pthread_mutex_lock(&WriterLock);
+#endif
+}
+
+//=============================================================================
+
+void output_unlockWriter()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: releases the lock that guards the writer thread's state.
+//
+{
+#ifdef _WIN32
+    LeaveCriticalSection(&WriterLock);
+#else
+    pthread_mutex_unlock(&WriterLock);
+#endif
+}
+
+//=============================================================================
+
+void output_waitForWriter()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: releases the writer lock until the writer thread's state
+//           changes and then re-acquires it.
+//
+{
+#ifdef _WIN32
+    SleepConditionVariableCS(&WriterSignal, &WriterLock, INFINITE);
+#else
+    pthread_cond_wait(&WriterSignal, &WriterLock);
+#endif
+}
+
+//=============================================================================
+
+void output_signalWriter()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: announces a change in the writer thread's state.
+//
+{
+#ifdef _WIN32
+    WakeAllConditionVariable(&WriterSignal);
+#else
+    pthread_cond_broadcast(&WriterSignal);
+#endif
 }
 
 //=============================================================================
@@ -640,63 +1349,1247 @@ void output_readDateTime(int period, DateTime* days)
 //           from the binary output file.
 //
 {
-    INT4 bytePos = OutputStartPos + (period-1)*BytesPerPeriod;
-    fseek(Fout.file, bytePos, SEEK_SET);
+    INT4 bytePos = output_getPeriodPos(period);
+    if ( SeriesDates && period >= 1 && period <= Nperiods )
+    {
+        *days = SeriesDates[period-1];
+        return;
+    }
     *days = NO_DATE;
-    fread(days, sizeof(REAL8), 1, Fout.file);
+    output_readResults(bytePos, days, sizeof(REAL8));
 }
 
 //=============================================================================
 
-void output_readSubcatchResults(int period, int index)
+int output_readSubcatchResults(int period, int index)
 //
 //  Input:   period = index of reporting time period
 //           index = subcatchment index
-//  Output:  none
+//  Output:  returns TRUE if results were saved for the period, FALSE if not
 //  Purpose: reads computed results for a subcatchment at a specific time
 //           period.
 //
 {
-    INT4 bytePos = OutputStartPos + (period-1)*BytesPerPeriod;
+    INT4 bytePos = output_getPeriodPos(period);
+    if ( NumProfiles > 0 ) return output_readProfileResults(period, index,
+                                  NsubcatchResults, SubcatchResults);
+    if ( output_getSeriesResults(SUBCATCH, period, index, SubcatchResults) )
+        return TRUE;
     bytePos += sizeof(REAL8) + index*NsubcatchResults*sizeof(REAL4);
-    fseek(Fout.file, bytePos, SEEK_SET);
-    fread(SubcatchResults, sizeof(REAL4), NsubcatchResults, Fout.file);
+    output_readResults(bytePos, SubcatchResults,
+                       NsubcatchResults * sizeof(REAL4));
+    return TRUE;
 }
 
 //=============================================================================
 
-void output_readNodeResults(int period, int index)
+int output_readNodeResults(int period, int index)
 //
 //  Input:   period = index of reporting time period
 //           index = node index
-//  Output:  none
+//  Output:  returns TRUE if results were saved for the period, FALSE if not
 //  Purpose: reads computed results for a node at a specific time period.
 //
 {
-    INT4 bytePos = OutputStartPos + (period-1)*BytesPerPeriod;
+    INT4 bytePos = output_getPeriodPos(period);
+    if ( NumProfiles > 0 ) return output_readProfileResults(period,
+                                  NumSubcatch + index, NnodeResults, NodeResults);
+    if ( output_getSeriesResults(NODE, period, index, NodeResults) )
+        return TRUE;
     bytePos += sizeof(REAL8) + NumSubcatch*NsubcatchResults*sizeof(REAL4);
     bytePos += index*NnodeResults*sizeof(REAL4);
-    fseek(Fout.file, bytePos, SEEK_SET);
-    fread(NodeResults, sizeof(REAL4), NnodeResults, Fout.file);
+    output_readResults(bytePos, NodeResults, NnodeResults * sizeof(REAL4));
+    return TRUE;
 }
 
 //=============================================================================
 
-void output_readLinkResults(int period, int index)
+int output_readLinkResults(int period, int index)
 //
 //  Input:   period = index of reporting time period
 //           index = link index
-//  Output:  none
+//  Output:  returns TRUE if results were saved for the period, FALSE if not
 //  Purpose: reads computed results for a link at a specific time period.
 //
 {
-    INT4 bytePos = OutputStartPos + (period-1)*BytesPerPeriod;
+    INT4 bytePos = output_getPeriodPos(period);
+    if ( NumProfiles > 0 ) return output_readProfileResults(period,
+        NumSubcatch + NumNodes + index, NlinkResults, LinkResults);
+    if ( output_getSeriesResults(LINK, period, index, LinkResults) )
+        return TRUE;
     bytePos += sizeof(REAL8) + NumSubcatch*NsubcatchResults*sizeof(REAL4);
     bytePos += NumNodes*NnodeResults*sizeof(REAL4);
     bytePos += index*NlinkResults*sizeof(REAL4);
-    fseek(Fout.file, bytePos, SEEK_SET);
-    fread(LinkResults, sizeof(REAL4), NlinkResults, Fout.file);
-    fread(SysResults, sizeof(REAL4), MAX_SYS_RESULTS, Fout.file);
+    output_readResults(bytePos, LinkResults, NlinkResults * sizeof(REAL4));
+    bytePos += NlinkResults * sizeof(REAL4);
+    output_readResults(bytePos, SysResults, MAX_SYS_RESULTS * sizeof(REAL4));
+    return TRUE;
+}
+
+//=============================================================================
+
+int output_getSeriesResults(int type, int period, int index, REAL4* results)
+//
+//  Input:   type = SUBCATCH, NODE or LINK
+//           period = index of reporting time period
+//           index = index of object among those reported on
+//  Output:  results = object's results for the period;
+//           returns TRUE if results were found, FALSE if not
+//  Purpose: retrieves an object's results for a reporting period from the
+//           block of objects read for reporting, first reading in the block
+//           that starts with the object if it is not already held.
+//
+{
+    int nResults;
+
+    if ( period < 1 || period > Nperiods ) return FALSE;
+    if ( type != SeriesType || index < SeriesFirst ||
+         index >= SeriesFirst + SeriesCount )
+    {
+        if ( !output_readSeriesBlock(type, index) ) return FALSE;
+    }
+    if ( type == SUBCATCH ) nResults = NsubcatchResults;
+    else if ( type == NODE ) nResults = NnodeResults;
+    else nResults = NlinkResults;
+    memcpy(results, SeriesResults + ((size_t)(period-1) * SeriesCount +
+           index - SeriesFirst) * nResults, nResults * sizeof(REAL4));
+    return TRUE;
+}
+
+//=============================================================================
+
+int output_readSeriesBlock(int type, int first)
+//
+//  Input:   type = SUBCATCH, NODE or LINK
+//           first = index of first object of block
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: reads the results in all reporting periods for as many objects
+//           starting from a given one as fit in the series buffer, making a
+//           single pass through the binary file in period order.
+//
+{
+    int    p;
+    int    count;                      // number of objects in block
+    int    readDates;                  // TRUE if period dates are needed
+    INT4   nResults;                   // number of results per object
+    INT4   nObjects;                   // number of objects reported on
+    INT4   offset;                     // offset of block within a period
+    INT4   bytePos;
+    size_t n;                          // number of results per period
+
+    // --- find size and location of block within a period
+    offset = sizeof(REAL8);
+    if ( type == SUBCATCH )
+    {
+        nResults = NsubcatchResults;
+        nObjects = NumSubcatch;
+    }
+    else if ( type == NODE )
+    {
+        offset += NumSubcatch * NsubcatchResults * sizeof(REAL4);
+        nResults = NnodeResults;
+        nObjects = NumNodes;
+    }
+    else
+    {
+        offset += NumSubcatch * NsubcatchResults * sizeof(REAL4);
+        offset += NumNodes * NnodeResults * sizeof(REAL4);
+        nResults = NlinkResults;
+        nObjects = NumLinks;
+    }
+    if ( first < 0 || first >= nObjects || nResults == 0 ) return FALSE;
+    offset += first * nResults * sizeof(REAL4);
+    count = MAX(1, SERIES_BUFFER / (Nperiods * nResults * sizeof(REAL4)));
+    count = MIN(count, nObjects - first);
+    n = (size_t)count * nResults;
+
+    // --- allocate memory for the block (and for the period dates)
+    SeriesCount = 0;
+    FREE(SeriesResults);
+    SeriesResults = (REAL4 *) malloc(n * Nperiods * sizeof(REAL4));
+    if ( SeriesResults == NULL ) return FALSE;
+    readDates = ( SeriesDates == NULL );
+    if ( readDates )
+    {
+        SeriesDates = (REAL8 *) malloc(Nperiods * sizeof(REAL8));
+        if ( SeriesDates == NULL ) return FALSE;
+    }
+
+    // --- read the block's results (and date) from each period in turn
+    for (p = 0; p < Nperiods; p++)
+    {
+        bytePos = OutputStartPos + p*BytesPerPeriod;
+        if ( readDates )
+        {
+            SeriesDates[p] = NO_DATE;
+            output_readResults(bytePos, &SeriesDates[p], sizeof(REAL8));
+        }
+        if ( !output_readResults(bytePos + offset, SeriesResults + p*n,
+                                 n * sizeof(REAL4)) )
+        {
+            FREE(SeriesResults);
+            if ( readDates ) FREE(SeriesDates);
+            return FALSE;
+        }
+    }
+    SeriesType = type;
+    SeriesFirst = first;
+    SeriesCount = count;
+    return TRUE;
+}
+
+//=============================================================================
+
+void output_freeSeries()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the results read back for reporting.
+//
+{
+    FREE(SeriesDates);
+    FREE(SeriesResults);
+    SeriesType = -1;
+    SeriesFirst = 0;
+    SeriesCount = 0;
 }
 
 //=============================================================================
+
+int output_readProfile(char* tok[], int ntoks)
+//
+//  Input:   tok[] = array of string tokens
+//           ntoks = number of tokens
+//  Output:  returns an error code
+//  Purpose: reads an output profile that selects which result variables of
+//           a group of objects are saved to the binary output file and at
+//           what interval.
+//
+//  Format of data line is:
+//     objectType  objects  interval  variable1  variable2 ...
+//  where objectType is SUBCATCH, NODE or LINK, objects is * (all objects of
+//  the type), a node or link type (such as OUTFALL or PUMP) or an object's
+//  ID name, interval is the time (in hours:minutes:seconds) between saved
+//  results and the variables are ALL or names of result variables (such as
+//  DEPTH or FLOW) and pollutants. A later profile replaces an earlier one
+//  for any object that both apply to.
+//
+{
+    int  i, k, h, m, s;
+    int  type;                         // object type
+    int  subType = -1;                 // node or link type profile applies to
+    int  index = -1;                   // object profile applies to
+    int  nVars;                        // number of result variables
+    int  nSubTypes = 0;                // number of node or link types
+    int  isAll = FALSE;                // TRUE if profile applies to all objects
+    char** subTypeWords = NULL;
+    DateTime aTime;
+    TProfileLine* line;
+
+    // --- check for enough tokens
+    if ( ntoks < 4 ) return error_setInpError(ERR_ITEMS, "");
+
+    // --- get type of object profile applies to
+    if ( match(tok[0], w_SUBCATCH) )
+    {
+        type = SUBCATCH;
+        nVars = MAX_SUBCATCH_RESULTS - 1;
+    }
+    else if ( match(tok[0], w_NODE) )
+    {
+        type = NODE;
+        nVars = MAX_NODE_RESULTS - 1;
+        subTypeWords = NodeTypeWords;
+        nSubTypes = DIVIDER + 1;
+    }
+    else if ( match(tok[0], w_LINK) )
+    {
+        type = LINK;
+        nVars = MAX_LINK_RESULTS - 1;
+        subTypeWords = LinkTypeWords;
+        nSubTypes = OUTLET + 1;
+    }
+    else return error_setInpError(ERR_KEYWORD, tok[0]);
+    nVars += Nobjects[POLLUT];
+
+    // --- get the objects profile applies to
+    if ( strcmp(tok[1], "*") == 0 ) isAll = TRUE;
+    else
+    {
+        for (k = 0; k < nSubTypes; k++)
+        {
+            if ( strcomp(tok[1], subTypeWords[k]) ) subType = k;
+        }
+        if ( subType < 0 )
+        {
+            index = project_findObject(type, tok[1]);
+            if ( index < 0 ) return error_setInpError(ERR_NAME, tok[1]);
+        }
+    }
+
+    // --- get interval between saved results (in seconds)
+    if ( !datetime_strToTime(tok[2], &aTime) )
+    {
+        return error_setInpError(ERR_DATETIME, tok[2]);
+    }
+    datetime_decodeTime(aTime, &h, &m, &s);
+    h += 24*(int)aTime;
+    s = s + 60*m + 3600*h;
+    if ( s <= 0 ) return error_setInpError(ERR_NUMBER, tok[2]);
+
+    // --- add a new profile line
+    line = (TProfileLine *) realloc(ProfileLines,
+           (NumProfileLines + 1) * sizeof(TProfileLine));
+    if ( line == NULL ) return error_setInpError(ERR_MEMORY, "");
+    ProfileLines = line;
+    line = &ProfileLines[NumProfileLines];
+    line->type = type;
+    line->subType = subType;
+    line->index = index;
+    line->isAll = isAll;
+    line->interval = s;
+    line->isSaved = (char *) calloc(MAX(nVars, 1), sizeof(char));
+    if ( line->isSaved == NULL ) return error_setInpError(ERR_MEMORY, "");
+    NumProfileLines++;
+
+    // --- mark the result variables it saves
+    for (i = 3; i < ntoks; i++)
+    {
+        if ( strcomp(tok[i], w_ALL) )
+        {
+            for (k = 0; k < nVars; k++) line->isSaved[k] = TRUE;
+            continue;
+        }
+        k = output_findResultVariable(type, tok[i]);
+        if ( k < 0 ) return error_setInpError(ERR_KEYWORD, tok[i]);
+        line->isSaved[k] = TRUE;
+    }
+    return 0;
+}
+
+//=============================================================================
+
+int output_findResultVariable(int type, char* s)
+//
+//  Input:   type = SUBCATCH, NODE or LINK
+//           s = name of a result variable or a pollutant
+//  Output:  returns index of result variable (-1 if not found)
+//  Purpose: finds which of an object type's result variables a name refers to.
+//
+{
+    int    k, p;
+    char** words;
+
+    if ( type == SUBCATCH ) words = SubcatchResultWords;
+    else if ( type == NODE ) words = NodeResultWords;
+    else words = LinkResultWords;
+    for (k = 0; words[k] != NULL; k++)
+    {
+        if ( strcomp(s, words[k]) ) return k;
+    }
+    p = project_findObject(POLLUT, s);
+    if ( p >= 0 ) return k + p;
+    return -1;
+}
+
+//=============================================================================
+
+void output_deleteProfiles()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the output profiles read from the input file.
+//
+{
+    int i;
+
+    for (i = 0; i < NumProfileLines; i++) FREE(ProfileLines[i].isSaved);
+    FREE(ProfileLines);
+    NumProfileLines = 0;
+}
+
+//=============================================================================
+
+int output_openProfiles()
+//
+//  Input:   none
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: creates the profiles under which the results of the objects
+//           reported on are saved.
+//
+{
+    int  i, j, k, m, g, v;
+    int  type;                         // object type
+    int  nObjects;                     // number of objects of a type
+    int  nResults;                     // number of results per object
+    int  start;                        // position of object's results
+    int* lineProfile;                  // profile created for each line
+    int  rptFlag;
+    char theTime[20];
+    TProfile* p;
+
+    output_closeProfiles();
+    if ( NumProfileLines == 0 ) return TRUE;
+
+    // --- check that profile intervals are whole reporting periods
+    for (i = 0; i < NumProfileLines; i++)
+    {
+        if ( ProfileLines[i].interval % ReportStep != 0 )
+        {
+            datetime_timeToStr(ProfileLines[i].interval / 86400.0, theTime);
+            report_writeErrorMsg(ERR_OUTPUT_INTERVAL, theTime);
+            return FALSE;
+        }
+    }
+
+    // --- allocate memory
+    m = NumSubcatch + NumNodes + NumLinks;
+    Profiles = (TProfile *) calloc(3 * (NumProfileLines + 1), sizeof(TProfile));
+    RptProfile = (int *) calloc(MAX(m, 1), sizeof(int));
+    RptRank = (int *) calloc(MAX(m, 1), sizeof(int));
+    FullPeriod = (char *) calloc(BytesPerPeriod, sizeof(char));
+    lineProfile = (int *) calloc(NumProfileLines + 1, sizeof(int));
+    if ( !Profiles || !RptProfile || !RptRank || !FullPeriod || !lineProfile )
+    {
+        FREE(lineProfile);
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return FALSE;
+    }
+
+    // --- create a profile for each profile line (plus one for objects
+    //     without a line) used by an object of each type reported on
+    g = 0;
+    for (type = SUBCATCH; type <= LINK; type++)
+    {
+        if ( type == SUBCATCH ) nResults = NsubcatchResults;
+        else if ( type == NODE ) nResults = NnodeResults;
+        else nResults = NlinkResults;
+        nObjects = Nobjects[type];
+        for (i = 0; i <= NumProfileLines; i++) lineProfile[i] = -1;
+        for (j = 0; j < nObjects; j++)
+        {
+            if ( type == SUBCATCH ) rptFlag = Subcatch[j].rptFlag;
+            else if ( type == NODE ) rptFlag = Node[j].rptFlag;
+            else rptFlag = Link[j].rptFlag;
+            if ( !rptFlag ) continue;
+            i = output_findProfileLine(type, j) + 1;
+            if ( lineProfile[i] < 0 )
+            {
+                p = &Profiles[NumProfiles];
+                p->type = type;
+                p->periods = i ? ProfileLines[i-1].interval / ReportStep : 1;
+                p->vars = (INT4 *) calloc(MAX(nResults, 1), sizeof(INT4));
+                if ( p->vars == NULL ) break;
+                for (v = 0; v < nResults; v++)
+                {
+                    if ( i == 0 || ProfileLines[i-1].isSaved[v] )
+                        p->vars[p->nVars++] = v;
+                }
+                lineProfile[i] = NumProfiles++;
+            }
+            RptProfile[g] = lineProfile[i];
+            RptRank[g] = Profiles[lineProfile[i]].count++;
+            g++;
+        }
+        if ( j < nObjects ) break;
+    }
+    free(lineProfile);
+    if ( g < m )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return FALSE;
+    }
+
+    // --- find where each value saved under a profile lies among all of
+    //     a period's results
+    for (k = 0; k < NumProfiles; k++)
+    {
+        p = &Profiles[k];
+        p->values = (int *) calloc(MAX(p->count * p->nVars, 1), sizeof(int));
+        if ( p->values == NULL )
+        {
+            report_writeErrorMsg(ERR_MEMORY, "");
+            return FALSE;
+        }
+    }
+    for (g = 0; g < m; g++)
+    {
+        if ( g < NumSubcatch ) start = g * NsubcatchResults;
+        else if ( g < NumSubcatch + NumNodes )
+            start = NumSubcatch * NsubcatchResults +
+                    (g - NumSubcatch) * NnodeResults;
+        else start = NumSubcatch * NsubcatchResults + NumNodes * NnodeResults
+                     + (g - NumSubcatch - NumNodes) * NlinkResults;
+        p = &Profiles[RptProfile[g]];
+        for (v = 0; v < p->nVars; v++)
+            p->values[RptRank[g] * p->nVars + v] = start + p->vars[v];
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+int output_findProfileLine(int type, int j)
+//
+//  Input:   type = SUBCATCH, NODE or LINK
+//           j = object index
+//  Output:  returns index of profile line applied to object (-1 if none)
+//  Purpose: finds the last profile line read that applies to an object.
+//
+//  Lines are matched to objects here, after all of the input file has been
+//  read, since a line that names a node or link type may come before the
+//  section that assigns objects their types.
+//
+{
+    int i;
+    TProfileLine* line;
+
+    for (i = NumProfileLines - 1; i >= 0; i--)
+    {
+        line = &ProfileLines[i];
+        if ( line->type != type ) continue;
+        if ( line->isAll || line->index == j ) return i;
+        if ( type == NODE && line->subType >= 0 &&
+             Node[j].type == line->subType ) return i;
+        if ( type == LINK && line->subType >= 0 &&
+             Link[j].type == line->subType ) return i;
+    }
+    return -1;
+}
+
+//=============================================================================
+
+void output_closeProfiles()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the profiles under which results were saved.
+//
+{
+    int k;
+
+    if ( Profiles ) for (k = 0; k < NumProfiles; k++)
+    {
+        FREE(Profiles[k].vars);
+        FREE(Profiles[k].values);
+    }
+    FREE(Profiles);
+    NumProfiles = 0;
+    FREE(RptProfile);
+    FREE(RptRank);
+    FREE(FullPeriod);
+}
+
+//=============================================================================
+
+void output_saveProfiles()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: writes a description of the output profiles used to the
+//           binary output file.
+//
+{
+    int  g, k;
+    INT4 x;
+
+    if ( NumProfiles == 0 ) return;
+    x = PROFILE_STAMP;
+    fwrite(&x, sizeof(INT4), 1, Fout.file);
+    x = NumProfiles;
+    fwrite(&x, sizeof(INT4), 1, Fout.file);
+    for (k = 0; k < NumProfiles; k++)
+    {
+        x = Profiles[k].type - SUBCATCH;
+        fwrite(&x, sizeof(INT4), 1, Fout.file);
+        fwrite(&Profiles[k].periods, sizeof(INT4), 1, Fout.file);
+        fwrite(&Profiles[k].nVars, sizeof(INT4), 1, Fout.file);
+        fwrite(Profiles[k].vars, sizeof(INT4), Profiles[k].nVars, Fout.file);
+    }
+    for (g = 0; g < NumSubcatch + NumNodes + NumLinks; g++)
+    {
+        x = RptProfile[g];
+        fwrite(&x, sizeof(INT4), 1, Fout.file);
+    }
+}
+
+//=============================================================================
+
+INT4 output_packPeriod(char* results, char* buffer)
+//
+//  Input:   results = all of a period's results
+//           buffer = a period buffer
+//  Output:  returns number of bytes placed in buffer
+//  Purpose: places the date, the results saved under each profile in the
+//           current period and the system results in a period buffer.
+//
+{
+    int    i, k, n;
+    REAL4* x = (REAL4 *)(results + sizeof(REAL8));
+    REAL4* y = (REAL4 *)(buffer + sizeof(REAL8));
+    TProfile* p;
+
+    memcpy(buffer, results, sizeof(REAL8));
+    for (k = 0; k < NumProfiles; k++)
+    {
+        p = &Profiles[k];
+        if ( Nperiods % p->periods != 0 ) continue;
+        n = p->count * p->nVars;
+        for (i = 0; i < n; i++) y[i] = x[p->values[i]];
+        y += n;
+    }
+    n = (BytesPerPeriod - sizeof(REAL8)) / sizeof(REAL4) - MAX_SYS_RESULTS;
+    memcpy(y, x + n, MAX_SYS_RESULTS * sizeof(REAL4));
+    y += MAX_SYS_RESULTS;
+    return (INT4)((char *)y - buffer);
+}
+
+//=============================================================================
+
+INT4 output_getPeriodPos(int period)
+//
+//  Input:   period = index of reporting time period
+//  Output:  returns file position where the period's results start
+//  Purpose: finds where a reporting period is saved in the binary file.
+//
+{
+    int  k;
+    INT4 n;
+    INT4 bytePos;
+
+    if ( NumProfiles == 0 ) return OutputStartPos + (period-1)*BytesPerPeriod;
+    bytePos = OutputStartPos +
+              (period-1) * (sizeof(REAL8) + MAX_SYS_RESULTS*sizeof(REAL4));
+    for (k = 0; k < NumProfiles; k++)
+    {
+        // --- number of earlier periods in which profile's results were saved
+        n = (period - 1 + Profiles[k].periods - 1) / Profiles[k].periods;
+        bytePos += n * Profiles[k].count * Profiles[k].nVars * sizeof(REAL4);
+    }
+    return bytePos;
+}
+
+//=============================================================================
+
+int output_readProfileResults(int period, int index, int nResults,
+    REAL4* results)
+//
+//  Input:   period = index of reporting time period
+//           index = position of object among all objects reported on
+//           nResults = number of results per object
+//  Output:  results = object's results (MISSING for variables not saved);
+//           returns TRUE if results were saved for the period and could be
+//           read, FALSE if not
+//  Purpose: reads the results saved under its profile for an object at a
+//           specific time period.
+//
+{
+    int    i, k;
+    INT4   bytePos;
+    REAL4* x = (REAL4 *)FullPeriod;
+    TProfile* p = &Profiles[RptProfile[index]];
+
+    if ( (period - 1) % p->periods != 0 ) return FALSE;
+    bytePos = output_getPeriodPos(period) + sizeof(REAL8);
+    for (k = 0; k < RptProfile[index]; k++)
+    {
+        if ( (period - 1) % Profiles[k].periods == 0 ) bytePos +=
+            Profiles[k].count * Profiles[k].nVars * sizeof(REAL4);
+    }
+    bytePos += RptRank[index] * p->nVars * sizeof(REAL4);
+    for (i = 0; i < nResults; i++) results[i] = (REAL4)MISSING;
+    if ( !output_readResults(bytePos, x, p->nVars * sizeof(REAL4)) )
+        return FALSE;
+    for (i = 0; i < p->nVars; i++) results[p->vars[i]] = x[i];
+    return TRUE;
+}
+
+//=============================================================================
+
+int output_readTolerance(char* tok[], int ntoks)
+//
+//  Input:   tok[] = array of string tokens
+//           ntoks = number of tokens
+//  Output:  returns an error code
+//  Purpose: reads the tolerance within which a result variable of an
+//           object type is rounded before it is saved.
+//
+//  Format of data line is:
+//     objectType  variable  tolerance
+//  where objectType is SUBCATCH, NODE or LINK, variable is the name of a
+//  result variable (such as DEPTH or FLOW) or a pollutant and tolerance is
+//  the largest change (in user's units) that rounding may make to a result.
+//
+{
+    int    k, type, nVars;
+    double x;
+
+    // --- check for enough tokens
+    if ( ntoks < 3 ) return error_setInpError(ERR_ITEMS, "");
+
+    // --- get object type and result variable
+    if ( match(tok[0], w_SUBCATCH) )
+    {
+        type = SUBCATCH;
+        nVars = MAX_SUBCATCH_RESULTS - 1;
+    }
+    else if ( match(tok[0], w_NODE) )
+    {
+        type = NODE;
+        nVars = MAX_NODE_RESULTS - 1;
+    }
+    else if ( match(tok[0], w_LINK) )
+    {
+        type = LINK;
+        nVars = MAX_LINK_RESULTS - 1;
+    }
+    else return error_setInpError(ERR_KEYWORD, tok[0]);
+    nVars += Nobjects[POLLUT];
+    k = output_findResultVariable(type, tok[1]);
+    if ( k < 0 ) return error_setInpError(ERR_KEYWORD, tok[1]);
+
+    // --- get tolerance
+    if ( !getDouble(tok[2], &x) || x < 0.0 )
+        return error_setInpError(ERR_NUMBER, tok[2]);
+
+    // --- save tolerance
+    if ( Tolerances[type] == NULL )
+    {
+        Tolerances[type] = (double *) calloc(nVars, sizeof(double));
+        if ( Tolerances[type] == NULL )
+            return error_setInpError(ERR_MEMORY, "");
+    }
+    Tolerances[type][k] = x;
+    return 0;
+}
+
+//=============================================================================
+
+void output_deleteTolerances()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the rounding tolerances read from the input file.
+//
+{
+    int i;
+
+    for (i = 0; i <= LINK; i++) FREE(Tolerances[i]);
+}
+
+//=============================================================================
+
+void output_roundResults(REAL4* x)
+//
+//  Input:   x = results of all objects reported on for a period
+//  Output:  x = results rounded within their tolerances
+//  Purpose: rounds each result variable that has a tolerance to the nearest
+//           multiple of twice the tolerance.
+//
+{
+    int    j, v, type;
+    int    nObjects = 0;               // number of objects reported on
+    int    nResults = 0;               // number of results per object
+    int    nVars;                      // number of variables with tolerances
+    double q;                          // rounding interval
+
+    for (type = SUBCATCH; type <= LINK; type++)
+    {
+        if ( type == SUBCATCH )
+        {
+            nObjects = NumSubcatch;
+            nResults = NsubcatchResults;
+        }
+        else if ( type == NODE )
+        {
+            nObjects = NumNodes;
+            nResults = NnodeResults;
+        }
+        else
+        {
+            nObjects = NumLinks;
+            nResults = NlinkResults;
+        }
+        if ( Tolerances[type] )
+        {
+            nVars = MIN(nResults, Nobjects[POLLUT] + (type == SUBCATCH ?
+                    MAX_SUBCATCH_RESULTS : type == NODE ? MAX_NODE_RESULTS :
+                    MAX_LINK_RESULTS) - 1);
+            for (v = 0; v < nVars; v++)
+            {
+                q = 2.0 * Tolerances[type][v];
+                if ( q <= 0.0 ) continue;
+                for (j = 0; j < nObjects; j++)
+                {
+                    x[j*nResults + v] =
+                        (REAL4)(q * floor(x[j*nResults + v] / q + 0.5));
+                }
+            }
+        }
+        x += nObjects * nResults;
+    }
+}
+
+//=============================================================================
+
+int output_openChunks()
+//
+//  Input:   none
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: allocates memory for compressing chunks of reporting periods.
+//
+{
+    INT4 bytes;
+
+    output_closeChunks();
+    if ( !CompressedOutput ) return TRUE;
+    ChunkPeriods = MAX(1, CHUNK_BUFFER / BytesPerPeriod);
+    bytes = ChunkPeriods * BytesPerPeriod;
+    ChunkPeriodSize = (INT4 *) calloc(ChunkPeriods, sizeof(INT4));
+    ChunkData = (char *) malloc(bytes);
+    ChunkWork = (char *) malloc(bytes);
+    ChunkCode = (char *) malloc(bytes + bytes / 128 + 1);
+    MaxChunks = 64;
+    ChunkLength = (INT4 *) calloc(MaxChunks, sizeof(INT4));
+    ChunkPos = (INT4 *) calloc(MaxChunks, sizeof(INT4));
+    ChunkStart = (INT4 *) calloc(MaxChunks, sizeof(INT4));
+    if ( !ChunkPeriodSize || !ChunkData || !ChunkWork || !ChunkCode ||
+         !ChunkLength || !ChunkPos || !ChunkStart )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+void output_closeChunks()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the memory used for compressed chunks of periods.
+//
+{
+    FREE(ChunkPeriodSize);
+    FREE(ChunkData);
+    FREE(ChunkWork);
+    FREE(ChunkCode);
+    FREE(ChunkLength);
+    FREE(ChunkPos);
+    FREE(ChunkStart);
+    ChunkFill = 0;
+    ChunkBytes = 0;
+    NumChunks = 0;
+    MaxChunks = 0;
+    CachedChunk = -1;
+}
+
+//=============================================================================
+
+int output_writePeriod(char* buffer, INT4 size)
+//
+//  Input:   buffer = a filled period buffer
+//           size = number of bytes filled
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: writes a period's results to the binary file, or adds them to
+//           the chunk being filled when results are compressed.
+//
+{
+    if ( !CompressedOutput )
+    {
+        return ( fwrite(buffer, sizeof(char), size, Fout.file) == (size_t)size );
+    }
+    memcpy(ChunkData + ChunkBytes, buffer, size);
+    ChunkPeriodSize[ChunkFill] = size;
+    ChunkBytes += size;
+    ChunkFill++;
+    if ( ChunkFill == ChunkPeriods ) return output_writeChunk();
+    return TRUE;
+}
+
+//=============================================================================
+
+int output_writeChunk()
+//
+//  Input:   none
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: compresses the periods held in the chunk being filled and
+//           writes them to the binary file.
+//
+{
+    INT4  length;
+    INT4* p;
+
+    if ( ChunkFill == 0 ) return TRUE;
+
+    // --- make room for one more chunk
+    if ( NumChunks + 2 > MaxChunks )
+    {
+        MaxChunks *= 2;
+        p = (INT4 *) realloc(ChunkLength, MaxChunks * sizeof(INT4));
+        if ( p == NULL ) return FALSE;
+        ChunkLength = p;
+        p = (INT4 *) realloc(ChunkPos, MaxChunks * sizeof(INT4));
+        if ( p == NULL ) return FALSE;
+        ChunkPos = p;
+        p = (INT4 *) realloc(ChunkStart, MaxChunks * sizeof(INT4));
+        if ( p == NULL ) return FALSE;
+        ChunkStart = p;
+    }
+    if ( NumChunks == 0 )
+    {
+        ChunkPos[0] = OutputStartPos;
+        ChunkStart[0] = OutputStartPos;
+    }
+
+    // --- compress the chunk and write it
+    length = output_encodeChunk(ChunkPeriodSize, ChunkFill, ChunkBytes);
+    if ( fwrite(ChunkCode, sizeof(char), length, Fout.file) < (size_t)length )
+        return FALSE;
+    ChunkLength[NumChunks] = length;
+    ChunkPos[NumChunks+1] = ChunkPos[NumChunks] + length;
+    ChunkStart[NumChunks+1] = ChunkStart[NumChunks] + ChunkBytes;
+    NumChunks++;
+    ChunkFill = 0;
+    ChunkBytes = 0;
+    return TRUE;
+}
+
+//=============================================================================
+
+void output_saveChunkIndex()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: writes the last partly filled chunk of periods followed by the
+//           size of each compressed chunk to the binary file.
+//
+{
+    INT4 k;
+
+    if ( !output_writeChunk() )
+    {
+        report_writeErrorMsg(ERR_OUT_WRITE, "");
+        return;
+    }
+    fwrite(ChunkLength, sizeof(INT4), NumChunks, Fout.file);
+    k = ChunkPeriods;
+    fwrite(&k, sizeof(INT4), 1, Fout.file);
+    k = NumChunks;
+    fwrite(&k, sizeof(INT4), 1, Fout.file);
+    k = COMPRESSED_STAMP;
+    fwrite(&k, sizeof(INT4), 1, Fout.file);
+    CachedChunk = -1;
+}
+
+//=============================================================================
+
+INT4 output_encodeChunk(INT4* sizes, int n, INT4 bytes)
+//
+//  Input:   sizes = bytes of each period in the chunk
+//           n = number of periods in the chunk
+//           bytes = total bytes of the periods
+//  Output:  returns number of bytes of compressed chunk
+//  Purpose: compresses the periods held in ChunkData into ChunkCode.
+//
+{
+    int    i, j, m, run;
+    INT4   nWords = bytes / sizeof(INT4);
+    INT4   start = bytes;
+    INT4   length = 0;
+    unsigned int*  w = (unsigned int *)ChunkData;
+    unsigned char* in = (unsigned char *)ChunkWork;
+    unsigned char* out = (unsigned char *)ChunkCode;
+
+    // --- replace each word by its difference from the previous period
+    //     (working backwards so that previous periods are still intact)
+    for (i = n - 1; i > 0; i--)
+    {
+        start -= sizes[i];
+        m = MIN(sizes[i], sizes[i-1]) / sizeof(INT4);
+        for (j = 0; j < m; j++)
+        {
+            w[start/sizeof(INT4) + j] ^= w[(start - sizes[i-1])/sizeof(INT4) + j];
+        }
+    }
+
+    // --- group bytes by their place within a word
+    for (j = 0; j < nWords; j++)
+    {
+        for (i = 0; i < (int)sizeof(INT4); i++)
+            in[i*nWords + j] = ((unsigned char *)ChunkData)[j*sizeof(INT4) + i];
+    }
+
+    // --- run-length encode the bytes (runs of 3 to 128 repeated bytes
+    //     are coded as 257 - length & the byte, and up to 128 other bytes
+    //     as their count - 1 followed by the bytes)
+    i = 0;
+    while ( i < bytes )
+    {
+        run = 1;
+        while ( i + run < bytes && run < 128 && in[i+run] == in[i] ) run++;
+        if ( run >= 3 )
+        {
+            out[length++] = (unsigned char)(257 - run);
+            out[length++] = in[i];
+            i += run;
+            continue;
+        }
+        m = 0;
+        while ( i + m < bytes && m < 128 )
+        {
+            if ( i + m + 2 < bytes && in[i+m] == in[i+m+1] &&
+                 in[i+m] == in[i+m+2] ) break;
+            m++;
+        }
+        out[length++] = (unsigned char)(m - 1);
+        memcpy(out + length, in + i, m);
+        length += m;
+        i += m;
+    }
+    return length;
+}
+
+//=============================================================================
+
+int output_decodeChunk(INT4* sizes, int n, INT4 bytes, INT4 length)
+//
+//  Input:   sizes = bytes of each period in the chunk
+//           n = number of periods in the chunk
+//           bytes = total bytes of the periods
+//           length = bytes of compressed chunk held in ChunkCode
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: restores the periods of a compressed chunk into ChunkData.
+//
+{
+    int    i, j, m, c;
+    INT4   nWords = bytes / sizeof(INT4);
+    INT4   start = 0;
+    INT4   k = 0;
+    unsigned int*  w = (unsigned int *)ChunkData;
+    unsigned char* in = (unsigned char *)ChunkCode;
+    unsigned char* out = (unsigned char *)ChunkWork;
+
+    // --- undo the run-length encoding
+    i = 0;
+    while ( i < length && k < bytes )
+    {
+        c = in[i++];
+        if ( c > 128 )
+        {
+            m = 257 - c;
+            if ( i >= length || k + m > bytes ) return FALSE;
+            memset(out + k, in[i++], m);
+        }
+        else
+        {
+            m = c + 1;
+            if ( i + m > length || k + m > bytes ) return FALSE;
+            memcpy(out + k, in + i, m);
+            i += m;
+        }
+        k += m;
+    }
+    if ( k < bytes ) return FALSE;
+
+    // --- return bytes to their words
+    for (j = 0; j < nWords; j++)
+    {
+        for (i = 0; i < (int)sizeof(INT4); i++)
+            ((unsigned char *)ChunkData)[j*sizeof(INT4) + i] = out[i*nWords + j];
+    }
+
+    // --- add back the previous period to each word
+    for (i = 1; i < n; i++)
+    {
+        start += sizes[i-1];
+        m = MIN(sizes[i], sizes[i-1]) / sizeof(INT4);
+        for (j = 0; j < m; j++)
+        {
+            w[start/sizeof(INT4) + j] ^= w[(start - sizes[i-1])/sizeof(INT4) + j];
+        }
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+int output_loadChunk(int c)
+//
+//  Input:   c = index of a compressed chunk
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: reads a compressed chunk from the binary file and restores its
+//           periods into ChunkData.
+//
+{
+    int  i, n;
+    int  first = c * ChunkPeriods + 1;
+
+    if ( c == CachedChunk ) return TRUE;
+    CachedChunk = -1;
+    n = MIN(ChunkPeriods, Nperiods - first + 1);
+    for (i = 0; i < n; i++) ChunkPeriodSize[i] =
+        output_getPeriodPos(first + i + 1) - output_getPeriodPos(first + i);
+    fseek(Fout.file, ChunkPos[c], SEEK_SET);
+    if ( fread(ChunkCode, sizeof(char), ChunkLength[c], Fout.file)
+         < (size_t)ChunkLength[c] ) return FALSE;
+    if ( !output_decodeChunk(ChunkPeriodSize, n, ChunkStart[c+1] - ChunkStart[c],
+         ChunkLength[c]) ) return FALSE;
+    CachedChunk = c;
+    return TRUE;
+}
+
+//=============================================================================
+
+int output_readResults(INT4 bytePos, void* data, INT4 size)
+//
+//  Input:   bytePos = file position of results were they saved uncompressed
+//           size = number of bytes to read
+//  Output:  data = results read;
+//           returns TRUE if successful, FALSE if not
+//  Purpose: reads saved results from the binary file, restoring them from
+//           the compressed chunks that hold them when results are compressed.
+//
+{
+    int  c, lo, hi;
+    INT4 n;
+    char* p = (char *)data;
+
+    if ( !CompressedOutput || NumChunks == 0 )
+    {
+        fseek(Fout.file, bytePos, SEEK_SET);
+        return ( fread(data, sizeof(char), size, Fout.file) == (size_t)size );
+    }
+    while ( size > 0 )
+    {
+        // --- find the chunk holding bytePos
+        if ( bytePos < ChunkStart[0] || bytePos >= ChunkStart[NumChunks] )
+            return FALSE;
+        lo = 0;
+        hi = NumChunks - 1;
+        while ( lo < hi )
+        {
+            c = (lo + hi + 1) / 2;
+            if ( ChunkStart[c] <= bytePos ) lo = c;
+            else hi = c - 1;
+        }
+        if ( !output_loadChunk(lo) ) return FALSE;
+
+        // --- copy as much of the data as the chunk holds
+        n = MIN(size, ChunkStart[lo+1] - bytePos);
+        memcpy(p, ChunkData + (bytePos - ChunkStart[lo]), n);
+        p += n;
+        bytePos += n;
+        size -= n;
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+int output_openSummary()
+//
+//  Input:   none
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: allocates memory used to summarize the results saved in each
+//           reporting period.
+//
+{
+    output_closeSummary();
+    if ( !OutputSummary ) return TRUE;
+    SummaryCount = NumSubcatch * NsubcatchResults + NumNodes * NnodeResults +
+                   NumLinks * NlinkResults + MAX_SYS_RESULTS;
+    SummaryMin = (REAL4 *) calloc(SummaryCount, sizeof(REAL4));
+    SummaryMax = (REAL4 *) calloc(SummaryCount, sizeof(REAL4));
+    SummarySum = (REAL8 *) calloc(SummaryCount, sizeof(REAL8));
+    SummaryMaxPeriod = (INT4 *) calloc(SummaryCount, sizeof(INT4));
+    if ( !SummaryMin || !SummaryMax || !SummarySum || !SummaryMaxPeriod )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+void output_closeSummary()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the memory used to summarize results.
+//
+{
+    FREE(SummaryMin);
+    FREE(SummaryMax);
+    FREE(SummarySum);
+    FREE(SummaryMaxPeriod);
+    SummaryCount = 0;
+}
+
+//=============================================================================
+
+void output_updateSummary(REAL4* x)
+//
+//  Input:   x = all results of the current reporting period
+//  Output:  none
+//  Purpose: adds a reporting period's results to the summary of results.
+//
+{
+    INT4 i;
+
+    if ( SummaryCount == 0 ) return;
+    if ( Nperiods == 0 )
+    {
+        for (i = 0; i < SummaryCount; i++)
+        {
+            SummaryMin[i] = x[i];
+            SummaryMax[i] = x[i];
+            SummarySum[i] = x[i];
+        }
+        return;
+    }
+    for (i = 0; i < SummaryCount; i++)
+    {
+        if ( x[i] < SummaryMin[i] ) SummaryMin[i] = x[i];
+        if ( x[i] > SummaryMax[i] )
+        {
+            SummaryMax[i] = x[i];
+            SummaryMaxPeriod[i] = Nperiods;
+        }
+        SummarySum[i] += x[i];
+    }
+}
+
+//=============================================================================
+
+void output_saveSummary()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: writes the summary of the results saved in all reporting
+//           periods to the binary file.
+//
+{
+    INT4  i, k;
+    REAL4 x[3];
+
+    if ( SummaryCount == 0 || Nperiods == 0 ) return;
+    fseek(Fout.file, 0, SEEK_END);
+    for (i = 0; i < SummaryCount; i++)
+    {
+        x[0] = SummaryMin[i];
+        x[1] = SummaryMax[i];
+        x[2] = (REAL4)(SummarySum[i] / Nperiods);
+        fwrite(x, sizeof(REAL4), 3, Fout.file);
+        fwrite(&SummaryMaxPeriod[i], sizeof(INT4), 1, Fout.file);
+    }
+    k = SummaryCount;
+    fwrite(&k, sizeof(INT4), 1, Fout.file);
+    k = SUMMARY_STAMP;
+    if ( fwrite(&k, sizeof(INT4), 1, Fout.file) < 1 )
+    {
+        report_writeErrorMsg(ERR_OUT_WRITE, "");
+    }
+}
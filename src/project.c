@@ -276,6 +276,7 @@ void project_close()
 //  Purpose: closes a SWMM project.
 //
 {
+    climate_closeFile();
     deleteObjects();
     deleteHashTables();
 }
@@ -566,6 +567,10 @@ int project_readOption(char* s1, char* s2)
       case IGNORE_ROUTING:
       case IGNORE_QUALITY:
       case IGNORE_RDII:                                                        //(5.1.004)
+      case TSERIES_CACHE:
+      case TRANSPOSED_OUTPUT:
+      case COMPRESSED_OUTPUT:
+      case OUTPUT_SUMMARY:
         m = findmatch(s2, NoYesWords);
         if ( m < 0 ) return error_setInpError(ERR_KEYWORD, s2);
         switch ( k )
@@ -579,6 +584,10 @@ int project_readOption(char* s1, char* s2)
           case IGNORE_ROUTING:    IgnoreRouting   = m;  break;
           case IGNORE_QUALITY:    IgnoreQuality   = m;  break;
           case IGNORE_RDII:       IgnoreRDII      = m;  break;                 //(5.1.004)
+          case TSERIES_CACHE:     TseriesCache    = m;  break;
+          case TRANSPOSED_OUTPUT: TransposedOutput = m; break;
+          case COMPRESSED_OUTPUT: CompressedOutput = m; break;
+          case OUTPUT_SUMMARY:    OutputSummary   = m;  break;
         }
         break;
 
@@ -715,6 +724,18 @@ int project_readOption(char* s1, char* s2)
         sstrncpy(TempDir, s2, MAXFNAME);
         break;
 
+      // --- shared memory that live results are published to
+      case RESULTS_STREAM:
+        sstrncpy(StreamName, s2, MAXFNAME);
+        break;
+
+      // --- number of reporting periods held in live results stream
+      case STREAM_PERIODS:
+        m = atoi(s2);
+        if ( m <= 0 ) return error_setInpError(ERR_NUMBER, s2);
+        StreamPeriods = m;
+        break;
+
     }
     return 0;
 }
@@ -768,10 +789,12 @@ void setDefaults()
    // Project title & temp. file path
    for (i = 0; i < MAXTITLE; i++) strcpy(Title[i], "");
    strcpy(TempDir, "");
+   strcpy(StreamName, "");
 
    // Interface files
    Frain.mode      = SCRATCH_FILE;     // Use scratch rainfall file
    Fclimate.mode   = NO_FILE; 
+   Fclimcache.mode = NO_FILE;
    Frunoff.mode    = NO_FILE;
    Frdii.mode      = NO_FILE;
    Fhotstart1.mode = NO_FILE;
@@ -780,6 +803,7 @@ void setDefaults()
    Foutflows.mode  = NO_FILE;
    Frain.file      = NULL;
    Fclimate.file   = NULL;
+   Fclimcache.file = NULL;
    Frunoff.file    = NULL;
    Frdii.file      = NULL;
    Fhotstart1.file = NULL;
@@ -810,6 +834,10 @@ void setDefaults()
    IgnoreGwater    = FALSE;            // Analyze groundwater 
    IgnoreRouting   = FALSE;            // Analyze flow routing
    IgnoreQuality   = FALSE;            // Analyze water quality
+   TseriesCache    = FALSE;            // Read time series files as text
+   TransposedOutput = FALSE;           // Save results by period only
+   CompressedOutput = FALSE;           // Save results uncompressed
+   OutputSummary   = FALSE;            // Save no summary of results
    WetStep         = 300;              // Runoff wet time step (secs)
    DryStep         = 3600;             // Runoff dry time step (secs)
    RouteStep       = 300.0;            // Routing time step (secs)
@@ -821,6 +849,7 @@ void setDefaults()
    SysFlowTol      = 0.05;             // System flow tolerance for steady state
    LatFlowTol      = 0.05;             // Lateral flow tolerance for steady state
    NumThreads      = 0;                // Number of parallel threads to use
+   StreamPeriods   = 64;               // Periods held in live results stream
    NumEvents       = 0;                // Number of detailed routing events    //(5.1.011)
 
    // Deprecated options
@@ -1067,6 +1096,7 @@ void createObjects()
     {
         Gage[j].tSeries = -1;
         strcpy(Gage[j].fname, "");
+        Gage[j].grid = NULL;
     }
 
     // --- initialize subcatchment properties
@@ -1080,6 +1110,10 @@ void createObjects()
         Subcatch[j].gwDeepFlowExpr = NULL;                                     //(5.1.007)
         Subcatch[j].snowpack    = NULL;
         Subcatch[j].lidArea     = 0.0;
+        Subcatch[j].rainCells.count = 0;
+        Subcatch[j].rainCells.size  = 0;
+        Subcatch[j].rainCells.cell  = NULL;
+        Subcatch[j].rainCells.weight = NULL;
         for (k = 0; k < Nobjects[POLLUT]; k++)
         {
             Subcatch[j].initBuildup[k] = 0.0;
@@ -1094,6 +1128,7 @@ void createObjects()
 
     // --- initialize storage node exfiltration                                //(5.1.007)
     for (j = 0; j < Nnodes[STORAGE]; j++) Storage[j].exfil = NULL;             //(5.1.007)
+    for (j = 0; j < Nnodes[STORAGE]; j++) Storage[j].aVolume = NULL;
 
     // --- initialize link properties
     for (j = 0; j < Nobjects[LINK]; j++)
@@ -1143,6 +1178,8 @@ void deleteObjects()
         FREE(Subcatch[j].groundwater);
         gwater_deleteFlowExpression(j);
         FREE(Subcatch[j].snowpack);
+        FREE(Subcatch[j].rainCells.cell);
+        FREE(Subcatch[j].rainCells.weight);
     }
 
     // --- free memory for buildup/washoff functions
@@ -1187,6 +1224,7 @@ void deleteObjects()
             FREE(Storage[j].exfil->bankExfil);
             FREE(Storage[j].exfil);
         }
+        FREE(Storage[j].aVolume);
     }
 ////
 
@@ -1207,6 +1245,7 @@ void deleteObjects()
     // --- delete table entries for curves and time series
     if ( Tseries ) for (j = 0; j < Nobjects[TSERIES]; j++)
         table_deleteEntries(&Tseries[j]);
+    table_deleteSharedData();
     if ( Curve ) for (j = 0; j < Nobjects[CURVE]; j++)
         table_deleteEntries(&Curve[j]);
 
@@ -1219,6 +1258,10 @@ void deleteObjects()
     // --- delete LIDs
     lid_delete();
 
+    // --- delete output profiles & tolerances
+    output_deleteProfiles();
+    output_deleteTolerances();
+
     // --- now free each major category of object
     FREE(Gage);
     FREE(Subcatch);
@@ -39,6 +39,27 @@
 //         Date/time for start of period (8-byte double)
 //         Rain depth (inches) (4-byte float)
 //
+//   A SAVE'd rainfall interface file ends with a trailer that identifies
+//   the rain data files it was made from, so that it can be re-used in
+//   place of re-reading those files while they remain unchanged:
+//     For each rain gage:
+//       name of gage's rain data file (MAXFNAME+1 bytes)
+//       recording station ID (MAXMSG+1 bytes)
+//       size & last modification time of data file (2 8-byte doubles)
+//       start & end dates of record requested (2 8-byte doubles)
+//       rain type, recording interval & rain units of gage (3 4-byte ints)
+//       recording interval found in data file (4-byte int)
+//       first & last dates of record read (2 8-byte doubles)
+//       periods with rain, missing & malfunctioning (3 4-byte ints)
+//     Number of rain gages in trailer (4-byte int)
+//     Starting byte of trailer (4-byte int)
+//     Trailer stamp ("SWMM5-RKEY") (10 bytes)
+//
+//   When built with OpenMP, the data files of different gages are read
+//   concurrently, each thread placing a gage's records in its own memory
+//   buffer. The buffers are then written to the interface file in gage
+//   order so that its contents do not depend on the number of threads.
+//
 //   Release 5.1.010:
 //   - Modified error message for records out of sequence in std. format file.
 //
@@ -49,7 +70,11 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include "headers.h"
+#if defined(_OPENMP)
+  #include <omp.h>
+#endif
 
 //-----------------------------------------------------------------------------
 //  Constants
@@ -60,23 +85,54 @@ enum RainFileFormat {UNKNOWN_FORMAT, NWS_TAPE, NWS_SPACE_DELIMITED,
 enum ConditionCodes {NO_CONDITION, ACCUMULATED_PERIOD, DELETED_PERIOD,
                      MISSING_PERIOD};
 
+//-----------------------------------------------------------------------------
+//  Data Structures
+//-----------------------------------------------------------------------------
+typedef struct                         // identifies a gage's rain data
+{
+    char       fname[MAXFNAME+1];      // name of rain data file
+    char       staID[MAXMSG+1];        // recording station ID
+    double     fileSize;               // size of rain data file (bytes)
+    double     fileTime;               // last modification time of file
+    DateTime   startFileDate;          // start of record requested
+    DateTime   endFileDate;            // end of record requested
+    int        rainType;               // rain type of gage
+    int        rainInterval;           // recording interval of gage (sec)
+    int        rainUnits;              // rain depth units of gage
+    int        fileInterval;           // recording interval in file (sec)
+    TRainStats stats;                  // summary of rain data read
+}  TRainKey;
+
 //-----------------------------------------------------------------------------
 //  Shared variables
 //-----------------------------------------------------------------------------
-TRainStats RainStats;                  // see objects.h for definition
-int        Condition;                  // rainfall condition code
-int        TimeOffset;                 // time offset of rainfall reading (sec)
-int        DataOffset;                 // start of data on line of input
-int        ValueOffset;                // start of rain value on input line
-int        RainType;                   // rain measurement type code
-int        Interval;                   // rain measurement interval (sec)
-double     UnitsFactor;                // units conversion factor
-float      RainAccum;                  // rainfall depth accumulation
-char       *StationID;                 // station ID appearing in rain file
-DateTime   AccumStartDate;             // date when accumulation begins
-DateTime   PreviousDate;               // date of previous rainfall record
-int        GageIndex;                  // index of rain gage analyzed
-int        hasStationName;             // true if data contains station name
+//  (each thread reading a rain data file keeps its own copy)
+static TRainStats RainStats;           // see objects.h for definition
+static int        Condition;           // rainfall condition code
+static int        TimeOffset;          // time offset of rainfall reading (sec)
+static int        DataOffset;          // start of data on line of input
+static int        ValueOffset;         // start of rain value on input line
+static int        RainType;            // rain measurement type code
+static int        Interval;            // rain measurement interval (sec)
+static double     UnitsFactor;         // units conversion factor
+static float      RainAccum;           // rainfall depth accumulation
+static char       *StationID;          // station ID appearing in rain file
+static DateTime   AccumStartDate;      // date when accumulation begins
+static DateTime   PreviousDate;        // date of previous rainfall record
+static int        hasStationName;      // true if data contains station name
+static char*      RainBuf;             // rain records read for a gage
+static size_t     RainBufLen;          // bytes used in RainBuf
+static size_t     RainBufSize;         // bytes allocated to RainBuf
+static int        RainError;           // error code from reading a gage
+static char       RainErrLine[MAXLINE];// data line that caused RainError
+#pragma omp threadprivate(RainStats, Condition, TimeOffset, DataOffset, \
+                          ValueOffset, RainType, Interval, UnitsFactor, \
+                          RainAccum, StationID, AccumStartDate, PreviousDate, \
+                          hasStationName, RainBuf, RainBufLen, RainBufSize, \
+                          RainError, RainErrLine)
+
+static TRainKey* RainKeys;             // identifiers of gages' rain data
+static int       NumRainKeys;          // number of gages with rain data
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
@@ -88,10 +144,17 @@ int        hasStationName;             // true if data contains station name
 //  Local functions
 //-----------------------------------------------------------------------------
 static void createRainFile(int count);
+static int  createRainKeys(int count);
+static int  rainFileIsCurrent(int count);
+static void readRainKey(TRainKey* key, FILE* f);
+static void writeRainKey(TRainKey* key, FILE* f);
+static void writeRainKeys(void);
 static int  rainFileConflict(int i);
 static void initRainFile(void);
 static int  findGageInFile(int i, int kount);
 static int  addGageToRainFile(int i);
+static void writeGageToRainFile(int i, int count, int *filePos1,
+            int *filePos2);
 static int  findFileFormat(FILE *f, int i, int *hdrLines);
 static int  findNWSOnlineFormat(FILE *f, char *line);
 static void readFile(FILE *f, int fileFormat, int hdrLines, DateTime day1,
@@ -105,6 +168,7 @@ static int  readStdLine(char *line, DateTime day1, DateTime day2);
 static void saveAccumRainfall(DateTime date1, int hour, int minute, long v);
 static void saveRainfall(DateTime date1, int hour, int minute, float x,
             char isMissing);
+static void bufferRainRecord(DateTime date, float x);
 static void setCondition(char flag);
 static int  getNWSInterval(char *elemType);
 static int  parseStdLine(char *line, int *year, int *month, int *day,
@@ -116,11 +180,13 @@ void  rain_open(void)
 //
 //  Input:   none
 //  Output:  none
-//  Purpose: opens binary rain interface file and RDII processor.
+//  Purpose: opens binary rain interface file, rain grid files and RDII
+//           processor.
 //
 {
     int i;
     int count;
+    int isCurrent = FALSE;
 
     // --- see how many gages get their data from a file
     count = 0;
@@ -129,12 +195,20 @@ void  rain_open(void)
         if ( Gage[i].dataSource == RAIN_FILE ) count++;
     }
     Frain.file = NULL;
-    if ( count == 0 )
+    RainKeys = NULL;
+    NumRainKeys = 0;
+
+    // --- open the rain grid files of gages that use them
+    for (i = 0; i < Nobjects[GAGE]; i++)
     {
-        Frain.mode = NO_FILE;
+        if ( Gage[i].dataSource == RAIN_GRID && !raingrid_open(i) ) return;
     }
 
     // --- see what kind of rain interface file to open
+    if ( count == 0 )
+    {
+        Frain.mode = NO_FILE;
+    }
     else switch ( Frain.mode )
     {
       case SCRATCH_FILE:
@@ -155,6 +229,14 @@ void  rain_open(void)
         break;
 
       case SAVE_FILE:
+        // --- re-use an existing file made from the same rain data files
+        if ( !createRainKeys(count) ) return;
+        if ( (Frain.file = fopen(Frain.name, "r+b")) != NULL )
+        {
+            isCurrent = rainFileIsCurrent(count);
+            if ( isCurrent ) break;
+            fclose(Frain.file);
+        }
         if ( (Frain.file = fopen(Frain.name, "w+b")) == NULL)
         {
             report_writeErrorMsg(ERR_RAIN_FILE_OPEN, Frain.name);
@@ -164,7 +246,7 @@ void  rain_open(void)
     }
 
     // --- create new rain file if required
-    if ( Frain.mode == SCRATCH_FILE || Frain.mode == SAVE_FILE )
+    if ( Frain.mode == SCRATCH_FILE || (Frain.mode == SAVE_FILE && !isCurrent) )
     {
         createRainFile(count);
     }
@@ -182,15 +264,20 @@ void rain_close(void)
 //
 //  Input:   none
 //  Output:  none
-//  Purpose: closes rain interface file and RDII processor.
+//  Purpose: closes rain interface file, rain grid files and RDII processor.
 //
 {
+    int i;
+
     if ( Frain.file )
     {
         fclose(Frain.file);
         if ( Frain.mode == SCRATCH_FILE ) remove(Frain.name);
     }
     Frain.file = NULL;
+    FREE(RainKeys);
+    NumRainKeys = 0;
+    for (i = 0; i < Nobjects[GAGE]; i++) raingrid_close(i);
     rdii_closeRdii();
 }
 
@@ -207,8 +294,6 @@ void createRainFile(int count)
     int   kount = count;               // number of gages in data file
     int   filePos1;                    // starting byte of gage's header data
     int   filePos2;                    // starting byte of gage's rain data
-    int   filePos3;                    // starting byte of next gage's data
-    int   interval;                    // recording interval (sec)
     int   dummy = -1;
     char  staID[MAXMSG+1];             // gage's ID name
     char  fileStamp[] = "SWMM5-RAIN";
@@ -232,33 +317,32 @@ void createRainFile(int count)
     }
     filePos2 = ftell(Frain.file);
 
-    // --- loop through project's  rain gages,
-    //     looking for ones using rain files
+    // --- loop through project's rain gages, reading the data files
+    //     of those that use them in parallel and then adding each
+    //     gage's data to the rain file in gage order
+#pragma omp parallel num_threads(NumThreads)
+{
+    #pragma omp for ordered schedule(dynamic)
     for ( i = 0; i < Nobjects[GAGE]; i++ )
     {
-        if ( ErrorCode || Gage[i].dataSource != RAIN_FILE ) continue;
-        if ( rainFileConflict(i) ) break;
-
-        // --- position rain file to where data for gage will begin
-        fseek(Frain.file, filePos2, SEEK_SET);
-
-        // --- add gage's data to rain file
-        if ( addGageToRainFile(i) )
+        if ( Gage[i].dataSource != RAIN_FILE ) continue;
+        addGageToRainFile(i);
+        #pragma omp ordered
         {
-            // --- write header records for gage to beginning of rain file
-            filePos3 = ftell(Frain.file);
-            fseek(Frain.file, filePos1, SEEK_SET);
-            sstrncpy(staID, Gage[i].staID, MAXMSG);
-            interval = Interval;
-            fwrite(staID,      sizeof(char), MAXMSG+1, Frain.file);
-            fwrite(&interval,  sizeof(int), 1, Frain.file);
-            fwrite(&filePos2,  sizeof(int), 1, Frain.file);
-            fwrite(&filePos3,  sizeof(int), 1, Frain.file);
-            filePos1 = ftell(Frain.file);
-            filePos2 = filePos3;
-            report_writeRainStats(i, &RainStats);
+            if ( !ErrorCode && !rainFileConflict(i) )
+                writeGageToRainFile(i, count, &filePos1, &filePos2);
         }
     }
+    FREE(RainBuf);
+    RainBufSize = 0;
+}
+
+    // --- identify the rain data files used at the end of a saved file
+    if ( !ErrorCode && RainKeys )
+    {
+        fseek(Frain.file, filePos2, SEEK_SET);
+        writeRainKeys();
+    }
 
     // --- if there was an error condition, then delete newly created file
     if ( ErrorCode )
@@ -271,6 +355,180 @@ void createRainFile(int count)
 
 //=============================================================================
 
+int createRainKeys(int count)
+//
+//  Input:   count = number of gages that use rain files
+//  Output:  returns 1 if successful, 0 if not
+//  Purpose: identifies the rain data read by each gage that uses a rain file.
+//
+{
+    int i, k = 0;
+    TRainKey* key;
+
+    RainKeys = (TRainKey *) calloc(count, sizeof(TRainKey));
+    if ( RainKeys == NULL )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return 0;
+    }
+    for ( i = 0; i < Nobjects[GAGE]; i++ )
+    {
+        if ( Gage[i].dataSource != RAIN_FILE ) continue;
+        key = &RainKeys[k++];
+        sstrncpy(key->fname, Gage[i].fname, MAXFNAME);
+        sstrncpy(key->staID, Gage[i].staID, MAXMSG);
+        getFileStamp(Gage[i].fname, &key->fileSize, &key->fileTime);
+        key->startFileDate = Gage[i].startFileDate;
+        key->endFileDate = Gage[i].endFileDate;
+        key->rainType = Gage[i].rainType;
+        key->rainInterval = Gage[i].rainInterval;
+        key->rainUnits = Gage[i].rainUnits;
+    }
+    return 1;
+}
+
+//=============================================================================
+
+int rainFileIsCurrent(int count)
+//
+//  Input:   count = number of gages that use rain files
+//  Output:  returns TRUE if the open rain interface file was made from
+//           the current versions of the gages' rain data files
+//  Purpose: checks if an existing rain interface file can be re-used.
+//
+{
+    char     fileStamp[] = "SWMM5-RKEY";
+    char     fStamp[] = "SWMM5-RKEY";
+    int      i, k;
+    int      kount, filePos;
+    int      trailerSize = 2*sizeof(int) + strlen(fileStamp);
+    TRainKey key;
+
+    // --- read the file's trailer stamp, gage count & position
+    if ( fseek(Frain.file, -trailerSize, SEEK_END) != 0 ) return FALSE;
+    if ( fread(&kount, sizeof(int), 1, Frain.file) < 1 ||
+         fread(&filePos, sizeof(int), 1, Frain.file) < 1 ||
+         fread(fStamp, sizeof(char), strlen(fileStamp), Frain.file) <
+             strlen(fileStamp) ) return FALSE;
+    if ( strcmp(fStamp, fileStamp) != 0 || kount != count ) return FALSE;
+
+    // --- compare each gage's key with the current one
+    fseek(Frain.file, filePos, SEEK_SET);
+    for ( k = 0; k < count; k++ )
+    {
+        readRainKey(&key, Frain.file);
+        if ( RainKeys[k].fileSize < 0.0 ||
+             strcmp(key.fname, RainKeys[k].fname) != 0 ||
+             strcmp(key.staID, RainKeys[k].staID) != 0 ||
+             key.fileSize != RainKeys[k].fileSize ||
+             key.fileTime != RainKeys[k].fileTime ||
+             key.startFileDate != RainKeys[k].startFileDate ||
+             key.endFileDate != RainKeys[k].endFileDate ||
+             key.rainType != RainKeys[k].rainType ||
+             key.rainInterval != RainKeys[k].rainInterval ||
+             key.rainUnits != RainKeys[k].rainUnits ) return FALSE;
+        RainKeys[k].fileInterval = key.fileInterval;
+        RainKeys[k].stats = key.stats;
+    }
+    NumRainKeys = count;
+
+    // --- report the summary of the rain data stored in the file
+    report_writeRainStats(-1, &RainStats);
+    k = 0;
+    for ( i = 0; i < Nobjects[GAGE]; i++ )
+    {
+        if ( Gage[i].dataSource != RAIN_FILE ) continue;
+        Gage[i].rainInterval = RainKeys[k].fileInterval;
+        report_writeRainStats(i, &RainKeys[k].stats);
+        k++;
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+void writeRainKeys()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: writes the trailer that identifies the rain data files used
+//           to the end of the rain interface file.
+//
+{
+    char fileStamp[] = "SWMM5-RKEY";
+    int  k;
+    int  filePos = ftell(Frain.file);
+
+    for ( k = 0; k < NumRainKeys; k++ ) writeRainKey(&RainKeys[k], Frain.file);
+    fwrite(&NumRainKeys, sizeof(int), 1, Frain.file);
+    fwrite(&filePos, sizeof(int), 1, Frain.file);
+    fwrite(fileStamp, sizeof(char), strlen(fileStamp), Frain.file);
+}
+
+//=============================================================================
+
+void writeRainKey(TRainKey* key, FILE* f)
+//
+//  Input:   key = identifier of a gage's rain data
+//           f = rain interface file
+//  Output:  none
+//  Purpose: writes a gage's rain data identifier to the interface file.
+//
+{
+    int n[3];
+
+    fwrite(key->fname, sizeof(char), MAXFNAME+1, f);
+    fwrite(key->staID, sizeof(char), MAXMSG+1, f);
+    fwrite(&key->fileSize, sizeof(double), 1, f);
+    fwrite(&key->fileTime, sizeof(double), 1, f);
+    fwrite(&key->startFileDate, sizeof(DateTime), 1, f);
+    fwrite(&key->endFileDate, sizeof(DateTime), 1, f);
+    fwrite(&key->rainType, sizeof(int), 1, f);
+    fwrite(&key->rainInterval, sizeof(int), 1, f);
+    fwrite(&key->rainUnits, sizeof(int), 1, f);
+    fwrite(&key->fileInterval, sizeof(int), 1, f);
+    fwrite(&key->stats.startDate, sizeof(DateTime), 1, f);
+    fwrite(&key->stats.endDate, sizeof(DateTime), 1, f);
+    n[0] = (int)key->stats.periodsRain;
+    n[1] = (int)key->stats.periodsMissing;
+    n[2] = (int)key->stats.periodsMalfunc;
+    fwrite(n, sizeof(int), 3, f);
+}
+
+//=============================================================================
+
+void readRainKey(TRainKey* key, FILE* f)
+//
+//  Input:   f = rain interface file
+//  Output:  key = identifier of a gage's rain data
+//  Purpose: reads a gage's rain data identifier from the interface file.
+//
+{
+    int n[3] = {0, 0, 0};
+
+    memset(key, 0, sizeof(TRainKey));
+    fread(key->fname, sizeof(char), MAXFNAME+1, f);
+    fread(key->staID, sizeof(char), MAXMSG+1, f);
+    key->fname[MAXFNAME] = '\0';
+    key->staID[MAXMSG] = '\0';
+    fread(&key->fileSize, sizeof(double), 1, f);
+    fread(&key->fileTime, sizeof(double), 1, f);
+    fread(&key->startFileDate, sizeof(DateTime), 1, f);
+    fread(&key->endFileDate, sizeof(DateTime), 1, f);
+    fread(&key->rainType, sizeof(int), 1, f);
+    fread(&key->rainInterval, sizeof(int), 1, f);
+    fread(&key->rainUnits, sizeof(int), 1, f);
+    fread(&key->fileInterval, sizeof(int), 1, f);
+    fread(&key->stats.startDate, sizeof(DateTime), 1, f);
+    fread(&key->stats.endDate, sizeof(DateTime), 1, f);
+    fread(n, sizeof(int), 3, f);
+    key->stats.periodsRain = n[0];
+    key->stats.periodsMissing = n[1];
+    key->stats.periodsMalfunc = n[2];
+}
+
+//=============================================================================
+
 int rainFileConflict(int i)
 //
 //  Input:   i = rain gage index
@@ -299,7 +557,11 @@ int addGageToRainFile(int i)
 //
 //  Input:   i = rain gage index
 //  Output:  returns 1 if successful, 0 if not
-//  Purpose: adds a gage's rainfall record to rain interface file
+//  Purpose: reads a gage's rainfall record into the calling thread's
+//           rain data buffer.
+//
+//  Note: errors are saved in RainError rather than reported here so that
+//        they are reported in gage order by writeGageToRainFile.
 //
 {
     FILE* f;                           // pointer to rain file
@@ -308,32 +570,85 @@ int addGageToRainFile(int i)
 
     // --- let StationID point to NULL
     StationID = NULL;
+    RainBufLen = 0;
+    RainError = 0;
 
     // --- check that rain file exists
     if ( (f = fopen(Gage[i].fname, "rt")) == NULL )
-        report_writeErrorMsg(ERR_RAIN_FILE_DATA, Gage[i].fname);
+        RainError = ERR_RAIN_FILE_DATA;
     else
     {
         fileFormat = findFileFormat(f, i, &hdrLines);
         if ( fileFormat == UNKNOWN_FORMAT )
         {
-            report_writeErrorMsg(ERR_RAIN_FILE_FORMAT, Gage[i].fname);
+            RainError = ERR_RAIN_FILE_FORMAT;
         }
         else
         {
-            GageIndex = i;
             readFile(f, fileFormat, hdrLines, Gage[i].startFileDate,
                      Gage[i].endFileDate);
         }
         fclose(f);
     }
-    if ( ErrorCode ) return 0;
+    if ( RainError ) return 0;
     else
     return 1;
 }
 
 //=============================================================================
 
+void writeGageToRainFile(int i, int count, int *filePos1, int *filePos2)
+//
+//  Input:   i = rain gage index
+//           count = number of gages in rain interface file
+//           filePos1 = starting byte of gage's header data
+//           filePos2 = starting byte of gage's rain data
+//  Output:  filePos1 = starting byte of next gage's header data
+//           filePos2 = starting byte of next gage's rain data
+//  Purpose: writes the rainfall record read for a gage by addGageToRainFile
+//           to the rain interface file.
+//
+{
+    int   filePos3;                    // starting byte of next gage's data
+    int   interval;                    // recording interval (sec)
+    char  staID[MAXMSG+1];             // gage's ID name
+
+    // --- report any error found when reading the gage's data file
+    if ( RainError )
+    {
+        report_writeErrorMsg(RainError, Gage[i].fname);
+        if ( RainError == ERR_RAIN_FILE_SEQUENCE ) report_writeLine(RainErrLine);
+        return;
+    }
+
+    // --- add gage's data to rain file
+    fseek(Frain.file, *filePos2, SEEK_SET);
+    if ( RainBufLen > 0 ) fwrite(RainBuf, 1, RainBufLen, Frain.file);
+
+    // --- write header records for gage to beginning of rain file
+    filePos3 = ftell(Frain.file);
+    fseek(Frain.file, *filePos1, SEEK_SET);
+    sstrncpy(staID, Gage[i].staID, MAXMSG);
+    interval = Interval;
+    fwrite(staID,      sizeof(char), MAXMSG+1, Frain.file);
+    fwrite(&interval,  sizeof(int), 1, Frain.file);
+    fwrite(filePos2,   sizeof(int), 1, Frain.file);
+    fwrite(&filePos3,  sizeof(int), 1, Frain.file);
+    *filePos1 = ftell(Frain.file);
+    *filePos2 = filePos3;
+    report_writeRainStats(i, &RainStats);
+
+    // --- record what was read for the file's trailer
+    if ( RainKeys && NumRainKeys < count )
+    {
+        RainKeys[NumRainKeys].fileInterval = Interval;
+        RainKeys[NumRainKeys].stats = RainStats;
+        NumRainKeys++;
+    }
+}
+
+//=============================================================================
+
 void initRainFile(void)
 //
 //  Input:   none
@@ -704,7 +1019,7 @@ void readFile(FILE *f, int fileFormat, int hdrLines, DateTime day1,
            n = -1;
            break;
        }
-       if ( n < 0 ) break;
+       if ( n < 0 || RainError ) break;
     }
 }
 
@@ -886,6 +1201,39 @@ int readNwsOnlineValue(char* s, long* v, char* flag)
 
 //=============================================================================
 
+void bufferRainRecord(DateTime date, float x)
+//
+//  Input:   date = date/time of start of rainfall period
+//           x = rainfall depth (inches)
+//  Output:  none
+//  Purpose: appends a rainfall record to the current thread's rain data
+//           buffer using the same layout as the rain interface file.
+//
+{
+    size_t recdSize = sizeof(DateTime) + sizeof(float);
+    size_t newSize;
+    char*  newBuf;
+
+    if ( RainError ) return;
+    if ( RainBufLen + recdSize > RainBufSize )
+    {
+        newSize = (RainBufSize == 0) ? 1024 * recdSize : 2 * RainBufSize;
+        newBuf = (char *) realloc(RainBuf, newSize);
+        if ( newBuf == NULL )
+        {
+            RainError = ERR_MEMORY;
+            return;
+        }
+        RainBuf = newBuf;
+        RainBufSize = newSize;
+    }
+    memcpy(RainBuf + RainBufLen, &date, sizeof(DateTime));
+    memcpy(RainBuf + RainBufLen + sizeof(DateTime), &x, sizeof(float));
+    RainBufLen += recdSize;
+}
+
+//=============================================================================
+
 void  setCondition(char flag)
 {
     switch ( flag )
@@ -1017,8 +1365,8 @@ int readStdLine(char *line, DateTime day1, DateTime day2)
     date2 = date1 + datetime_encodeTime(hour, minute, 0);
     if ( date2 <= PreviousDate )
     {
-        report_writeErrorMsg(ERR_RAIN_FILE_SEQUENCE, Gage[GageIndex].fname);   //(5.1.010)
-        report_writeLine(line);
+        RainError = ERR_RAIN_FILE_SEQUENCE;                                    //(5.1.010)
+        sstrncpy(RainErrLine, line, MAXLINE-1);
         return -1;
     }
     PreviousDate = date2;
@@ -1062,12 +1410,36 @@ int parseStdLine(char *line, int *year, int *month, int *day, int *hour,
 //  Purpose: parses a line of data from a standard rainfall data file.
 //
 {
-    int n;
-    char token[MAXLINE];
+    int   i, n;
+    long  v[5];
+    char  token[MAXLINE];
+    char* s = line;
+    char* end;
+
+    // --- station ID
+    while ( isspace((unsigned char)*s) ) s++;
+    for ( n = 0; *s && !isspace((unsigned char)*s); n++ ) token[n] = *s++;
+    if ( n == 0 ) return 0;
+    token[n] = '\0';
+
+    // --- year, month, day, hour & minute
+    for ( i = 0; i < 5; i++ )
+    {
+        v[i] = strtol(s, &end, 10);
+        if ( end == s ) return 0;
+        s = end;
+    }
+
+    // --- rainfall value
+    *value = strtof(s, &end);
+    if ( end == s ) return 0;
 
-    n = sscanf(line, "%s %d %d %d %d %d %f", token, year, month, day, hour, minute, value);
-    if ( n < 7 ) return 0;
     if ( StationID != NULL && !strcomp(token, StationID) ) return 0;
+    *year = (int)v[0];
+    *month = (int)v[1];
+    *day = (int)v[2];
+    *hour = (int)v[3];
+    *minute = (int)v[4];
     return 1;
 }
 
@@ -1114,8 +1486,7 @@ void saveAccumRainfall(DateTime date1, int hour, int minute, long v)
         if ( RainStats.startDate == NO_DATE ) RainStats.startDate = date2;
         for (j = 0; j < n; j++)
         {
-            fwrite(&date2, sizeof(DateTime), 1, Frain.file);
-            fwrite(&x, sizeof(float), 1, Frain.file);
+            bufferRainRecord(date2, x);
             date2 = datetime_addSeconds(date2, Interval);
             RainStats.endDate = date2;
         }
@@ -1152,9 +1523,8 @@ void saveRainfall(DateTime date1, int hour, int minute, float x, char isMissing)
         seconds = 3600*hour + 60*minute - TimeOffset;
         date2 = datetime_addSeconds(date1, seconds);
 
-        // --- write date & value (in inches) to interface file
-        fwrite(&date2, sizeof(DateTime), 1, Frain.file);
-        fwrite(&x, sizeof(float), 1, Frain.file);
+        // --- save date & value (in inches) for the interface file
+        bufferRainRecord(date2, x);
 
         // --- update actual start & end of record dates
         if ( RainStats.startDate == NO_DATE ) RainStats.startDate = date2;
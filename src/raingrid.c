@@ -0,0 +1,304 @@
+//-----------------------------------------------------------------------------
+//   raingrid.c
+//
+//   Project:  EPA SWMM5
+//   Version:  5.1
+//
+//   Gridded rainfall functions.
+//
+//   A rain gage whose data source is a rain grid file supplies a separate
+//   rainfall value for each cell of a grid (such as one derived from radar
+//   images). Each subcatchment that uses the gage receives the area-weighted
+//   rainfall of the grid cells listed for it in the [RAINCELLS] section of
+//   the input file, while the gage itself records the average rainfall over
+//   all cells.
+//
+//   The layout of a binary rain grid file is:
+//     File stamp ("SWMM5-GRID") (10 bytes)
+//     Number of grid cells (4-byte int)
+//     Number of frames (4-byte int)
+//     For each frame (in chronological order):
+//       Date/time for start of frame's recording period (8-byte double)
+//       Number of cells with non-zero rainfall (4-byte int)
+//       For each such cell (in order of increasing cell index):
+//         number of zero rainfall cells preceding it (4-byte int)
+//         rainfall value in gage's rain type & units (4-byte float)
+//
+//   Frames for periods without rainfall need not appear in the file, and
+//   the cells of a frame without rainfall are never visited, so that only
+//   the cells with rain in the current and next frames are held in memory
+//   by a gage.
+//-----------------------------------------------------------------------------
+#define _CRT_SECURE_NO_DEPRECATE
+
+#include <stdlib.h>
+#include <string.h>
+#include "headers.h"
+
+//-----------------------------------------------------------------------------
+//  Constants
+//-----------------------------------------------------------------------------
+static const int GridEntrySize = sizeof(int) + sizeof(float);  // bytes
+
+//-----------------------------------------------------------------------------
+//  External functions (declared in funcs.h)
+//-----------------------------------------------------------------------------
+//  raingrid_open          (called by rain_open)
+//  raingrid_close         (called by rain_close)
+//  raingrid_rewind        (called by gage_initState)
+//  raingrid_readFrame     (called by getFirstRainfall & getNextRainfall)
+//  raingrid_swapFrames    (called by gage_initState & gage_setState)
+//  raingrid_getRainfall   (called by gage_getCellPrecip)
+
+//-----------------------------------------------------------------------------
+//  Local functions
+//-----------------------------------------------------------------------------
+static int  checkRainCells(int gage, int nCells);
+static void clearFrame(float* rain, int* wetCells, int* nWetCells);
+
+//=============================================================================
+
+int raingrid_open(int j)
+//
+//  Input:   j = rain gage index
+//  Output:  returns 1 if successful, 0 if not
+//  Purpose: opens a rain gage's rain grid file and allocates memory for
+//           its rainfall frames.
+//
+{
+    int        nCells = 0;
+    int        nFrames = -1;
+    char       fStamp[] = "SWMM5-GRID";
+    char       fileStamp[] = "SWMM5-GRID";
+    TRainGrid* grid;
+
+    // --- create a rain grid object for the gage
+    grid = (TRainGrid *) calloc(1, sizeof(TRainGrid));
+    if ( grid == NULL )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return 0;
+    }
+    Gage[j].grid = grid;
+
+    // --- open the file and check its header
+    if ( (grid->file = fopen(Gage[j].fname, "rb")) == NULL )
+    {
+        report_writeErrorMsg(ERR_RAIN_GRID_FILE, Gage[j].fname);
+        return 0;
+    }
+    if ( fread(fStamp, sizeof(char), strlen(fileStamp), grid->file)
+         < strlen(fileStamp)
+    ||   strcmp(fStamp, fileStamp) != 0
+    ||   fread(&nCells, sizeof(int), 1, grid->file) < 1
+    ||   fread(&nFrames, sizeof(int), 1, grid->file) < 1
+    ||   nCells <= 0 || nFrames < 0 )
+    {
+        report_writeErrorMsg(ERR_RAIN_GRID_FILE, Gage[j].fname);
+        return 0;
+    }
+    grid->nCells = nCells;
+    grid->nFrames = nFrames;
+    grid->startPos = ftell(grid->file);
+
+    // --- allocate memory for the current and next frames
+    grid->rain = (float *) calloc(nCells, sizeof(float));
+    grid->nextRain = (float *) calloc(nCells, sizeof(float));
+    grid->wetCells = (int *) calloc(nCells, sizeof(int));
+    grid->nextWetCells = (int *) calloc(nCells, sizeof(int));
+    grid->buffer = (char *) calloc(nCells, GridEntrySize);
+    if ( !grid->rain || !grid->nextRain || !grid->wetCells ||
+         !grid->nextWetCells || !grid->buffer )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return 0;
+    }
+
+    // --- check that subcatchments use cells that lie in the grid
+    if ( !checkRainCells(j, nCells) ) return 0;
+    raingrid_rewind(grid);
+    return 1;
+}
+
+//=============================================================================
+
+void raingrid_close(int j)
+//
+//  Input:   j = rain gage index
+//  Output:  none
+//  Purpose: closes a rain gage's rain grid file and frees its memory.
+//
+{
+    TRainGrid* grid = Gage[j].grid;
+
+    if ( grid == NULL ) return;
+    if ( grid->file ) fclose(grid->file);
+    FREE(grid->rain);
+    FREE(grid->nextRain);
+    FREE(grid->wetCells);
+    FREE(grid->nextWetCells);
+    FREE(grid->buffer);
+    FREE(Gage[j].grid);
+}
+
+//=============================================================================
+
+void raingrid_rewind(TRainGrid* grid)
+//
+//  Input:   grid = ptr. to a gage's rain grid
+//  Output:  none
+//  Purpose: positions a rain grid at its first frame with no rainfall
+//           in its current and next frames.
+//
+{
+    clearFrame(grid->rain, grid->wetCells, &grid->nWetCells);
+    clearFrame(grid->nextRain, grid->nextWetCells, &grid->nNextWetCells);
+    grid->factor = 0.0;
+    grid->nextFactor = 0.0;
+    grid->reportFrame = -1;
+    grid->frame = 0;
+    fseek(grid->file, grid->startPos, SEEK_SET);
+}
+
+//=============================================================================
+
+int raingrid_readFrame(TRainGrid* grid, DateTime* aDate, double* rain)
+//
+//  Input:   grid = ptr. to a gage's rain grid
+//  Output:  aDate = date/time at start of frame
+//           rain = average rainfall over all grid cells (user units);
+//           returns 1 if a frame was read, 0 if no frames remain
+//  Purpose: reads the next frame of a rain grid file into the grid's
+//           next frame.
+//
+{
+    int   i, n, skip;
+    int   cell = -1;
+    float x;
+    char* p;
+    double total = 0.0;
+
+    // --- remove the rainfall of the previous next frame
+    clearFrame(grid->nextRain, grid->nextWetCells, &grid->nNextWetCells);
+    *rain = 0.0;
+    if ( grid->frame >= grid->nFrames ) return 0;
+
+    // --- read the frame's date and its zero-run encoded cell values
+    if ( fread(aDate, sizeof(DateTime), 1, grid->file) < 1
+    ||   fread(&n, sizeof(int), 1, grid->file) < 1
+    ||   n < 0 || n > grid->nCells
+    ||   fread(grid->buffer, GridEntrySize, n, grid->file) < (size_t)n )
+    {
+        grid->frame = grid->nFrames;
+        return 0;
+    }
+    grid->frame++;
+
+    // --- place the values in the cells they belong to
+    p = grid->buffer;
+    for (i = 0; i < n; i++)
+    {
+        memcpy(&skip, p, sizeof(int));
+        memcpy(&x, p + sizeof(int), sizeof(float));
+        p += GridEntrySize;
+        cell += skip + 1;
+        if ( skip < 0 || cell >= grid->nCells ) break;
+        grid->nextRain[cell] = x;
+        grid->nextWetCells[grid->nNextWetCells++] = cell;
+        total += x;
+    }
+    *rain = total / grid->nCells;
+    return 1;
+}
+
+//=============================================================================
+
+void raingrid_swapFrames(TRainGrid* grid)
+//
+//  Input:   grid = ptr. to a gage's rain grid
+//  Output:  none
+//  Purpose: exchanges a rain grid's current frame with its next frame.
+//
+{
+    float* rain = grid->rain;
+    int*   wetCells = grid->wetCells;
+    int    nWetCells = grid->nWetCells;
+    double factor = grid->factor;
+
+    grid->rain = grid->nextRain;
+    grid->wetCells = grid->nextWetCells;
+    grid->nWetCells = grid->nNextWetCells;
+    grid->factor = grid->nextFactor;
+    grid->nextRain = rain;
+    grid->nextWetCells = wetCells;
+    grid->nNextWetCells = nWetCells;
+    grid->nextFactor = factor;
+}
+
+//=============================================================================
+
+double raingrid_getRainfall(TRainGrid* grid, TRainCells* cells, int frame)
+//
+//  Input:   grid = ptr. to a gage's rain grid
+//           cells = ptr. to grid cells covering a subcatchment
+//           frame = 0 for the current frame or 1 for the next frame
+//  Output:  returns area-weighted rainfall over the cells (user units)
+//  Purpose: finds the rainfall that a subcatchment receives from a
+//           frame of a rain grid.
+//
+{
+    int    k;
+    float* rain = (frame == 0) ? grid->rain : grid->nextRain;
+    double r = 0.0;
+
+    for (k = 0; k < cells->count; k++)
+    {
+        r += cells->weight[k] * rain[cells->cell[k]];
+    }
+    return r;
+}
+
+//=============================================================================
+
+int checkRainCells(int j, int nCells)
+//
+//  Input:   j = rain gage index
+//           nCells = number of cells in gage's rain grid
+//  Output:  returns 1 if all cells are valid, 0 if not
+//  Purpose: checks that the subcatchments using a rain grid only refer to
+//           cells that lie within it.
+//
+{
+    int i, k;
+
+    for (i = 0; i < Nobjects[SUBCATCH]; i++)
+    {
+        if ( Subcatch[i].gage != j ) continue;
+        for (k = 0; k < Subcatch[i].rainCells.count; k++)
+        {
+            if ( Subcatch[i].rainCells.cell[k] >= nCells )
+            {
+                report_writeErrorMsg(ERR_RAIN_GRID_CELLS, Subcatch[i].ID);
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+//=============================================================================
+
+void clearFrame(float* rain, int* wetCells, int* nWetCells)
+//
+//  Input:   rain = rainfall in each grid cell
+//           wetCells = indexes of cells with rainfall
+//           nWetCells = number of cells with rainfall
+//  Output:  nWetCells = 0
+//  Purpose: sets the rainfall of a frame's wet cells back to zero.
+//
+{
+    int k;
+
+    for (k = 0; k < *nWetCells; k++) rain[wetCells[k]] = 0.0f;
+    *nWetCells = 0;
+}
@@ -15,6 +15,12 @@
 //   Note: RDII means rainfall dependent infiltration/inflow,
 //         UH means unit hydrograph.
 //
+//   The ordinates of each UH (times its response ratio) are tabulated by
+//   month and time period before the RDII file is created, and the
+//   convolutions of the UH groups are computed in parallel when OpenMP is
+//   available. Each convolution sums its terms in the same order as before
+//   so that the RDII file produced does not depend on the number of threads.
+//
 //   Build 5.1.007:
 //   - Ignore RDII option implemented.
 //   - Rainfall climate adjustment implemented.
@@ -25,6 +31,9 @@
 #include <math.h>
 #include <string.h>
 #include <stdlib.h>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
 #include "headers.h"
 
 //-----------------------------------------------------------------------------
@@ -50,6 +59,8 @@ typedef struct                         // Data for a single unit hydrograph
 {                                      // -------------------------------------
    double*   pastRain;                 // array of past rainfall values
    char*     pastMonth;                // month in which past rainfall occurred
+   double*   ordinate;                 // UH ordinate x response ratio for
+                                       // each month & time period
    int       period;                   // current UH time period
    int       hasPastRain;              // true if > 0 past periods with rain
    int       maxPeriods;               // max. past rainfall periods
@@ -122,6 +133,7 @@ static int    getRainInterval(int i);
 static int    getMaxPeriods(int i, int k);
 static void   initGageData(void);
 static void   initUnitHydData(void);
+static void   initUnitHydOrds(int j, int k);
 static int    openNewRdiiFile(void);
 static void   getRainfall(DateTime currentDate);
 
@@ -129,7 +141,7 @@ static double applyIA(int j, int k, DateTime aDate, double dt,
               double rainDepth);
 static void   updateDryPeriod(int j, int k, double rain, int gageInterval);
 static void   getUnitHydRdii(DateTime currentDate);
-static double getUnitHydConvol(int j, int k, int gageInterval);
+static double getUnitHydConvol(int j, int k);
 static double getUnitHydOrd(int j, int m, int k, double t);
 
 static int    getNodeRdii(void);
@@ -936,6 +948,7 @@ int  allocRdiiMemory()
         {
             UHGroup[i].uh[k].pastRain = NULL;
             UHGroup[i].uh[k].pastMonth = NULL;
+            UHGroup[i].uh[k].ordinate = NULL;
             UHGroup[i].uh[k].maxPeriods = getMaxPeriods(i, k);
             n = UHGroup[i].uh[k].maxPeriods;
             if ( n > 0 )
@@ -946,6 +959,9 @@ int  allocRdiiMemory()
                 UHGroup[i].uh[k].pastMonth =
                     (char *) calloc(n, sizeof(char));
                 if ( !UHGroup[i].uh[k].pastMonth ) return FALSE;
+                UHGroup[i].uh[k].ordinate =
+                    (double *) calloc(12 * n, sizeof(double));
+                if ( !UHGroup[i].uh[k].ordinate ) return FALSE;
             }
         }
     }
@@ -1094,6 +1110,9 @@ void initUnitHydData()
 
             // --- assign initial abstraction used
             UHGroup[i].uh[k].iaUsed = UnitHyd[i].iaInit[month][k];
+
+            // --- tabulate the UH's ordinates
+            initUnitHydOrds(i, k);
         }
 
         // --- initialize gage date to simulation start date
@@ -1121,6 +1140,38 @@ void initUnitHydData()
 
 //=============================================================================
 
+void initUnitHydOrds(int j, int k)
+//
+//  Input:   j = UH group index
+//           k = UH index
+//  Output:  none
+//  Purpose: tabulates the ordinate of a unit hydrograph, multiplied by its
+//           response ratio, at the mid-point of each of its time periods
+//           for each month of the year.
+//
+{
+    int    m;                          // month of year index
+    int    p;                          // UH time period index
+    int    pMax;                       // max. number of periods
+    double t;                          // UH time value (sec)
+    double rainInterval;               // rainfall time interval (sec)
+    TUHData* uh = &UHGroup[j].uh[k];
+
+    pMax = uh->maxPeriods;
+    rainInterval = (double)UHGroup[j].rainInterval;
+    for (m = 0; m < 12; m++)
+    {
+        for (p = 1; p < pMax; p++)
+        {
+            t = ((double)(p) - 0.5) * rainInterval;
+            uh->ordinate[m*pMax + p] =
+                getUnitHydOrd(j, m, k, t) * UnitHyd[j].r[m][k];
+        }
+    }
+}
+
+//=============================================================================
+
 int openNewRdiiFile()
 //
 //  Input:   none
@@ -1323,9 +1374,10 @@ void getUnitHydRdii(DateTime currentDate)
 {
     int   j;                           // UH group index
     int   k;                           // UH index
-    int   rainInterval;                // rainfall time interval (sec)
 
-    // --- examine each UH group
+    // --- examine each UH group (in parallel, since each group's
+    //     convolutions only use its own data)
+#pragma omp parallel for num_threads(NumThreads) private(k) schedule(dynamic)
     for (j=0; j<Nobjects[UNITHYD]; j++)
     {
         // --- skip calculation if group not used by any RDII node or if
@@ -1337,13 +1389,12 @@ void getUnitHydRdii(DateTime currentDate)
         UHGroup[j].lastDate = UHGroup[j].gageDate;
 
         // --- perform convolution for each UH in the group
-        rainInterval = UHGroup[j].rainInterval;
         UHGroup[j].rdii = 0.0;
         for (k=0; k<3; k++)
         {
             if ( UHGroup[j].uh[k].hasPastRain )
             {
-                UHGroup[j].rdii += getUnitHydConvol(j, k, rainInterval);
+                UHGroup[j].rdii += getUnitHydConvol(j, k);
             }
         }
     }
@@ -1351,11 +1402,10 @@ void getUnitHydRdii(DateTime currentDate)
 
 //=============================================================================
 
-double getUnitHydConvol(int j, int k, int rainInterval)
+double getUnitHydConvol(int j, int k)
 //
 //  Input:   j = UH group index
 //           k = UH index
-//           rainInterval = rainfall time interval (sec)
 //  Output:  returns a RDII flow value
 //  Purpose: computes convolution of Unit Hydrographs with past rainfall.
 //
@@ -1364,7 +1414,6 @@ double getUnitHydConvol(int j, int k, int rainInterval)
     int    m;                          // month of year index
     int    p;                          // UH time period index
     int    pMax;                       // max. number of periods
-    double t;                          // UH time value (sec)
     double u;                          // UH ordinate
     double v;                          // rainfall volume
     double rdii;                       // RDII flow
@@ -1386,11 +1435,9 @@ double getUnitHydConvol(int j, int k, int rainInterval)
         m = uh->pastMonth[i];
         if ( v > 0.0 )
         {
-            // --- find mid-point time of UH period in seconds
-            t = ((double)(p) - 0.5) * (double)rainInterval;
-
-            // --- convolute rain volume with UH ordinate
-            u = getUnitHydOrd(j, m, k, t) * UnitHyd[j].r[m][k];
+            // --- convolute rain volume with UH ordinate at mid-point
+            //     of UH period
+            u = uh->ordinate[m*pMax + p];
             rdii += u * v;
         }
 
@@ -1526,6 +1573,7 @@ void freeRdiiMemory()
             {
                 FREE(UHGroup[i].uh[k].pastRain);
                 FREE(UHGroup[i].uh[k].pastMonth);
+                FREE(UHGroup[i].uh[k].ordinate);
             }
         }
         FREE(UHGroup);
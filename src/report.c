@@ -77,6 +77,7 @@ static void report_Nodes(void);
 static void report_NodeHeader(char *id);
 static void report_Links(void);
 static void report_LinkHeader(char *id);
+static void report_Result(char* format, int width, double x);
 
 
 //=============================================================================
@@ -1106,22 +1107,30 @@ void report_Subcatchments()
                 output_readDateTime(period, &days);
                 datetime_dateToStr(days, theDate);
                 datetime_timeToStr(days, theTime);
-                output_readSubcatchResults(period, k);
-                fprintf(Frpt.file, "\n  %11s %8s %10.3f%10.3f%10.4f",
-                    theDate, theTime, SubcatchResults[SUBCATCH_RAINFALL],
+                if ( !output_readSubcatchResults(period, k) ) continue;
+                fprintf(Frpt.file, "\n  %11s %8s ", theDate, theTime);
+                report_Result("%10.3f", 10,
+                    SubcatchResults[SUBCATCH_RAINFALL]);
+                if ( SubcatchResults[SUBCATCH_EVAP] == (REAL4)MISSING ||
+                     SubcatchResults[SUBCATCH_INFIL] == (REAL4)MISSING )
+                    report_Result("%10.3f", 10, (REAL4)MISSING);
+                else report_Result("%10.3f", 10,
                     SubcatchResults[SUBCATCH_EVAP]/24.0 +
-                    SubcatchResults[SUBCATCH_INFIL],
+                    SubcatchResults[SUBCATCH_INFIL]);
+                report_Result("%10.4f", 10,
                     SubcatchResults[SUBCATCH_RUNOFF]);
-                if ( hasSnowmelt )
-                    fprintf(Frpt.file, "  %10.3f",
-                        SubcatchResults[SUBCATCH_SNOWDEPTH]);
+                if ( hasSnowmelt ) report_Result("  %10.3f", 12,
+                    SubcatchResults[SUBCATCH_SNOWDEPTH]);
                 if ( hasGwater )
-                    fprintf(Frpt.file, "%10.3f%10.4f",
-                        SubcatchResults[SUBCATCH_GW_ELEV],
+                {
+                    report_Result("%10.3f", 10,
+                        SubcatchResults[SUBCATCH_GW_ELEV]);
+                    report_Result("%10.4f", 10,
                         SubcatchResults[SUBCATCH_GW_FLOW]);
+                }
                 if ( hasQuality )
                     for (p = 0; p < Nobjects[POLLUT]; p++)
-                        fprintf(Frpt.file, "%10.3f",
+                        report_Result("%10.3f", 10,
                             SubcatchResults[SUBCATCH_WASHOFF+p]);
             }
             WRITE("");
@@ -1230,13 +1239,14 @@ void report_Nodes()
                 output_readDateTime(period, &days);
                 datetime_dateToStr(days, theDate);
                 datetime_timeToStr(days, theTime);
-                output_readNodeResults(period, k);
-                fprintf(Frpt.file, "\n  %11s %8s  %9.3f %9.3f %9.3f %9.3f",
-                    theDate, theTime, NodeResults[NODE_INFLOW],
-                    NodeResults[NODE_OVERFLOW], NodeResults[NODE_DEPTH],
-                    NodeResults[NODE_HEAD]);
+                if ( !output_readNodeResults(period, k) ) continue;
+                fprintf(Frpt.file, "\n  %11s %8s ", theDate, theTime);
+                report_Result(" %9.3f", 10, NodeResults[NODE_INFLOW]);
+                report_Result(" %9.3f", 10, NodeResults[NODE_OVERFLOW]);
+                report_Result(" %9.3f", 10, NodeResults[NODE_DEPTH]);
+                report_Result(" %9.3f", 10, NodeResults[NODE_HEAD]);
                 if ( !IgnoreQuality ) for (p = 0; p < Nobjects[POLLUT]; p++)
-                    fprintf(Frpt.file, " %9.3f", NodeResults[NODE_QUAL + p]);
+                    report_Result(" %9.3f", 10, NodeResults[NODE_QUAL + p]);
             }
             WRITE("");
             k++;
@@ -1309,13 +1319,14 @@ void report_Links()
                 output_readDateTime(period, &days);
                 datetime_dateToStr(days, theDate);
                 datetime_timeToStr(days, theTime);
-                output_readLinkResults(period, k);
-                fprintf(Frpt.file, "\n  %11s %8s  %9.3f %9.3f %9.3f %9.3f",
-                    theDate, theTime, LinkResults[LINK_FLOW],
-                    LinkResults[LINK_VELOCITY], LinkResults[LINK_DEPTH],
-                    LinkResults[LINK_CAPACITY]);
+                if ( !output_readLinkResults(period, k) ) continue;
+                fprintf(Frpt.file, "\n  %11s %8s ", theDate, theTime);
+                report_Result(" %9.3f", 10, LinkResults[LINK_FLOW]);
+                report_Result(" %9.3f", 10, LinkResults[LINK_VELOCITY]);
+                report_Result(" %9.3f", 10, LinkResults[LINK_DEPTH]);
+                report_Result(" %9.3f", 10, LinkResults[LINK_CAPACITY]);
                 if ( !IgnoreQuality ) for (p = 0; p < Nobjects[POLLUT]; p++)
-                    fprintf(Frpt.file, " %9.3f", LinkResults[LINK_QUAL + p]);
+                    report_Result(" %9.3f", 10, LinkResults[LINK_QUAL + p]);
             }
             WRITE("");
             k++;
@@ -1359,6 +1370,22 @@ void  report_LinkHeader(char *id)
         for (i = 0; i < Nobjects[POLLUT]; i++) fprintf(Frpt.file, LINE_10);
 }
 
+//=============================================================================
+
+void report_Result(char* format, int width, double x)
+//
+//  Input:   format = format used to write the result
+//           width = number of characters the format writes
+//           x = value of the result
+//  Output:  none
+//  Purpose: writes a single result to a table of the report file, leaving
+//           its column blank if the result was not saved.
+//
+{
+    if ( x == (REAL4)MISSING ) fprintf(Frpt.file, "%*s", width, "");
+    else fprintf(Frpt.file, format, x);
+}
+
 
 //=============================================================================
 //      ERROR REPORTING
@@ -111,6 +111,9 @@ int routing_open()
     flowrout_init(RouteModel);                                                 //(5.1.008)
     if ( Fhotstart1.mode == NO_FILE ) qualrout_init();                         //(5.1.008)
 
+    // --- have inflow time patterns evaluated at the first routing step
+    inflow_initPatternValues();
+
     // --- initialize routing events                                           //(5.1.011)
     if ( NumEvents > 0 ) sortEvents();                                         //(5.1.011)
     NextEvent = 0;                                                             //(5.1.011)
@@ -202,10 +205,13 @@ void routing_execute(int routingModel, double routingStep)
     // --- control rules (e.g., pump on/off depth limits)
     for (j=0; j<Nobjects[LINK]; j++) link_setTargetSetting(j);
 
+    // --- let user's callback act before control rules are evaluated
+    callStepCallback(BEFORE_CONTROLS, NewRoutingTime);
+
     // --- find new target settings due to control rules
     currentDate = getDateTime(NewRoutingTime);
-    controls_evaluate(currentDate, currentDate - StartDateTime,
-                      routingStep/SECperDAY);
+    RuleActionCount += controls_evaluate(currentDate,
+                           currentDate - StartDateTime, routingStep/SECperDAY);
 
     // --- change each link's actual setting if it differs from its target
     for (j=0; j<Nobjects[LINK]; j++)
@@ -268,6 +274,7 @@ void routing_execute(int routingModel, double routingStep)
         }
 
         // --- add lateral inflows and evap/seepage losses at nodes
+        inflow_setPatternValues(currentDate);
         addExternalInflows(currentDate);
         addDryWeatherInflows(currentDate);
         addWetWeatherInflows(OldRoutingTime);
@@ -303,12 +310,14 @@ void routing_execute(int routingModel, double routingStep)
                 stepCount = flowrout_execute(SortedLinks, routingModel, routingStep);
             }
         }
+        callStepCallback(AFTER_ROUTING, NewRoutingTime);
 
         // --- route quality through the drainage network
         if ( Nobjects[POLLUT] > 0 && !IgnoreQuality ) 
         {
             qualrout_execute(routingStep);
         }
+        callStepCallback(AFTER_QUALITY, NewRoutingTime);
 
         // --- remove evaporation, infiltration & outflows from system
         removeStorageLosses(routingStep);
@@ -400,18 +409,14 @@ void addDryWeatherInflows(DateTime currentDate)
 //  Output:  none
 //  Purpose: adds dry weather inflows to nodes at current date.
 //
+//  NOTE: the inflows' values for the current date were set by
+//        inflow_setPatternValues.
+//
 {
     int      j, p;
-    int      month, day, hour;
     double   q, w;
     TDwfInflow* inflow;
 
-    // --- get month (zero-based), day-of-week (zero-based),
-    //     & hour-of-day for routing date/time
-    month = datetime_monthOfYear(currentDate) - 1;
-    day   = datetime_dayOfWeek(currentDate) - 1;
-    hour  = datetime_hourOfDay(currentDate);
-
     // --- for each node with a defined dry weather inflow
     for (j = 0; j < Nobjects[NODE]; j++)
     {
@@ -424,7 +429,7 @@ void addDryWeatherInflows(DateTime currentDate)
         {
             if ( inflow->param < 0 )
             {
-                q = inflow_getDwfInflow(inflow, month, day, hour);
+                q = inflow->value;
                 break;
             }
             inflow = inflow->next;
@@ -456,7 +461,7 @@ void addDryWeatherInflows(DateTime currentDate)
             if ( inflow->param >= 0 )
             {
                 p = inflow->param;
-                w = q * inflow_getDwfInflow(inflow, month, day, hour);
+                w = q * inflow->value;
                 Node[j].newQual[p] += w;
                 massbal_addInflowQual(DRY_WEATHER_INFLOW, p, w);
 
@@ -29,15 +29,53 @@
 //
 //   Build 5.1.012:
 //   - Runoff wet time step no longer kept aligned with reporting times.
+//
+//   The layout of an indexed Runoff Interface file is:
+//     File stamp ("SWMM5-RUNIDX") (12 bytes)
+//     File format version (4-byte int)
+//     Number of subcatchments, pollutants & flow units code (4-byte ints)
+//     Date/time at start of simulation (8-byte double)
+//     Number of time steps saved (4-byte int)
+//     File position of the time step index (8-byte int)
+//     For each subcatchment:
+//       number of characters in its name (4-byte int)
+//       characters of the name
+//     For each time step:
+//       runoff time step in seconds (4-byte float)
+//       results for each subcatchment (4-byte floats)
+//     For each time step (the time step index):
+//       elapsed msec at end of time step (8-byte double)
+//       file position of the time step's results (8-byte int)
+//
+//   File positions are 8-byte ints so that files larger than 2 GB (common
+//   for long continuous simulations) can be indexed. Version 1 files, which
+//   saved them as 4-byte ints, can still be read.
+//
+//   Files that begin with the older "SWMM5-RUNOFF" stamp (with no subcatchment
+//   names or index) can still be used, but only from their first time step.
+//   An indexed file can be used by a simulation that starts at any date the
+//   file covers and by a project containing any subset of its subcatchments.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
+#define _FILE_OFFSET_BITS 64           // 64-bit file positions (ftello)
 
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <math.h>
 #include "headers.h"
 #include "odesolve.h"
 
+#define INT4  int
+#define INT8  long long
+#define REAL4 float
+#define REAL8 double
+
+//-----------------------------------------------------------------------------
+//  Constants
+//-----------------------------------------------------------------------------
+static const INT4 RunoffFileVersion = 2;    // version of indexed file format
+
 //-----------------------------------------------------------------------------
 // Shared variables
 //-----------------------------------------------------------------------------
@@ -46,8 +84,19 @@ static char  HasRunoff;                // TRUE if study area generates runoff
 static char  HasSnow;                  // TRUE if any snow cover on study area
 static int   Nsteps;                   // number of runoff time steps taken
 static int   MaxSteps;                 // final number of runoff time steps
-static long  MaxStepsPos;              // position in Runoff interface file
+static INT8  MaxStepsPos;              // position in Runoff interface file
                                        //    where MaxSteps is saved
+static INT8  IndexPosPos;              // position in Runoff interface file
+                                       //    where index position is saved
+static int   IsIndexed;                // TRUE if interface file is indexed
+static int   FirstStep;                // first file time step used
+static int   FileSubcatchCount;        // number of subcatchments on file
+static int*  FileSubcatch;             // file subcatch. of each subcatch.
+static REAL4* StepResults;             // results read for one time step
+static REAL8* StepTimes;               // elapsed msec at end of each step
+static INT8* StepOffsets;              // file position of each step
+static int   StepCapacity;             // size of time step index arrays
+static double StartOffset;             // msec from file start to sim. start
 
 //-----------------------------------------------------------------------------
 //  Exportable variables 
@@ -74,6 +123,13 @@ static double runoff_getTimeStep(DateTime currentDate);
 static void   runoff_initFile(void);
 static void   runoff_readFromFile(void);
 static void   runoff_saveToFile(float tStep);
+static int    runoff_readFileHeader(void);
+static int    runoff_seekFileStart(void);
+static void   runoff_writeFileIndex(void);
+static int    runoff_addIndexEntry(REAL8 endTime, INT8 offset);
+static INT8   runoff_tellFile(FILE* f);
+static int    runoff_seekFile(FILE* f, INT8 offset);
+static void   runoff_freeFileData(void);
 static void   runoff_getOutfallRunon(double tStep);                            //(5.1.008)
 
 //=============================================================================
@@ -89,6 +145,15 @@ int runoff_open()
     HasRunoff = FALSE;
     HasSnow = FALSE;
     Nsteps = 0;
+    IsIndexed = FALSE;
+    FirstStep = 0;
+    FileSubcatchCount = 0;
+    FileSubcatch = NULL;
+    StepResults = NULL;
+    StepTimes = NULL;
+    StepOffsets = NULL;
+    StepCapacity = 0;
+    StartOffset = 0.0;
 
     // --- open the Ordinary Differential Equation solver
     if ( !odesolve_open(MAXODES) ) report_writeErrorMsg(ERR_ODE_SOLVER, "");
@@ -138,14 +203,12 @@ void runoff_close()
     // --- close runoff interface file if in use
     if ( Frunoff.file )
     {
-        // --- write to file number of time steps simulated
-        if ( Frunoff.mode == SAVE_FILE )
-        {
-            fseek(Frunoff.file, MaxStepsPos, SEEK_SET);
-            fwrite(&Nsteps, sizeof(int), 1, Frunoff.file);
-        }
+        // --- write to file the time step index & number of steps simulated
+        if ( Frunoff.mode == SAVE_FILE ) runoff_writeFileIndex();
         fclose(Frunoff.file);
+        Frunoff.file = NULL;
     }
+    runoff_freeFileData();
 
     // --- close climate file if in use
     if ( Fclimate.file ) fclose(Fclimate.file);
@@ -337,32 +400,59 @@ void runoff_initFile(void)
 //  Purpose: initializes a Runoff Interface file for saving results.
 //
 {
+    int   j;
     int   nSubcatch;
     int   nPollut;
     int   flowUnits;
-    char  fileStamp[] = "SWMM5-RUNOFF";
-    char  fStamp[] = "SWMM5-RUNOFF";
+    INT4  n;
+    INT8  indexPos = 0;
+    REAL8 startDate;
+    char  fileStamp[] = "SWMM5-RUNIDX";
+    char  oldFileStamp[] = "SWMM5-RUNOFF";
+    char  fStamp[] = "SWMM5-RUNIDX";
 
     MaxSteps = 0;
     if ( Frunoff.mode == SAVE_FILE )
     {
-        // --- write file stamp, # subcatchments & # pollutants to file
+        // --- write file stamp, version, # subcatchments & # pollutants to file
         nSubcatch = Nobjects[SUBCATCH];
         nPollut = Nobjects[POLLUT];
         flowUnits = FlowUnits;
+        startDate = StartDateTime;
         fwrite(fileStamp, sizeof(char), strlen(fileStamp), Frunoff.file);
+        fwrite(&RunoffFileVersion, sizeof(INT4), 1, Frunoff.file);
         fwrite(&nSubcatch, sizeof(int), 1, Frunoff.file);
         fwrite(&nPollut, sizeof(int), 1, Frunoff.file);
         fwrite(&flowUnits, sizeof(int), 1, Frunoff.file);
-        MaxStepsPos = ftell(Frunoff.file); 
+        fwrite(&startDate, sizeof(REAL8), 1, Frunoff.file);
+        MaxStepsPos = runoff_tellFile(Frunoff.file);
         fwrite(&MaxSteps, sizeof(int), 1, Frunoff.file);
+        IndexPosPos = runoff_tellFile(Frunoff.file);
+        fwrite(&indexPos, sizeof(INT8), 1, Frunoff.file);
+
+        // --- write subcatchment names to file
+        for (j = 0; j < nSubcatch; j++)
+        {
+            n = (INT4)strlen(Subcatch[j].ID);
+            fwrite(&n, sizeof(INT4), 1, Frunoff.file);
+            fwrite(Subcatch[j].ID, sizeof(char), n, Frunoff.file);
+        }
+        IsIndexed = TRUE;
     }
 
     if ( Frunoff.mode == USE_FILE )
     {
         // --- check that interface file contains proper header records
         fread(fStamp, sizeof(char), strlen(fileStamp), Frunoff.file);
-        if ( strcmp(fStamp, fileStamp) != 0 )
+        if ( strcmp(fStamp, fileStamp) == 0 )
+        {
+            IsIndexed = TRUE;
+            n = runoff_readFileHeader();
+            if ( n == 0 ) n = runoff_seekFileStart();
+            if ( n > 0 ) report_writeErrorMsg(n, "");
+            return;
+        }
+        if ( strcmp(fStamp, oldFileStamp) != 0 )
         {
             report_writeErrorMsg(ERR_RUNOFF_FILE_FORMAT, "");
             return;
@@ -380,8 +470,141 @@ void runoff_initFile(void)
         ||   MaxSteps  <= 0 )
         {
              report_writeErrorMsg(ERR_RUNOFF_FILE_FORMAT, "");
+             return;
+        }
+
+        // --- subcatchments of an older file appear in project order
+        FileSubcatchCount = nSubcatch;
+        FileSubcatch = (int *) calloc(nSubcatch, sizeof(int));
+        StepResults = (REAL4 *) calloc(nSubcatch *
+                      (MAX_SUBCATCH_RESULTS + nPollut - 1), sizeof(REAL4));
+        if ( !FileSubcatch || !StepResults )
+        {
+            report_writeErrorMsg(ERR_MEMORY, "");
+            return;
+        }
+        for (j = 0; j < nSubcatch; j++) FileSubcatch[j] = j;
+    }
+}
+
+//=============================================================================
+
+int runoff_readFileHeader(void)
+//
+//  Input:   none
+//  Output:  returns an error code
+//  Purpose: reads the header, subcatchment names & time step index of an
+//           indexed Runoff Interface file.
+//
+{
+    int   i, j;
+    INT4  version;                     // file format version
+    INT4  n[3];                        // # subcatchments, polluts & units
+    INT8  indexPos = 0;                // file position of time step index
+    INT4  offset4;                     // file position in a version 1 file
+    INT4  len;                         // length of a subcatchment name
+    REAL8 startDate;                   // starting date of saved results
+    char  s[MAXLINE+1];                // subcatchment name
+    FILE* f = Frunoff.file;
+
+    // --- read version, # subcatchments, # pollutants & flow units
+    if ( fread(&version, sizeof(INT4), 1, f) < 1
+    ||   fread(n, sizeof(INT4), 3, f) < 3
+    ||   fread(&startDate, sizeof(REAL8), 1, f) < 1
+    ||   fread(&MaxSteps, sizeof(INT4), 1, f) < 1 )
+        return ERR_RUNOFF_FILE_FORMAT;
+    if ( version == 1 )
+    {
+        if ( fread(&offset4, sizeof(INT4), 1, f) < 1 )
+            return ERR_RUNOFF_FILE_FORMAT;
+        indexPos = offset4;
+    }
+    else if ( fread(&indexPos, sizeof(INT8), 1, f) < 1 )
+        return ERR_RUNOFF_FILE_FORMAT;
+    if ( version < 1 || version > RunoffFileVersion
+    ||   n[0] <= 0
+    ||   n[1] != Nobjects[POLLUT]
+    ||   n[2] != FlowUnits
+    ||   MaxSteps <= 0
+    ||   indexPos <= 0 )
+        return ERR_RUNOFF_FILE_FORMAT;
+
+    // --- allocate memory for subcatchment map, results & time step index
+    FileSubcatchCount = n[0];
+    FileSubcatch = (int *) calloc(Nobjects[SUBCATCH], sizeof(int));
+    StepResults = (REAL4 *) calloc(n[0] *
+                  (MAX_SUBCATCH_RESULTS + Nobjects[POLLUT] - 1), sizeof(REAL4));
+    StepTimes = (REAL8 *) calloc(MaxSteps, sizeof(REAL8));
+    StepOffsets = (INT8 *) calloc(MaxSteps, sizeof(INT8));
+    if ( (Nobjects[SUBCATCH] > 0 && !FileSubcatch)
+    ||   !StepResults || !StepTimes || !StepOffsets ) return ERR_MEMORY;
+    StepCapacity = MaxSteps;
+
+    // --- locate each project subcatchment among those on file
+    for (j = 0; j < Nobjects[SUBCATCH]; j++) FileSubcatch[j] = -1;
+    for (i = 0; i < FileSubcatchCount; i++)
+    {
+        if ( fread(&len, sizeof(INT4), 1, f) < 1
+        ||   len <= 0 || len > MAXLINE
+        ||   fread(s, sizeof(char), len, f) < (size_t)len )
+            return ERR_RUNOFF_FILE_FORMAT;
+        s[len] = '\0';
+        j = project_findObject(SUBCATCH, s);
+        if ( j >= 0 ) FileSubcatch[j] = i;
+    }
+    for (j = 0; j < Nobjects[SUBCATCH]; j++)
+    {
+        if ( FileSubcatch[j] < 0 ) return ERR_RUNOFF_FILE_FORMAT;
+    }
+
+    // --- read the time step index
+    if ( runoff_seekFile(f, indexPos) != 0 ) return ERR_RUNOFF_FILE_READ;
+    for (i = 0; i < MaxSteps; i++)
+    {
+        if ( fread(&StepTimes[i], sizeof(REAL8), 1, f) < 1 )
+            return ERR_RUNOFF_FILE_READ;
+        if ( version == 1 )
+        {
+            if ( fread(&offset4, sizeof(INT4), 1, f) < 1 )
+                return ERR_RUNOFF_FILE_READ;
+            StepOffsets[i] = offset4;
         }
+        else if ( fread(&StepOffsets[i], sizeof(INT8), 1, f) < 1 )
+            return ERR_RUNOFF_FILE_READ;
     }
+
+    // --- find msec between start of saved results & start of simulation
+    StartOffset = floor((StartDateTime - startDate) * MSECperDAY + 0.5);
+    if ( StartOffset < 0.0 ) return ERR_RUNOFF_FILE_FORMAT;
+    return 0;
+}
+
+//=============================================================================
+
+int runoff_seekFileStart(void)
+//
+//  Input:   none
+//  Output:  returns an error code
+//  Purpose: moves an indexed Runoff Interface file to the time step that
+//           contains the start of the simulation.
+//
+{
+    int m;
+    int lo = 0;
+    int hi = MaxSteps;
+
+    // --- find first time step that ends after the simulation starts
+    while ( lo < hi )
+    {
+        m = (lo + hi) / 2;
+        if ( StepTimes[m] <= StartOffset ) lo = m + 1;
+        else hi = m;
+    }
+    if ( lo >= MaxSteps ) return ERR_RUNOFF_FILE_END;
+    FirstStep = lo;
+    if ( runoff_seekFile(Frunoff.file, StepOffsets[lo]) != 0 )
+        return ERR_RUNOFF_FILE_READ;
+    return 0;
 }
 
 //=============================================================================
@@ -396,7 +619,12 @@ void  runoff_saveToFile(float tStep)
     int j;
     int n = MAX_SUBCATCH_RESULTS + Nobjects[POLLUT] - 1;
     
-
+    // --- add the time step to the index before writing its results
+    if ( !runoff_addIndexEntry(NewRunoffTime, runoff_tellFile(Frunoff.file)) )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+    }
     fwrite(&tStep, sizeof(float), 1, Frunoff.file);
     for (j=0; j<Nobjects[SUBCATCH]; j++)
     {
@@ -407,6 +635,114 @@ void  runoff_saveToFile(float tStep)
 
 //=============================================================================
 
+int runoff_addIndexEntry(REAL8 endTime, INT8 offset)
+//
+//  Input:   endTime = elapsed msec at end of a saved time step
+//           offset = file position of the time step's results
+//  Output:  returns 1 if successful, 0 if out of memory
+//  Purpose: adds a time step to the index of a Runoff Interface file
+//           being saved.
+//
+{
+    int    newCapacity;
+    REAL8* times;
+    INT8*  offsets;
+
+    if ( Nsteps > StepCapacity )
+    {
+        newCapacity = 2 * Nsteps;
+        if ( newCapacity < 1024 ) newCapacity = 1024;
+        times = (REAL8 *) realloc(StepTimes, newCapacity * sizeof(REAL8));
+        if ( times == NULL ) return 0;
+        StepTimes = times;
+        offsets = (INT8 *) realloc(StepOffsets, newCapacity * sizeof(INT8));
+        if ( offsets == NULL ) return 0;
+        StepOffsets = offsets;
+        StepCapacity = newCapacity;
+    }
+    StepTimes[Nsteps-1] = endTime;
+    StepOffsets[Nsteps-1] = offset;
+    return 1;
+}
+
+//=============================================================================
+
+void runoff_writeFileIndex(void)
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: writes the time step index and number of time steps saved to
+//           a Runoff Interface file.
+//
+{
+    int   i;
+    INT8  indexPos;
+    FILE* f = Frunoff.file;
+
+    fseek(f, 0, SEEK_END);
+    indexPos = runoff_tellFile(f);
+    for (i = 0; i < Nsteps; i++)
+    {
+        fwrite(&StepTimes[i], sizeof(REAL8), 1, f);
+        fwrite(&StepOffsets[i], sizeof(INT8), 1, f);
+    }
+    runoff_seekFile(f, MaxStepsPos);
+    fwrite(&Nsteps, sizeof(int), 1, f);
+    runoff_seekFile(f, IndexPosPos);
+    fwrite(&indexPos, sizeof(INT8), 1, f);
+}
+
+//=============================================================================
+
+INT8 runoff_tellFile(FILE* f)
+//
+//  Input:   f = ptr. to Runoff Interface file
+//  Output:  returns current file position
+//  Purpose: finds the position in a file that may be larger than 2 GB.
+//
+{
+#ifdef _WIN32
+    return _ftelli64(f);
+#else
+    return ftello(f);
+#endif
+}
+
+//=============================================================================
+
+int runoff_seekFile(FILE* f, INT8 offset)
+//
+//  Input:   f = ptr. to Runoff Interface file
+//           offset = file position
+//  Output:  returns 0 if successful
+//  Purpose: moves to a position in a file that may be larger than 2 GB.
+//
+{
+#ifdef _WIN32
+    return _fseeki64(f, offset, SEEK_SET);
+#else
+    return fseeko(f, (off_t)offset, SEEK_SET);
+#endif
+}
+
+//=============================================================================
+
+void runoff_freeFileData(void)
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees memory used to read or save a Runoff Interface file.
+//
+{
+    FREE(FileSubcatch);
+    FREE(StepResults);
+    FREE(StepTimes);
+    FREE(StepOffsets);
+    StepCapacity = 0;
+}
+
+//=============================================================================
+
 void  runoff_readFromFile(void)
 //
 //  Input:   none
@@ -418,10 +754,11 @@ void  runoff_readFromFile(void)
     int    nResults;                   // number of results per subcatch.
     int    kount;                      // count of items read from file
     float  tStep;                      // runoff time step (sec)
+    REAL4* x;                          // results saved for a subcatchment
     TGroundwater* gw;                  // ptr. to Groundwater object
 
     // --- make sure not past end of file
-    if ( Nsteps > MaxSteps )
+    if ( FirstStep + Nsteps >= MaxSteps )
     {
          report_writeErrorMsg(ERR_RUNOFF_FILE_END, "");
          return;
@@ -430,55 +767,57 @@ void  runoff_readFromFile(void)
     // --- replace old state with current one for all subcatchments
     for (j = 0; j < Nobjects[SUBCATCH]; j++) subcatch_setOldState(j);
 
-    // --- read runoff time step
+    // --- compute number of results saved for each subcatchment
+    nResults = MAX_SUBCATCH_RESULTS + Nobjects[POLLUT] - 1;
+
+    // --- read runoff time step & results for all subcatchments on file
     kount = 0;
     kount += fread(&tStep, sizeof(float), 1, Frunoff.file);
+    kount += fread(StepResults, sizeof(REAL4), FileSubcatchCount * nResults,
+                   Frunoff.file);
 
-    // --- compute number of results saved for each subcatchment
-    nResults = MAX_SUBCATCH_RESULTS + Nobjects[POLLUT] - 1;
+    // --- report error if not enough values were read
+    if ( kount < 1 + FileSubcatchCount * nResults )
+    {
+         report_writeErrorMsg(ERR_RUNOFF_FILE_READ, "");
+         return;
+    }
 
     // --- for each subcatchment
     for (j = 0; j < Nobjects[SUBCATCH]; j++)
     {
-        // --- read vector of saved results
-        kount += fread(SubcatchResults, sizeof(float), nResults, Frunoff.file);
+        // --- locate its vector of saved results
+        x = StepResults + FileSubcatch[j] * nResults;
 
         // --- extract hydrologic results, converting units where necessary
         //     (results were saved to file in user's units)
-        Subcatch[j].newSnowDepth = SubcatchResults[SUBCATCH_SNOWDEPTH] /
-                                   UCF(RAINDEPTH);
-        Subcatch[j].evapLoss     = SubcatchResults[SUBCATCH_EVAP] /
-                                   UCF(RAINFALL);
-        Subcatch[j].infilLoss    = SubcatchResults[SUBCATCH_INFIL] /
-                                   UCF(RAINFALL);
-        Subcatch[j].newRunoff    = SubcatchResults[SUBCATCH_RUNOFF] /
-                                   UCF(FLOW);
+        Subcatch[j].newSnowDepth = x[SUBCATCH_SNOWDEPTH] / UCF(RAINDEPTH);
+        Subcatch[j].evapLoss     = x[SUBCATCH_EVAP] / UCF(RAINFALL);
+        Subcatch[j].infilLoss    = x[SUBCATCH_INFIL] / UCF(RAINFALL);
+        Subcatch[j].newRunoff    = x[SUBCATCH_RUNOFF] / UCF(FLOW);
         gw = Subcatch[j].groundwater;
         if ( gw )
         {
-            gw->newFlow    = SubcatchResults[SUBCATCH_GW_FLOW] / UCF(FLOW);
+            gw->newFlow    = x[SUBCATCH_GW_FLOW] / UCF(FLOW);
             gw->lowerDepth = Aquifer[gw->aquifer].bottomElev -
-                             (SubcatchResults[SUBCATCH_GW_ELEV] / UCF(LENGTH));
-            gw->theta      = SubcatchResults[SUBCATCH_SOIL_MOIST];
+                             (x[SUBCATCH_GW_ELEV] / UCF(LENGTH));
+            gw->theta      = x[SUBCATCH_SOIL_MOIST];
         }
 
         // --- extract water quality results
         for (i = 0; i < Nobjects[POLLUT]; i++)
         {
-            Subcatch[j].newQual[i] = SubcatchResults[SUBCATCH_WASHOFF + i];
+            Subcatch[j].newQual[i] = x[SUBCATCH_WASHOFF + i];
         }
     }
 
-    // --- report error if not enough values were read
-    if ( kount < 1 + Nobjects[SUBCATCH] * nResults )
-    {
-         report_writeErrorMsg(ERR_RUNOFF_FILE_READ, "");
-         return;
-    }
-
     // --- update runoff time clock
+    //     (the first step of an indexed file ends at its indexed time,
+    //     which may lie less than a full step past the simulation start)
     OldRunoffTime = NewRunoffTime;
-    NewRunoffTime = OldRunoffTime + (double)(tStep)*1000.0;
+    if ( IsIndexed && Nsteps == 0 )
+        NewRunoffTime = StepTimes[FirstStep] - StartOffset;
+    else NewRunoffTime = OldRunoffTime + (double)(tStep)*1000.0;
     NewRunoffTime = MIN(NewRunoffTime, TotalDuration);                         //(5.1.008)
     Nsteps++;
 }
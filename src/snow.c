@@ -377,7 +377,8 @@ void snow_plowSnow(int j, double tStep)
     if ( !snowpack ) return;
 
     // --- see if there's any snowfall
-    gage_getPrecip(Subcatch[j].gage, &rainfall, &snowfall);
+    gage_getCellPrecip(Subcatch[j].gage, &Subcatch[j].rainCells, &rainfall,
+                       &snowfall);
 
     // --- add snowfall to snow pack
     for (i=SNOW_PLOWABLE; i<=SNOW_PERV; i++)
@@ -0,0 +1,309 @@
+//-----------------------------------------------------------------------------
+//   stream.c
+//
+//   Project:  EPA SWMM5
+//   Version:  5.1
+//
+//   Live results stream functions.
+//
+//   When the RESULTS_STREAM option names a shared memory object, the results
+//   of each reporting period are published to a ring of slots held in that
+//   object as soon as they are computed, so that other processes on the same
+//   machine can display them while the simulation runs. Publishing does not
+//   replace the binary output file, which is written as usual.
+//
+//   The layout of the shared memory is:
+//     Stamp identifying a results stream (4-byte int)
+//     Number of slots in the ring (4-byte int)
+//     Bytes per slot (4-byte int)
+//     Status of the run (0 = running, 1 = ended, 2 = ended with an error)
+//       (4-byte int)
+//     Number of subcatchments, nodes & links reported on (4-byte ints)
+//     Number of results for each subcatchment, node & link and for the
+//       system (4-byte ints)
+//     Reporting time step (sec) (4-byte int)
+//     Number of periods published (8-byte int)
+//     For each slot (starting at byte 64):
+//       Number of the period held in the slot, counting from 1 (8-byte int)
+//       Date/time of the period (8-byte double)
+//       Results of the period in the same order as a reporting period of
+//       the binary output file (4-byte floats)
+//
+//   Period n is placed in slot (n-1) modulo the number of slots. There is a
+//   single writer and no locks: the writer sets a slot's period number to 0,
+//   fills the slot and then stores the new period number, followed by the
+//   number of periods published. A reader takes period n from its slot by:
+//     1. loading the slot's period number with acquire ordering and giving
+//        up unless it equals n;
+//     2. copying the slot's contents;
+//     3. issuing an acquire fence (__atomic_thread_fence(__ATOMIC_ACQUIRE)
+//        or MemoryBarrier() on Windows), so that the copy's loads cannot be
+//        moved after the next step;
+//     4. loading the period number again.
+//   If it still equals n the copy holds a complete period; otherwise the
+//   slot was overwritten and the period is lost to that reader. The stamp
+//   is stored last when the stream is opened.
+//
+//   The shared memory object lasts until the project is closed, when its
+//   name is removed (on POSIX systems) or its last handle held by the engine
+//   is closed (on Windows). Readers that have mapped it by then keep their
+//   mapping and can still take the final periods, but a reader must attach
+//   to the stream while the project is open.
+//-----------------------------------------------------------------------------
+#define _CRT_SECURE_NO_DEPRECATE
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include "headers.h"
+
+//-----------------------------------------------------------------------------
+//  Constants
+//-----------------------------------------------------------------------------
+#define STREAM_STAMP   516114527       // stamp identifying a results stream
+#define HEADER_BYTES   64              // bytes reserved for stream header
+
+//  Ordered stores seen by other processes sharing the memory
+#ifdef _WIN32
+  #define STORE_RELEASE(p, v)  (MemoryBarrier(), *(p) = (v))
+  #define FENCE_RELEASE()      MemoryBarrier()
+#else
+  #define STORE_RELEASE(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+  #define FENCE_RELEASE()      __atomic_thread_fence(__ATOMIC_RELEASE)
+#endif
+
+//-----------------------------------------------------------------------------
+//  Data Structures
+//-----------------------------------------------------------------------------
+typedef struct
+{
+    volatile int       stamp;          // stamp identifying results stream
+    int                slots;          // number of slots in ring
+    int                slotBytes;      // bytes per slot
+    volatile int       status;         // 0 = running, 1 = ended, 2 = error
+    int                count[3];       // subcatchments, nodes & links
+    int                results[4];     // results per object type & system
+    int                reportStep;     // reporting time step (sec)
+    volatile long long published;      // number of periods published
+}  TStreamHeader;
+
+//-----------------------------------------------------------------------------
+//  Shared variables
+//-----------------------------------------------------------------------------
+static char*          StreamData;      // start of shared memory (or NULL)
+static TStreamHeader* StreamHeader;    // header at start of shared memory
+static size_t         StreamBytes;     // size of shared memory (bytes)
+static int            PeriodBytes;     // bytes of a period's date & results
+static long long      Published;       // number of periods published
+#ifdef _WIN32
+static HANDLE         StreamHandle;    // file mapping object
+#else
+static char           ShmName[MAXFNAME+2];  // name of shared memory object
+#endif
+
+//-----------------------------------------------------------------------------
+//  External functions (declared in funcs.h)
+//-----------------------------------------------------------------------------
+//  stream_open            (called by output_open)
+//  stream_publish         (called by output_saveResults)
+//  stream_end             (called by output_end)
+//  stream_close           (called by output_close)
+
+//-----------------------------------------------------------------------------
+//  Local functions
+//-----------------------------------------------------------------------------
+static int  mapSharedMemory(char* name, size_t bytes);
+static void unmapSharedMemory(void);
+
+//=============================================================================
+
+int stream_open(int count[], int results[], int periodBytes)
+//
+//  Input:   count = number of subcatchments, nodes & links reported on
+//           results = number of results per subcatchment, node & link and
+//                     for the system
+//           periodBytes = bytes of a period's date & results
+//  Output:  returns an error code
+//  Purpose: creates the shared memory that reporting period results are
+//           published to if the RESULTS_STREAM option was used.
+//
+{
+    int  i;
+    long long slotBytes;
+
+    stream_close();
+    if ( strlen(StreamName) == 0 ) return 0;
+
+    // --- each slot holds a period number followed by the period's date
+    //     and results, rounded up to whole 8-byte words
+    slotBytes = sizeof(long long) + periodBytes;
+    slotBytes = (slotBytes + 7) / 8 * 8;
+    if ( StreamPeriods <= 0 || slotBytes * StreamPeriods +
+         HEADER_BYTES > MAXFILESIZE )
+    {
+        report_writeErrorMsg(ERR_STREAM_OPEN, StreamName);
+        return ErrorCode;
+    }
+    if ( !mapSharedMemory(StreamName,
+          (size_t)(HEADER_BYTES + slotBytes * StreamPeriods)) )
+    {
+        report_writeErrorMsg(ERR_STREAM_OPEN, StreamName);
+        return ErrorCode;
+    }
+
+    // --- describe the layout of the periods, storing the stamp last
+    StreamHeader = (TStreamHeader *)StreamData;
+    StreamHeader->stamp = 0;
+    FENCE_RELEASE();
+    memset(StreamData, 0, StreamBytes);
+    StreamHeader->slots = StreamPeriods;
+    StreamHeader->slotBytes = (int)slotBytes;
+    for (i = 0; i < 3; i++) StreamHeader->count[i] = count[i];
+    for (i = 0; i < 4; i++) StreamHeader->results[i] = results[i];
+    StreamHeader->reportStep = ReportStep;
+    STORE_RELEASE(&StreamHeader->stamp, STREAM_STAMP);
+    PeriodBytes = periodBytes;
+    Published = 0;
+    return 0;
+}
+
+//=============================================================================
+
+void stream_publish(char* period)
+//
+//  Input:   period = a reporting period's date & results
+//  Output:  none
+//  Purpose: places a reporting period in the next slot of the ring.
+//
+{
+    char*      slot;
+    long long* slotPeriod;
+
+    if ( StreamData == NULL ) return;
+    slot = StreamData + HEADER_BYTES +
+           (size_t)(Published % StreamHeader->slots) * StreamHeader->slotBytes;
+    slotPeriod = (long long *)slot;
+
+    // --- mark the slot as being written before overwriting it
+    *slotPeriod = 0;
+    FENCE_RELEASE();
+    memcpy(slot + sizeof(long long), period, PeriodBytes);
+
+    // --- make the period visible to readers
+    Published++;
+    STORE_RELEASE(slotPeriod, Published);
+    STORE_RELEASE(&StreamHeader->published, Published);
+}
+
+//=============================================================================
+
+void stream_end(int status)
+//
+//  Input:   status = 1 if the run ended normally, 2 if with an error
+//  Output:  none
+//  Purpose: tells readers that no more periods will be published.
+//
+{
+    if ( StreamData == NULL ) return;
+    STORE_RELEASE(&StreamHeader->status, status);
+}
+
+//=============================================================================
+
+void stream_close()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: stops publishing results to shared memory and removes the
+//           shared memory object.
+//
+{
+    if ( StreamData == NULL ) return;
+    if ( StreamHeader->status == 0 ) stream_end(2);
+    unmapSharedMemory();
+}
+
+//=============================================================================
+
+int mapSharedMemory(char* name, size_t bytes)
+//
+//  Input:   name = name of shared memory object
+//           bytes = size of shared memory
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: creates (or re-uses) a named shared memory object and maps it
+//           into memory.
+//
+{
+#ifdef _WIN32
+    StreamHandle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL,
+        PAGE_READWRITE, (DWORD)((unsigned long long)bytes >> 32),
+        (DWORD)(bytes & 0xFFFFFFFF), name);
+    if ( StreamHandle == NULL ) return FALSE;
+    StreamData = (char *)MapViewOfFile(StreamHandle, FILE_MAP_ALL_ACCESS,
+        0, 0, bytes);
+    if ( StreamData == NULL )
+    {
+        CloseHandle(StreamHandle);
+        StreamHandle = NULL;
+        return FALSE;
+    }
+#else
+    int   fd;
+    void* p;
+
+    // --- POSIX shared memory names begin with a slash
+    if ( name[0] == '/' ) sstrncpy(ShmName, name, MAXFNAME+1);
+    else
+    {
+        ShmName[0] = '/';
+        sstrncpy(ShmName+1, name, MAXFNAME);
+    }
+    fd = shm_open(ShmName, O_CREAT | O_RDWR, 0644);
+    if ( fd < 0 ) return FALSE;
+    if ( ftruncate(fd, (off_t)bytes) != 0 )
+    {
+        close(fd);
+        shm_unlink(ShmName);
+        return FALSE;
+    }
+    p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if ( p == MAP_FAILED )
+    {
+        shm_unlink(ShmName);
+        return FALSE;
+    }
+    StreamData = (char *)p;
+#endif
+    StreamBytes = bytes;
+    return TRUE;
+}
+
+//=============================================================================
+
+void unmapSharedMemory()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: removes the mapping of the shared memory object and the
+//           object's name.
+//
+{
+#ifdef _WIN32
+    UnmapViewOfFile(StreamData);
+    CloseHandle(StreamHandle);
+    StreamHandle = NULL;
+#else
+    munmap(StreamData, StreamBytes);
+    shm_unlink(ShmName);
+#endif
+    StreamData = NULL;
+    StreamHeader = NULL;
+    StreamBytes = 0;
+}
@@ -81,6 +81,7 @@ static  char *RunoffRoutingWords[] = { w_OUTLET,  w_IMPERV, w_PERV, NULL};
 //  subcatch_readSubareaParams (called from parseLine in input.c)
 //  subcatch_readLanduseParams (called from parseLine in input.c)
 //  subcatch_readInitBuildup   (called from parseLine in input.c)
+//  subcatch_readRainCells     (called from parseLine in input.c)
 
 //  subcatch_validate          (called from project_validate)
 //  subcatch_initState         (called from project_init)
@@ -355,6 +356,68 @@ int subcatch_readInitBuildup(char* tok[], int ntoks)
 
 //=============================================================================
 
+int subcatch_readRainCells(char* tok[], int ntoks)
+//
+//  Input:   tok[] = array of string tokens
+//           ntoks = number of tokens
+//  Output:  returns an error code
+//  Purpose: reads the rain grid cells that cover a subcatchment from
+//           a tokenized line of input data.
+//
+//  Data has format:
+//    Subcatch  cell  weight .... cell  weight
+//
+//  where cells are numbered starting from 1 and weight is the fraction
+//  of the subcatchment's area lying in the cell.
+//
+{
+    int     j, k, m, n;
+    int*    cell;
+    double  x;
+    double* weight;
+    TRainCells* cells;
+
+    // --- check for enough tokens
+    if ( ntoks < 3 ) return error_setInpError(ERR_ITEMS, "");
+
+    // --- check that named subcatch exists
+    j = project_findObject(SUBCATCH, tok[0]);
+    if ( j < 0 ) return error_setInpError(ERR_NAME, tok[0]);
+    cells = &Subcatch[j].rainCells;
+
+    // --- process each pair of cell - weight items
+    for ( k = 2; k <= ntoks; k = k+2)
+    {
+        // --- check for valid cell number and weight
+        if ( !getInt(tok[k-1], &m) || m < 1 )
+            return error_setInpError(ERR_NUMBER, tok[k-1]);
+        if ( k+1 > ntoks ) return error_setInpError(ERR_ITEMS, "");
+        if ( ! getDouble(tok[k], &x) || x < 0.0 )
+            return error_setInpError(ERR_NUMBER, tok[k]);
+
+        // --- enlarge the subcatch's cell arrays if need be
+        if ( cells->count == cells->size )
+        {
+            n = (cells->size == 0) ? 4 : 2 * cells->size;
+            cell = (int *) realloc(cells->cell, n * sizeof(int));
+            if ( cell == NULL ) return error_setInpError(ERR_MEMORY, "");
+            cells->cell = cell;
+            weight = (double *) realloc(cells->weight, n * sizeof(double));
+            if ( weight == NULL ) return error_setInpError(ERR_MEMORY, "");
+            cells->weight = weight;
+            cells->size = n;
+        }
+
+        // --- add the cell to the subcatch's rain cells
+        cells->cell[cells->count] = m - 1;
+        cells->weight[cells->count] = x;
+        cells->count++;
+    }
+    return 0;
+}
+
+//=============================================================================
+
 void  subcatch_validate(int j)
 //
 //  Input:   j = subcatchment index
@@ -370,6 +433,12 @@ void  subcatch_validate(int j)
     if ( Subcatch[j].outNode >= 0 && Subcatch[j].outSubcatch >= 0 )
         report_writeErrorMsg(ERR_SUBCATCH_OUTLET, Subcatch[j].ID);
 
+    // --- check that rain grid cells are only used with a rain grid gage
+    if ( Subcatch[j].rainCells.count > 0 &&
+         (Subcatch[j].gage < 0 ||
+          Gage[Subcatch[j].gage].dataSource != RAIN_GRID) )
+        report_writeErrorMsg(ERR_RAIN_GRID_CELLS, Subcatch[j].ID);
+
     // --- validate subcatchment's groundwater component 
     gwater_validate(j);
 
@@ -767,7 +836,7 @@ void getNetPrecip(int j, double* netPrecip, double tStep)
     k = Subcatch[j].gage;
     if ( k >= 0 )
     {
-        gage_getPrecip(k, &rainfall, &snowfall);
+        gage_getCellPrecip(k, &Subcatch[j].rainCells, &rainfall, &snowfall);
     }
 
     // --- assign total precip. rate to subcatch's rainfall property
@@ -867,7 +936,8 @@ void  subcatch_getResults(int j, double f, float x[])
 
     // --- retrieve rainfall for current report period
     k = Subcatch[j].gage;
-    if ( k >= 0 ) x[SUBCATCH_RAINFALL] = (float)Gage[k].reportRainfall;
+    if ( k >= 0 ) x[SUBCATCH_RAINFALL] =
+                  (float)gage_getCellReportRainfall(k, &Subcatch[j].rainCells);
     else          x[SUBCATCH_RAINFALL] = 0.0f;
 
     // --- retrieve snow depth
@@ -104,6 +104,7 @@
 #include <math.h>
 #include <time.h>
 #include <float.h>
+#include <sys/stat.h>
 
 //-----------------------------------------------------------------------------
 //  SWMM's header files
@@ -161,6 +162,31 @@ static int  ExceptionCount;       // number of exceptions handled
 static int  DoRunoff;             // TRUE if runoff is computed
 static int  DoRouting;            // TRUE if flow routing is computed
 
+//-----------------------------------------------------------------------------
+//  Conditions that stop a multi-step advance of the simulation
+//-----------------------------------------------------------------------------
+typedef struct
+{
+    int     type;                 // SM_NODE, SM_LINK, SM_SUBCATCH or SM_CONTROL
+    int     index;                // index of object
+    int     result;               // result code of object
+    int     relation;             // 1 = rises to or above, -1 = falls to or below
+    double  threshold;            // value of result that stops the simulation
+    int     isMet;                // TRUE if condition held after last step
+}  TStopCondition;
+
+static TStopCondition* StopConditions;     // registered stop conditions
+static int  NumStopConditions;    // number of stop conditions
+static int  MaxStopConditions;    // number of conditions array can hold
+static int  FiredCondition;       // condition that stopped last advance
+
+//-----------------------------------------------------------------------------
+//  User functions called at points within each time step
+//-----------------------------------------------------------------------------
+static SM_StepCallback StepCallbacks[NUM_STEP_POINTS];  // callback functions
+static void* StepCallbackData[NUM_STEP_POINTS];         // user's data
+static int   InStepCallback;      // TRUE while a step callback is running
+
 //-----------------------------------------------------------------------------
 //  External functions (prototyped in swmm5.h)
 //-----------------------------------------------------------------------------
@@ -168,6 +194,12 @@ static int  DoRouting;            // TRUE if flow routing is computed
 //  swmm_open
 //  swmm_start
 //  swmm_step
+//  swmm_stepN
+//  swmm_stepUntil
+//  swmm_addStopCondition
+//  swmm_clearStopConditions
+//  swmm_getStopCondition
+//  swmm_setStepCallback
 //  swmm_end
 //  swmm_report
 //  swmm_close
@@ -178,6 +210,8 @@ static int  DoRouting;            // TRUE if flow routing is computed
 //  Local functions
 //-----------------------------------------------------------------------------
 static void execRouting(void);                                                 //(5.1.011)
+static int  advance(long nSteps, double untilTime, double* elapsedTime);
+static int  isStopConditionMet(TStopCondition* c, long actionCount);
 
 // Exception filtering function
 #ifdef EXH                                                                     //(5.1.011)
@@ -297,6 +331,9 @@ int DLLEXPORT  swmm_run(char* f1, char* f2, char* f3)
     long theDay, theHour;
     double elapsedTime = 0.0;                                                  //(5.1.011)
 
+    // --- a step callback may not run, end or close the simulation
+    if ( InStepCallback ) return error_getCode(ERR_API_IN_CALLBACK);
+
     // --- open the files & read input data
     ErrorCode = 0;
     swmm_open(f1, f2, f3);
@@ -354,6 +391,8 @@ int DLLEXPORT swmm_open(char* f1, char* f2, char* f3)
 //  Purpose: opens a SWMM project.
 //
 {
+    // --- a step callback may not run, end or close the simulation
+    if ( InStepCallback ) return error_getCode(ERR_API_IN_CALLBACK);
 
 	#ifndef __unix__
 	#ifdef DLL
@@ -414,6 +453,9 @@ int DLLEXPORT swmm_start(int saveResults)
 //  Purpose: starts a SWMM simulation.
 //
 {
+    // --- a step callback may not run, end or close the simulation
+    if ( InStepCallback ) return error_getCode(ERR_API_IN_CALLBACK);
+
     // --- check that a project is open & no run started
     if ( ErrorCode ) return error_getCode(ErrorCode);                          //(5.1.011)
     if ( !IsOpenFlag || IsStartedFlag )
@@ -440,6 +482,7 @@ int DLLEXPORT swmm_start(int saveResults)
         ReportTime =   (double)(1000 * ReportStep);
         StepCount = 0;
         NonConvergeCount = 0;
+        RuleActionCount = 0;
         IsStartedFlag = TRUE;
 
         // --- initialize global continuity errors
@@ -505,6 +548,9 @@ int DLLEXPORT swmm_step(double* elapsedTime)                                   /
 //  Purpose: advances the simulation by one routing time step.
 //
 {
+    // --- a step callback may not run, end or close the simulation
+    if ( InStepCallback ) return error_getCode(ERR_API_IN_CALLBACK);
+
     // --- check that simulation can proceed
     if ( ErrorCode ) return error_getCode(ErrorCode);                          //(5.1.011)
     if ( !IsOpenFlag || !IsStartedFlag  )
@@ -531,6 +577,9 @@ int DLLEXPORT swmm_step(double* elapsedTime)                                   /
         if ( NewRoutingTime >= ReportTime )
         {
             if ( SaveResultsFlag ) output_saveResults(ReportTime);
+
+            // --- user's callback is called whether or not results are saved
+            callStepCallback(AT_REPORT_TIME, ReportTime);
             ReportTime = ReportTime + (double)(1000 * ReportStep);
         }
 
@@ -557,6 +606,244 @@ int DLLEXPORT swmm_step(double* elapsedTime)                                   /
 
 //=============================================================================
 
+int DLLEXPORT swmm_stepN(int n, double* elapsedTime)
+//
+//  Input:   n = number of routing time steps to take
+//  Output:  elapsedTime = current elapsed time in decimal days (0 when the
+//           simulation has ended),
+//           returns error code
+//  Purpose: advances the simulation by up to n routing time steps, stopping
+//           early if the simulation ends or a stop condition is met.
+//
+{
+    // --- a step callback may not run, end or close the simulation
+    if ( InStepCallback ) return error_getCode(ERR_API_IN_CALLBACK);
+
+    if ( n < 0 && !ErrorCode )
+    {
+        report_writeErrorMsg(ERR_API_OUTBOUNDS, "");
+        return error_getCode(ErrorCode);
+    }
+    return advance(n, -1.0, elapsedTime);
+}
+
+//=============================================================================
+
+int DLLEXPORT swmm_stepUntil(double targetTime, double* elapsedTime)
+//
+//  Input:   targetTime = elapsed time to advance to (decimal days)
+//  Output:  elapsedTime = current elapsed time in decimal days (0 when the
+//           simulation has ended),
+//           returns error code
+//  Purpose: advances the simulation by as many routing time steps as needed
+//           to reach targetTime, stopping early if the simulation ends or a
+//           stop condition is met.
+//
+{
+    // --- a step callback may not run, end or close the simulation
+    if ( InStepCallback ) return error_getCode(ERR_API_IN_CALLBACK);
+
+    if ( targetTime < 0.0 && !ErrorCode )
+    {
+        report_writeErrorMsg(ERR_API_OUTBOUNDS, "");
+        return error_getCode(ErrorCode);
+    }
+    return advance(-1, targetTime, elapsedTime);
+}
+
+//=============================================================================
+
+int advance(long nSteps, double untilTime, double* elapsedTime)
+//
+//  Input:   nSteps = maximum number of routing steps (-1 if no limit)
+//           untilTime = elapsed time to advance to (days) (-1 if no target)
+//  Output:  elapsedTime = current elapsed time in decimal days,
+//           returns error code
+//  Purpose: takes routing time steps until a step limit or target time is
+//           reached, the simulation ends, or a stop condition is met.
+//
+{
+    int  i;
+    int  errcode = 0;
+    long step;
+    long actionCount;
+
+    // --- note which stop conditions already hold
+    FiredCondition = -1;
+    *elapsedTime = ElapsedTime;
+    if ( ErrorCode ) return error_getCode(ErrorCode);
+    if ( !IsOpenFlag || !IsStartedFlag  )
+    {
+        report_writeErrorMsg(ERR_NOT_OPEN, "");
+        return error_getCode(ErrorCode);
+    }
+    actionCount = RuleActionCount;
+    for (i = 0; i < NumStopConditions; i++)
+    {
+        StopConditions[i].isMet =
+            isStopConditionMet(&StopConditions[i], actionCount);
+    }
+
+    for (step = 0; nSteps < 0 || step < nSteps; step++)
+    {
+        if ( untilTime >= 0.0 && *elapsedTime >= untilTime ) break;
+        errcode = swmm_step(elapsedTime);
+        if ( errcode || *elapsedTime == 0.0 ) break;
+
+        // --- stop at the first condition that has become true
+        for (i = 0; i < NumStopConditions; i++)
+        {
+            if ( isStopConditionMet(&StopConditions[i], actionCount) )
+            {
+                if ( !StopConditions[i].isMet && FiredCondition < 0 )
+                    FiredCondition = i;
+                StopConditions[i].isMet = TRUE;
+            }
+            else StopConditions[i].isMet = FALSE;
+        }
+        actionCount = RuleActionCount;
+        if ( FiredCondition >= 0 ) break;
+    }
+    return errcode;
+}
+
+//=============================================================================
+
+int isStopConditionMet(TStopCondition* c, long actionCount)
+//
+//  Input:   c = a stop condition
+//           actionCount = number of control actions taken before last step
+//  Output:  returns TRUE if the condition holds at the current time
+//  Purpose: checks a stop condition against the current simulation state.
+//
+{
+    double value = 0.0;
+
+    switch ( c->type )
+    {
+      case SM_CONTROL:  return RuleActionCount > actionCount;
+      case SM_NODE:     swmm_getNodeResult(c->index, c->result, &value); break;
+      case SM_LINK:     swmm_getLinkResult(c->index, c->result, &value); break;
+      case SM_SUBCATCH: swmm_getSubcatchResult(c->index, c->result, &value);
+                        break;
+    }
+    if ( c->relation > 0 ) return value >= c->threshold;
+    return value <= c->threshold;
+}
+
+//=============================================================================
+
+int DLLEXPORT swmm_addStopCondition(int type, int index, int result,
+                                    int relation, double threshold)
+//
+//  Input:   type = SM_NODE, SM_LINK, SM_SUBCATCH or SM_CONTROL
+//           index = index of node, link or subcatchment
+//           result = result code of object (SM_NodeResult, SM_LinkResult
+//                    or SM_SubcResult)
+//           relation = 1 to stop when result rises to or above threshold,
+//                      -1 to stop when it falls to or below threshold
+//           threshold = value of result in user units
+//  Output:  returns API error code
+//  Purpose: registers a condition that stops swmm_stepN and swmm_stepUntil
+//           at the step in which it becomes true. A condition of type
+//           SM_CONTROL becomes true in any step in which a control rule
+//           action is taken (index, result, relation & threshold ignored).
+//
+{
+    int nObjects = 0;
+    int maxResult = 0;
+    TStopCondition* c;
+
+    if ( !IsOpenFlag ) return ERR_API_INPUTNOTOPEN;
+    switch ( type )
+    {
+      case SM_NODE:     nObjects = Nobjects[NODE];     maxResult = SM_COUPINFLOW;
+                        break;
+      case SM_LINK:     nObjects = Nobjects[LINK];     maxResult = SM_FROUDE;
+                        break;
+      case SM_SUBCATCH: nObjects = Nobjects[SUBCATCH]; maxResult = SM_SUBCSNOW;
+                        break;
+      case SM_CONTROL:  index = 0; result = 0; relation = 1; nObjects = 1;
+                        break;
+      default:          return ERR_API_WRONG_TYPE;
+    }
+    if ( index < 0 || index >= nObjects ) return ERR_API_OBJECT_INDEX;
+    if ( result < 0 || result > maxResult ) return ERR_API_OUTBOUNDS;
+    if ( relation != 1 && relation != -1 ) return ERR_API_OUTBOUNDS;
+
+    // --- grow the array of conditions if full
+    if ( NumStopConditions == MaxStopConditions )
+    {
+        c = (TStopCondition *) realloc(StopConditions,
+            (MaxStopConditions + 8) * sizeof(TStopCondition));
+        if ( c == NULL ) return ERR_MEMORY;
+        StopConditions = c;
+        MaxStopConditions += 8;
+    }
+    c = &StopConditions[NumStopConditions++];
+    c->type = type;
+    c->index = index;
+    c->result = result;
+    c->relation = relation;
+    c->threshold = threshold;
+    c->isMet = FALSE;
+    return 0;
+}
+
+//=============================================================================
+
+int DLLEXPORT swmm_clearStopConditions(void)
+//
+//  Input:   none
+//  Output:  returns API error code
+//  Purpose: removes all registered stop conditions.
+//
+{
+    FREE(StopConditions);
+    NumStopConditions = 0;
+    MaxStopConditions = 0;
+    FiredCondition = -1;
+    return 0;
+}
+
+//=============================================================================
+
+int DLLEXPORT swmm_getStopCondition(int* condition)
+//
+//  Input:   none
+//  Output:  condition = index of stop condition (in order of registration)
+//           that ended the last call to swmm_stepN or swmm_stepUntil, or -1
+//           if none did
+//           returns API error code
+//  Purpose: identifies the stop condition that ended a multi-step advance.
+//
+{
+    *condition = FiredCondition;
+    return 0;
+}
+
+//=============================================================================
+
+int DLLEXPORT swmm_setStepCallback(int point, SM_StepCallback callback,
+                                   void* userData)
+//
+//  Input:   point = point in a time step at which callback is called
+//                   (SM_StepPoint code)
+//           callback = user function to call (NULL to remove the callback)
+//           userData = pointer passed back to the callback
+//  Output:  returns API error code
+//  Purpose: registers a function to be called at a given point in each
+//           routing time step.
+//
+{
+    if ( point < 0 || point >= NUM_STEP_POINTS ) return ERR_API_OUTBOUNDS;
+    StepCallbacks[point] = callback;
+    StepCallbackData[point] = userData;
+    return 0;
+}
+
+//=============================================================================
+
 void execRouting()                                                             //(5.1.011)
 //
 //  Input:   none                                                              //(5.1.011)
@@ -630,6 +917,9 @@ int DLLEXPORT swmm_end(void)
 //  Purpose: ends a SWMM simulation.
 //
 {
+    // --- a step callback may not run, end or close the simulation
+    if ( InStepCallback ) return error_getCode(ERR_API_IN_CALLBACK);
+
     // --- check that project opened and run started
     if ( !IsOpenFlag )
     {
@@ -670,6 +960,9 @@ int DLLEXPORT swmm_report()
 //  Purpose: writes simulation results to report file.
 //
 {
+    // --- a step callback may not run, end or close the simulation
+    if ( InStepCallback ) return error_getCode(ERR_API_IN_CALLBACK);
+
     if ( Fout.mode == SCRATCH_FILE ) output_checkFileSize();
     if ( ErrorCode ) report_writeErrorCode();
     else
@@ -689,6 +982,11 @@ int DLLEXPORT swmm_close()
 //  Purpose: closes a SWMM project.
 //
 {
+    int i;
+
+    // --- a step callback may not run, end or close the simulation
+    if ( InStepCallback ) return error_getCode(ERR_API_IN_CALLBACK);
+
     if ( Fout.file ) output_close();
     if ( IsOpenFlag ) project_close();
     report_writeSysTime();
@@ -699,6 +997,8 @@ int DLLEXPORT swmm_close()
         fclose(Fout.file);
         if ( Fout.mode == SCRATCH_FILE ) remove(Fout.name);
     }
+    swmm_clearStopConditions();
+    for (i = 0; i < NUM_STEP_POINTS; i++) swmm_setStepCallback(i, NULL, NULL);
     IsOpenFlag = FALSE;
     IsStartedFlag = FALSE;
     return 0;
@@ -907,6 +1207,28 @@ char* getTempFileName(char* fname)
 
 //=============================================================================
 
+int getFileStamp(char* fname, double* size, double* mtime)
+//
+//  Input:   fname = name of a file
+//  Output:  size = size of the file (bytes)
+//           mtime = time when the file was last modified
+//           returns TRUE if the file exists, FALSE if not
+//  Purpose: identifies the current version of a data file so that
+//           results derived from it can be re-used while it is unchanged.
+//
+{
+    struct stat info;
+
+    *size = -1.0;
+    *mtime = -1.0;
+    if ( stat(fname, &info) != 0 ) return FALSE;
+    *size = (double)info.st_size;
+    *mtime = (double)info.st_mtime;
+    return TRUE;
+}
+
+//=============================================================================
+
 void getElapsedTime(DateTime aDate, int* days, int* hrs, int* mins)
 //
 //  Input:   aDate = simulation calendar date + time
@@ -945,6 +1267,23 @@ DateTime getDateTime(double elapsedMsec)
 
 //=============================================================================
 
+void callStepCallback(int point, double elapsedMsec)
+//
+//  Input:   point = point in the time step reached (StepPointType code)
+//           elapsedMsec = elapsed milliseconds of simulation time
+//  Output:  none
+//  Purpose: calls the user function registered for a point in a time step.
+//
+{
+    if ( StepCallbacks[point] == NULL ) return;
+    InStepCallback = TRUE;
+    StepCallbacks[point](point, elapsedMsec / MSECperDAY,
+                         StepCallbackData[point]);
+    InStepCallback = FALSE;
+}
+
+//=============================================================================
+
 void  writecon(char *s)
 //
 //  Input:   s = a character string
@@ -13,8 +13,26 @@
 //   Curve and Time Series objects in SWMM 5 are both modeled with
 //   TTable data structures.
 //
-//   The table_getFirstEntry and table_getNextEntry functions, as well as the
-//   Time Series functions that use them, are not thread safe.
+//   The x and y values of a table are held in a pair of arrays, which the
+//   Curve lookup functions search by bisection. The table_getFirstEntry and
+//   table_getNextEntry functions, as well as the Time Series functions that
+//   use them, move a table's current position and are not thread safe.
+//
+//   The data of a time series stored in an external file is read into a
+//   pair of arrays that are shared, unchanged, by every time series of the
+//   project that uses the same file. The arrays are freed when the project
+//   is closed. When the TIMESERIES_CACHE option is used, they are also saved
+//   to a binary cache file, named after the time series file with ".tsb"
+//   appended, that any later run (or project opened afterwards) can read in
+//   place of the time series file as long as the file is not modified. Its
+//   layout is:
+//     File stamp ("SWMM5-TSER") (10 bytes)
+//     Size & last modification time of time series file (2 8-byte doubles)
+//     Date given to entries without a date (8-byte double)
+//     Number of entries (4-byte int)
+//     1 if all of time series file was read, 0 if not (4-byte int)
+//     Date of each entry (8-byte doubles)
+//     Value of each entry (8-byte doubles)
 //
 //   Build 5.1.008:
 //   - The lookup functions used for Curve tables (table_lookup, table_lookupEx,
@@ -30,12 +48,24 @@
 #include <string.h>
 #include "headers.h"
 
+//-----------------------------------------------------------------------------
+//  Shared variables
+//-----------------------------------------------------------------------------
+static TTableData** SharedData;        // data read from time series files
+static int          NumSharedData;     // number of time series files read
+
 //-----------------------------------------------------------------------------
 //  Local functions
 //-----------------------------------------------------------------------------
 int    table_getNextFileEntry(TTable* table, double* x, double* y);
 int    table_parseFileLine(char* line, TTable* table, double* x, double* y);
 double table_interpolate(double x, double x1, double y1, double x2, double y2);//(5.1.008)
+static TTableData* getSharedData(TTable* table);
+static int  readDataFile(TTable* table, TTableData* data);
+static int  readCacheFile(TTableData* data);
+static void writeCacheFile(TTableData* data);
+static void deleteData(TTableData* data);
+static int  findEntry(double* v, int n, double x);
 
 
 //=============================================================================
@@ -203,15 +233,24 @@ int table_addEntry(TTable* table, double x, double y)
 //  Purpose: adds a new x/y entry to a table.
 //
 {
-    TTableEntry *entry;
-    entry = (TTableEntry *) malloc(sizeof(TTableEntry));
-    if ( !entry ) return FALSE;
-    entry->x = x;
-    entry->y = y;
-    entry->next = NULL;
-    if ( table->firstEntry == NULL )  table->firstEntry = entry;
-    else table->lastEntry->next = entry;
-    table->lastEntry = entry;
+    int     n;
+    double* xData;
+    double* yData;
+
+    // --- enlarge the table's arrays if they are full
+    if ( table->nEntries == table->maxEntries )
+    {
+        n = (table->maxEntries == 0) ? 16 : 2 * table->maxEntries;
+        xData = (double *) realloc(table->xData, n * sizeof(double));
+        if ( xData ) table->xData = xData;
+        yData = (double *) realloc(table->yData, n * sizeof(double));
+        if ( yData ) table->yData = yData;
+        if ( !xData || !yData ) return FALSE;
+        table->maxEntries = n;
+    }
+    table->xData[table->nEntries] = x;
+    table->yData[table->nEntries] = y;
+    table->nEntries++;
     return TRUE;
 }
 
@@ -224,18 +263,18 @@ void   table_deleteEntries(TTable *table)
 //  Purpose: deletes all x/y entries in a table.
 //
 {
-    TTableEntry *entry;
-    TTableEntry *nextEntry;
-    entry = table->firstEntry;
-    while (entry)
+    // --- shared data from an external file is freed by table_deleteSharedData
+    if ( table->data == NULL )
     {
-        nextEntry = entry->next;
-        free(entry);
-        entry = nextEntry;
+        FREE(table->xData);
+        FREE(table->yData);
     }
-    table->firstEntry = NULL;
-    table->lastEntry  = NULL;
-    table->thisEntry  = NULL;
+    table->xData = NULL;
+    table->yData = NULL;
+    table->nEntries = 0;
+    table->maxEntries = 0;
+    table->thisEntry = 0;
+    table->data = NULL;
 
     if (table->file.file)
     { 
@@ -246,6 +285,22 @@ void   table_deleteEntries(TTable *table)
 
 //=============================================================================
 
+void table_deleteSharedData()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the data read from all time series files.
+//
+{
+    int i;
+
+    for (i = 0; i < NumSharedData; i++) deleteData(SharedData[i]);
+    FREE(SharedData);
+    NumSharedData = 0;
+}
+
+//=============================================================================
+
 void   table_init(TTable *table)
 //
 //  Input:   table = pointer to a TTable structure
@@ -255,9 +310,11 @@ void   table_init(TTable *table)
 {
     table->ID = NULL;
     table->refersTo = -1;
-    table->firstEntry = NULL;
-    table->lastEntry = NULL;
-    table->thisEntry = table->firstEntry;
+    table->nEntries = 0;
+    table->maxEntries = 0;
+    table->thisEntry = 0;
+    table->xData = NULL;
+    table->yData = NULL;
     table->lastDate = 0.0;
     table->x1 = 0.0;
     table->x2 = 0.0;
@@ -266,6 +323,7 @@ void   table_init(TTable *table)
     table->dxMin = 0.0;
     table->file.mode = NO_FILE;
     table->file.file = NULL;
+    table->data = NULL;
     table->curveType = -1;
 }
 
@@ -278,39 +336,52 @@ int   table_validate(TTable *table)
 //  Purpose: checks that table's x-values are in ascending order.
 //
 {
-    int    result;
-    double x1, x2, y1, y2;
-    double dx, dxMin = BIG;
+    int     i;
+    double  dx, dxMin = BIG;
+    double* xData;
+    double* yData;
 
-    // --- open external file if used as the table's data source
+    // --- use the data of external file if it is the table's data source
     if ( table->file.mode == USE_FILE )
     {
-        table->file.file = fopen(table->file.name, "rt");
-        if ( table->file.file == NULL ) return ERR_TABLE_FILE_OPEN;
+        table->data = getSharedData(table);
+        if ( table->data == NULL ) return ERR_TABLE_FILE_OPEN;
+        table->xData = table->data->x;
+        table->yData = table->data->y;
+        table->nEntries = table->data->count;
+        table->maxEntries = table->data->count;
+
+        // --- return error condition if external file has no valid data
+        if ( table->nEntries == 0 ) return ERR_TABLE_FILE_READ;
     }
 
-    // --- retrieve the first data entry in the table
-    result = table_getFirstEntry(table, &x1, &y1);
-
-    // --- return error condition if external file has no valid data
-    if ( !result && table->file.mode == USE_FILE ) return ERR_TABLE_FILE_READ;
+    // --- otherwise release the unused part of the table's arrays
+    else if ( table->nEntries > 0 && table->nEntries < table->maxEntries )
+    {
+        xData = (double *) realloc(table->xData,
+                                   table->nEntries * sizeof(double));
+        if ( xData ) table->xData = xData;
+        yData = (double *) realloc(table->yData,
+                                   table->nEntries * sizeof(double));
+        if ( yData ) table->yData = yData;
+        if ( xData && yData ) table->maxEntries = table->nEntries;
+    }
 
-    // --- retrieve successive table entries and check for non-increasing x-values
-    while ( table_getNextEntry(table, &x2, &y2) )
+    // --- check for non-increasing x-values
+    for (i = 1; i < table->nEntries; i++)
     {
-        dx = x2 - x1;
+        dx = table->xData[i] - table->xData[i-1];
         if ( dx <= 0.0 )
         {
-            table->x2 = x2;
+            table->x2 = table->xData[i];
             return ERR_CURVE_SEQUENCE;
         }
         dxMin = MIN(dxMin, dx);
-        x1 = x2;
     }
     table->dxMin = dxMin;
 
     // --- return error if external file could not be read completely
-    if ( table->file.mode == USE_FILE && !feof(table->file.file) )
+    if ( table->file.mode == USE_FILE && !table->data->isComplete )
         return ERR_TABLE_FILE_READ;
     return 0;
 }
@@ -325,29 +396,16 @@ int table_getFirstEntry(TTable *table, double *x, double *y)
 //           returns TRUE if successful, FALSE if not
 //  Purpose: retrieves the first x/y entry in a table.
 //
-//  NOTE: also moves the current position pointer (thisEntry) to the 1st entry.
+//  NOTE: also moves the current position (thisEntry) to the 1st entry.
 //
 {
-    TTableEntry *entry;
     *x = 0;
     *y = 0.0;
-
-    if ( table->file.mode == USE_FILE )
-    {
-        if ( table->file.file == NULL ) return FALSE;
-        rewind(table->file.file);
-        return table_getNextFileEntry(table, x, y);
-    }
-
-    entry = table->firstEntry;
-    if ( entry )
-    {
-        *x = entry->x;
-        *y = entry->y;
-        table->thisEntry = entry;
-        return TRUE;
-    }
-    else return FALSE;
+    table->thisEntry = 0;
+    if ( table->nEntries == 0 ) return FALSE;
+    *x = table->xData[0];
+    *y = table->yData[0];
+    return TRUE;
 }
 
 //=============================================================================
@@ -360,23 +418,38 @@ int table_getNextEntry(TTable *table, double *x, double *y)
 //           returns TRUE if successful, FALSE if not
 //  Purpose: retrieves the next x/y entry in a table.
 //
-//  NOTE: also updates the current position pointer (thisEntry).
+//  NOTE: also updates the current position (thisEntry).
 //
 {
-    TTableEntry *entry;
+    int i = table->thisEntry + 1;
+    if ( i >= table->nEntries ) return FALSE;
+    *x = table->xData[i];
+    *y = table->yData[i];
+    table->thisEntry = i;
+    return TRUE;
+}
 
-    if ( table->file.mode == USE_FILE )
-        return table_getNextFileEntry(table, x, y);
-    
-    entry = table->thisEntry->next;
-    if ( entry )
+//=============================================================================
+
+int findEntry(double* v, int n, double x)
+//
+//  Input:   v = array of values in ascending order
+//           n = number of values
+//           x = a value
+//  Output:  returns index of first of v[1] to v[n-1] that is >= x
+//           (or n if there is none)
+//  Purpose: uses a binary search to find the entry that ends the table
+//           interval containing x.
+//
+{
+    int lo = 1, hi = n, mid;
+    while ( lo < hi )
     {
-        *x = entry->x;
-        *y = entry->y;
-        table->thisEntry = entry;
-        return TRUE;
+        mid = (lo + hi) / 2;
+        if ( v[mid] < x ) lo = mid + 1;
+        else hi = mid;
     }
-    else return FALSE;
+    return lo;
 }
 
 //=============================================================================
@@ -396,24 +469,15 @@ double table_lookup(TTable *table, double x)
 //        returned.
 //
 {
-    double x1,y1,x2,y2;
-    TTableEntry* entry;
-
-    entry = table->firstEntry;
-    if ( entry == NULL ) return 0.0;
-    x1 = entry->x;
-    y1 = entry->y;
-    if ( x <= x1 ) return y1;
-    while ( entry->next )
-    {
-        entry = entry->next;
-        x2 = entry->x;
-        y2 = entry->y;
-        if ( x <= x2 ) return table_interpolate(x, x1, y1, x2, y2);
-        x1 = x2;
-        y1 = y2;
-    }
-    return y1;
+    int     i, n = table->nEntries;
+    double* xx = table->xData;
+    double* yy = table->yData;
+
+    if ( n == 0 ) return 0.0;
+    if ( x <= xx[0] ) return yy[0];
+    i = findEntry(xx, n, x);
+    if ( i == n ) return yy[n-1];
+    return table_interpolate(x, xx[i-1], yy[i-1], xx[i], yy[i]);
 }
 
 //=============================================================================
@@ -428,28 +492,17 @@ double table_getSlope(TTable *table, double x)
 //  Purpose: retrieves the slope of the curve at the line segment containing x.
 //
 {
-    double x1,y1,x2,y2;
-    double dx;
-    TTableEntry* entry;
-
-    entry = table->firstEntry;
-    if ( entry == NULL ) return 0.0;
-    x1 = entry->x;
-    y1 = entry->y;
-    x2 = x1;
-    y2 = y1;
-    while ( entry->next )
-    {
-        entry = entry->next;
-        x2 = entry->x;
-        y2 = entry->y;
-        if ( x <= x2 ) break;
-        x1 = x2;
-        y1 = y2;
-    }
-    dx = x2 - x1;
+    int     i, n = table->nEntries;
+    double* xx = table->xData;
+    double* yy = table->yData;
+    double  dx;
+
+    // --- slope is 0 beyond the last table entry
+    i = findEntry(xx, n, x);
+    if ( i >= n ) return 0.0;
+    dx = xx[i] - xx[i-1];
     if ( dx == 0.0 ) return 0.0;
-    return (y2 - y1) / dx;
+    return (yy[i] - yy[i-1]) / dx;
 }
 
 //=============================================================================
@@ -466,31 +519,25 @@ double table_lookupEx(TTable *table, double x)
 //           extrapolation outside of the table.
 //
 {
-    double x1,y1,x2,y2;
-    double s = 0.0;
-    TTableEntry* entry;
-
-    entry = table->firstEntry;
-    if (entry == NULL ) return 0.0;
-    x1 = entry->x;
-    y1 = entry->y;
-    if ( x <= x1 )
-    {
-        if (x1 > 0.0 ) return x/x1*y1;
-        else return y1;
-    }
-    while ( entry->next )
-    {
-        entry = entry->next;
-        x2 = entry->x;
-        y2 = entry->y;
-        if ( x2 != x1 ) s = (y2 - y1) / (x2 - x1);
-        if ( x <= x2 ) return table_interpolate(x, x1, y1, x2, y2);
-        x1 = x2;
-        y1 = y2;
+    int     i, n = table->nEntries;
+    double* xx = table->xData;
+    double* yy = table->yData;
+    double  s = 0.0;
+
+    if ( n == 0 ) return 0.0;
+    if ( x <= xx[0] )
+    {
+        if ( xx[0] > 0.0 ) return x/xx[0]*yy[0];
+        else return yy[0];
     }
+    i = findEntry(xx, n, x);
+    if ( i < n ) return table_interpolate(x, xx[i-1], yy[i-1], xx[i], yy[i]);
+
+    // --- extrapolate with the slope of the last table interval
+    if ( n > 1 && xx[n-1] != xx[n-2] )
+        s = (yy[n-1] - yy[n-2]) / (xx[n-1] - xx[n-2]);
     if ( s < 0.0 ) s = 0.0;
-    return y1 + s*(x - x1);
+    return yy[n-1] + s*(x - xx[n-1]);
 }
 
 //=============================================================================
@@ -506,17 +553,20 @@ double table_intervalLookup(TTable *table, double x)
 //           whose x-value is > x.
 //
 {
-    TTableEntry* entry;
+    int     lo = 0, hi, mid, n = table->nEntries;
+    double* xx = table->xData;
+
+    if ( n == 0 ) return 0.0;
 
-    entry = table->firstEntry;
-    if (entry == NULL ) return 0.0;
-    if ( x < entry->x ) return entry->y;
-    while ( entry->next )
+    // --- binary search for first entry whose x-value is > x
+    hi = n - 1;
+    while ( lo < hi )
     {
-        entry = entry->next;
-        if ( x < entry->x ) return entry->y;
+        mid = (lo + hi) / 2;
+        if ( x < xx[mid] ) hi = mid;
+        else lo = mid + 1;
     }
-    return entry->y;
+    return table->yData[lo];
 }
 
 //=============================================================================
@@ -535,25 +585,22 @@ double table_inverseLookup(TTable *table, double y)
 //        returned; if y is above the last entry, then the last x-value is
 //        returned.
 //
+//  NOTE: a table's y-values need not be in ascending order, so they are
+//        searched in sequence.
+//
 {
-    double x1,y1,x2,y2;
-    TTableEntry* entry;
-
-    entry = table->firstEntry;
-    if (entry == NULL ) return 0.0;
-    x1 = entry->x;
-    y1 = entry->y;
-    if ( y <= y1 ) return x1;
-    while ( entry->next )
-    {
-        entry = entry->next;
-        x2 = entry->x;
-        y2 = entry->y;
-        if ( y <= y2 ) return table_interpolate(y, y1, x1, y2, x2);
-        x1 = x2;
-        y1 = y2;
+    int     i, n = table->nEntries;
+    double* xx = table->xData;
+    double* yy = table->yData;
+
+    if ( n == 0 ) return 0.0;
+    if ( y <= yy[0] ) return xx[0];
+    for (i = 1; i < n; i++)
+    {
+        if ( y <= yy[i] )
+            return table_interpolate(y, yy[i-1], xx[i-1], yy[i], xx[i]);
     }
-    return x1;
+    return xx[n-1];
 }
 
 //=============================================================================
@@ -569,16 +616,15 @@ double  table_getMaxY(TTable *table, double x)
 //           portion of a table that appear before value x.
 //
 {
-    double ymax;
-    TTableEntry* entry;
+    int     i, n = table->nEntries;
+    double  ymax;
 
-    entry = table->firstEntry;
-    ymax = entry->y;
-    while ( x > entry->x && entry->next )
+    if ( n == 0 ) return 0.0;
+    ymax = table->yData[0];
+    for (i = 1; i < n && x > table->xData[i-1]; i++)
     {
-        entry = entry->next;
-        if ( entry->y < ymax ) return ymax;
-        ymax = entry->y;
+        if ( table->yData[i] < ymax ) return ymax;
+        ymax = table->yData[i];
     }
     return 0.0;
 }
@@ -605,28 +651,26 @@ double  table_getArea(TTable* table, double x)
 //     a(i) = y(i)*dx + s*dx*dx/2
 //
 {
+    int    i, n = table->nEntries;
     double x1, x2;
     double y1, y2;
     double dx = 0.0, dy = 0.0;
     double a, s = 0.0;
-    TTableEntry* entry;
 
     // --- get area up to first table entry
     //     and see if x-value lies in this interval
-    entry = table->firstEntry;
-    if (entry == NULL ) return 0.0;
-    x1 = entry->x;
-    y1 = entry->y;
+    if ( n == 0 ) return 0.0;
+    x1 = table->xData[0];
+    y1 = table->yData[0];
     if ( x1 > 0.0 ) s = y1/x1;
     if ( x <= x1 ) return s*x*x/2.0;
     a = y1*x1/2.0;
     
     // --- add next table entry to area until target x-value is bracketed
-    while ( entry->next )
+    for (i = 1; i < n; i++)
     {
-        entry = entry->next;
-        x2 = entry->x;
-        y2 = entry->y;
+        x2 = table->xData[i];
+        y2 = table->yData[i];
         dx = x2 - x1;
         dy = y2 - y1;
         if ( x <= x2 )
@@ -661,17 +705,16 @@ double  table_getInverseArea(TTable* table, double a)
 //  Refer to table_getArea function to see how area is computed.
 //
 {
+    int    i, n = table->nEntries;
     double x1, x2;
     double y1, y2;
     double dx = 0.0, dy = 0.0;
     double a1, a2, s;
-    TTableEntry* entry;
 
     // --- see if target area is below that of 1st table entry
-    entry = table->firstEntry;
-    if (entry == NULL ) return 0.0;
-    x1 = entry->x;
-    y1 = entry->y;
+    if ( n == 0 ) return 0.0;
+    x1 = table->xData[0];
+    y1 = table->yData[0];
     a1 = y1*x1/2.0;
     if ( a <= a1 )
     {
@@ -680,11 +723,10 @@ double  table_getInverseArea(TTable* table, double a)
     }
 
     // --- add next table entry to area until target area is bracketed
-    while ( entry->next )
+    for (i = 1; i < n; i++)
     {
-        entry = entry->next;
-        x2 = entry->x;
-        y2 = entry->y;
+        x2 = table->xData[i];
+        y2 = table->yData[i];
         dx = x2 - x1;
         dy = y2 - y1;
         a2 = a1 + y1*dx + dy*dx/2.0;
@@ -731,6 +773,149 @@ double  table_getInverseArea(TTable* table, double a)
 
 //=============================================================================
 
+void  table_getAreas(TTable* table, double* areas)
+//
+//  Input:   table = pointer to a TTable structure
+//           areas = array with an entry for each table entry
+//  Output:  areas = area under the curve from 0 to each table entry's x-value
+//  Purpose: integrates a tabulated curve up to each of its entries so that
+//           table_lookupArea and table_lookupInverseArea can find areas
+//           without re-integrating the curve.
+//
+//  Refer to table_getArea function to see how area is computed.
+//
+{
+    int     i, n = table->nEntries;
+    double* xx = table->xData;
+    double* yy = table->yData;
+
+    if ( n == 0 ) return;
+    areas[0] = yy[0]*xx[0]/2.0;
+    for (i = 1; i < n; i++)
+    {
+        areas[i] = areas[i-1] + (yy[i-1] + yy[i]) * (xx[i] - xx[i-1]) / 2.0;
+    }
+}
+
+//=============================================================================
+
+double  table_lookupArea(TTable* table, double* areas, double x)
+//
+//  Input:   table = pointer to a TTable structure
+//           areas = areas under the curve up to each table entry
+//           x = an value
+//  Output:  returns area value
+//  Purpose: finds area under a tabulated curve from 0 to x using the areas
+//           found by table_getAreas.
+//
+{
+    int     i, n = table->nEntries;
+    double* xx = table->xData;
+    double* yy = table->yData;
+    double  dx, y, s = 0.0;
+
+    // --- see if x-value lies below the first table entry
+    if ( n == 0 ) return 0.0;
+    if ( xx[0] > 0.0 ) s = yy[0]/xx[0];
+    if ( x <= xx[0] ) return s*x*x/2.0;
+
+    // --- add area within the table interval containing x
+    i = findEntry(xx, n, x);
+    if ( i < n )
+    {
+        dx = xx[i] - xx[i-1];
+        if ( dx <= 0.0 ) return areas[i-1];
+        y = table_interpolate(x, xx[i-1], yy[i-1], xx[i], yy[i]);
+        return areas[i-1] + (x - xx[i-1]) * (yy[i-1] + y) / 2.0;
+    }
+
+    // --- extrapolate area if table limit exceeded
+    s = 0.0;
+    if ( n > 1 && xx[n-1] > xx[n-2] )
+        s = (yy[n-1] - yy[n-2]) / (xx[n-1] - xx[n-2]);
+    dx = x - xx[n-1];
+    return areas[n-1] + yy[n-1]*dx + s*dx*dx/2.0;
+}
+
+//=============================================================================
+
+double  table_lookupInverseArea(TTable* table, double* areas, double a)
+//
+//  Input:   table = pointer to a TTable structure
+//           areas = areas under the curve up to each table entry
+//           a = an area value
+//  Output:  returns an x value
+//  Purpose: finds x value for given area under a curve using the areas
+//           found by table_getAreas.
+//
+{
+    int     i, n = table->nEntries;
+    double* xx = table->xData;
+    double* yy = table->yData;
+    double  x1, y1, a1, a2;
+    double  dx = 0.0, dy = 0.0, s;
+
+    // --- see if target area is below that of 1st table entry
+    if ( n == 0 ) return 0.0;
+    if ( a <= areas[0] )
+    {
+        if ( yy[0] > 0.0 ) return sqrt(2.0*a*xx[0]/yy[0]);
+        else return 0.0;
+    }
+
+    // --- solve for x within the table interval containing the target area
+    i = findEntry(areas, n, a);
+    if ( i < n )
+    {
+        x1 = xx[i-1];
+        y1 = yy[i-1];
+        a1 = areas[i-1];
+        a2 = areas[i];
+        dx = xx[i] - x1;
+        dy = yy[i] - y1;
+        if ( dx <= 0.0 ) return x1;
+        if ( dy == 0.0 )
+        {
+            if ( a2 == a1 ) return x1;
+            else return x1 + dx * (a - a1) / (a2 - a1);
+        }
+
+        // --- if y decreases with x then replace point 1 with point 2
+        if ( dy < 0.0 )
+        {
+            x1 = xx[i];
+            y1 = yy[i];
+            a1 = a2;
+        }
+        s = dy/dx;
+        return x1 + (sqrt(y1*y1 + 2.0*s*(a-a1)) - y1) / s;
+    }
+
+    // --- extrapolate area if table limit exceeded
+    x1 = xx[n-1];
+    y1 = yy[n-1];
+    a1 = areas[n-1];
+    if ( n > 1 )
+    {
+        dx = x1 - xx[n-2];
+        dy = y1 - yy[n-2];
+    }
+    if ( dx == 0.0 || dy == 0.0 )
+    {
+        if ( y1 > 0.0 ) dx = (a - a1) / y1;
+        else dx = 0.0;
+    }
+    else
+    {
+        s = dy/dx;
+        dx = (sqrt(y1*y1 + 2.0*s*(a-a1)) - y1) / s;
+        if (dx < 0.0) dx = 0.0;
+    }
+    return x1 + dx;
+}
+
+//=============================================================================
+
 void   table_tseriesInit(TTable *table)
 //
 //  Input:   table = pointer to a TTable structure
@@ -760,44 +945,40 @@ double table_tseriesLookup(TTable *table, double x, char extend)
 //        returned.
 //
 {
+    int     i, n = table->nEntries;
+    double* xx = table->xData;
+
     // --- x lies within current time bracket
     if ( table->x1 <= x
     &&   table->x2 >= x
     &&   table->x1 != table->x2 )
     return table_interpolate(x, table->x1, table->y1, table->x2, table->y2);
 
-    // --- x lies before current time bracket:
-    //     move to start of time series
-    if ( table->x1 == table->x2 || x < table->x1 )
+    // --- x lies before start of time series
+    if ( n == 0 ) return 0.0;
+    if ( x < xx[0] )
     {
-        table_getFirstEntry(table, &(table->x1), &(table->y1));
-        if ( x < table->x1 )
-        {
-            if ( extend == TRUE ) return table->y1;
-            else return 0;
-        }
+        if ( extend == TRUE ) return table->yData[0];
+        else return 0.0;
     }
 
-    // --- x lies beyond current time bracket:
-    //     update start of next time bracket
-    table->x1 = table->x2;
-    table->y1 = table->y2;
-
-    // --- get end of next time bracket
-    while ( table_getNextEntry(table, &(table->x2), &(table->y2)) )
+    // --- x lies beyond end of time series
+    if ( n == 1 || x > xx[n-1] )
     {
-        // --- x lies within the bracket
-        if ( x <= table->x2 )
-            return table_interpolate(x, table->x1, table->y1,
-                                        table->x2, table->y2);
-        // --- otherwise move to next time bracket
-        table->x1 = table->x2;
-        table->y1 = table->y2;
+        if ( extend == TRUE ) return table->yData[n-1];
+        else return 0.0;
     }
 
-    // --- return last value or 0 if beyond last data value
-    if ( extend == TRUE ) return table->y1;
-    else return 0.0;
+    // --- x lies in the time bracket following the current one or, if not,
+    //     in one found by a binary search of the series
+    i = table->thisEntry + 1;
+    if ( i < 1 || i >= n || x < xx[i-1] || x > xx[i] ) i = findEntry(xx, n, x);
+    table->thisEntry = i;
+    table->x1 = xx[i-1];
+    table->y1 = table->yData[i-1];
+    table->x2 = xx[i];
+    table->y2 = table->yData[i];
+    return table_interpolate(x, table->x1, table->y1, table->x2, table->y2);
 }
 
 //=============================================================================
@@ -890,3 +1071,217 @@ int  table_parseFileLine(char* line, TTable* table, double* x, double* y)
     *y = yy;
     return TRUE;
 }
+
+//=============================================================================
+
+TTableData* getSharedData(TTable* table)
+//
+//  Input:   table = pointer to a TTable structure
+//  Output:  returns pointer to data of table's external file (or NULL if
+//           the file can't be opened)
+//  Purpose: retrieves the data of a time series stored in an external file,
+//           reading the file only if it hasn't already been read.
+//
+{
+    int          i;
+    double       fileSize, fileTime;
+    TTableData*  data;
+    TTableData** sharedData;
+
+    if ( !getFileStamp(table->file.name, &fileSize, &fileTime) ) return NULL;
+
+    // --- look for data already read from the same, unchanged file
+    for (i = 0; i < NumSharedData; i++)
+    {
+        data = SharedData[i];
+        if ( strcmp(data->name, table->file.name) == 0 &&
+             data->startDate == table->lastDate )
+        {
+            if ( data->fileSize == fileSize && data->fileTime == fileTime )
+                return data;
+            break;
+        }
+    }
+
+    // --- read the file's data from its binary cache or from the file itself
+    data = (TTableData *) calloc(1, sizeof(TTableData));
+    if ( data == NULL ) return NULL;
+    sstrncpy(data->name, table->file.name, MAXFNAME);
+    data->fileSize = fileSize;
+    data->fileTime = fileTime;
+    data->startDate = table->lastDate;
+    if ( !TseriesCache || !readCacheFile(data) )
+    {
+        if ( !readDataFile(table, data) )
+        {
+            deleteData(data);
+            return NULL;
+        }
+        if ( TseriesCache ) writeCacheFile(data);
+    }
+
+    // --- replace out of date data or add the new data to the shared list
+    if ( i < NumSharedData )
+    {
+        deleteData(SharedData[i]);
+        SharedData[i] = data;
+        return data;
+    }
+    sharedData = (TTableData **) realloc(SharedData,
+                 (NumSharedData + 1) * sizeof(TTableData *));
+    if ( sharedData == NULL )
+    {
+        deleteData(data);
+        return NULL;
+    }
+    SharedData = sharedData;
+    SharedData[NumSharedData++] = data;
+    return data;
+}
+
+//=============================================================================
+
+int readDataFile(TTable* table, TTableData* data)
+//
+//  Input:   table = pointer to a TTable structure
+//           data = pointer to data of table's external file
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: reads the entries of a time series file into shared data arrays.
+//
+{
+    int     size = 0;
+    double  x, y;
+    double* xx;
+    double* yy;
+
+    table->file.file = fopen(table->file.name, "rt");
+    if ( table->file.file == NULL ) return FALSE;
+    while ( table_getNextFileEntry(table, &x, &y) )
+    {
+        if ( data->count == size )
+        {
+            size = (size == 0) ? 1024 : 2 * size;
+            xx = (double *) realloc(data->x, size * sizeof(double));
+            if ( xx ) data->x = xx;
+            yy = (double *) realloc(data->y, size * sizeof(double));
+            if ( yy ) data->y = yy;
+            if ( !xx || !yy ) break;
+        }
+        data->x[data->count] = x;
+        data->y[data->count] = y;
+        data->count++;
+    }
+
+    // --- reading stops before end of file at a line that can't be parsed
+    data->isComplete = feof(table->file.file) ? TRUE : FALSE;
+    fclose(table->file.file);
+    table->file.file = NULL;
+    return TRUE;
+}
+
+//=============================================================================
+
+int readCacheFile(TTableData* data)
+//
+//  Input:   data = pointer to data of a time series file
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: reads the data of a time series file from its binary cache file.
+//
+{
+    int      count = 0;
+    int      isComplete = 0;
+    int      result = FALSE;
+    double   fileSize = 0.0, fileTime = 0.0;
+    DateTime startDate = 0.0;
+    char     fname[MAXFNAME+5];
+    char     fStamp[] = "SWMM5-TSER";
+    char     fileStamp[] = "SWMM5-TSER";
+    FILE*    f;
+
+    sprintf(fname, "%s.tsb", data->name);
+    if ( (f = fopen(fname, "rb")) == NULL ) return FALSE;
+
+    // --- check that cache file was made from the current time series file
+    if ( fread(fStamp, sizeof(char), strlen(fileStamp), f) == strlen(fileStamp)
+    &&   strcmp(fStamp, fileStamp) == 0
+    &&   fread(&fileSize, sizeof(double), 1, f) == 1
+    &&   fread(&fileTime, sizeof(double), 1, f) == 1
+    &&   fread(&startDate, sizeof(DateTime), 1, f) == 1
+    &&   fread(&count, sizeof(int), 1, f) == 1
+    &&   fread(&isComplete, sizeof(int), 1, f) == 1
+    &&   fileSize == data->fileSize && fileTime == data->fileTime
+    &&   startDate == data->startDate && count >= 0 )
+    {
+        // --- read the entries' dates and values as two blocks
+        data->x = (double *) calloc(count + 1, sizeof(double));
+        data->y = (double *) calloc(count + 1, sizeof(double));
+        if ( data->x && data->y
+        &&   fread(data->x, sizeof(double), count, f) == (size_t)count
+        &&   fread(data->y, sizeof(double), count, f) == (size_t)count )
+        {
+            data->count = count;
+            data->isComplete = isComplete;
+            result = TRUE;
+        }
+        else
+        {
+            FREE(data->x);
+            FREE(data->y);
+        }
+    }
+    fclose(f);
+    return result;
+}
+
+//=============================================================================
+
+void writeCacheFile(TTableData* data)
+//
+//  Input:   data = pointer to data of a time series file
+//  Output:  none
+//  Purpose: saves the data of a time series file to its binary cache file.
+//
+//  Note: the file is written under a temporary name and then renamed so
+//        that runs sharing the cache never read a partly written file.
+//
+{
+    int   ok;
+    char  fname[MAXFNAME+5];
+    char  tmpName[MAXFNAME+6];
+    char  fileStamp[] = "SWMM5-TSER";
+    FILE* f;
+
+    sprintf(fname, "%s.tsb", data->name);
+    sprintf(tmpName, "%s~", fname);
+    if ( (f = fopen(tmpName, "wb")) == NULL ) return;
+    fwrite(fileStamp, sizeof(char), strlen(fileStamp), f);
+    fwrite(&data->fileSize, sizeof(double), 1, f);
+    fwrite(&data->fileTime, sizeof(double), 1, f);
+    fwrite(&data->startDate, sizeof(DateTime), 1, f);
+    fwrite(&data->count, sizeof(int), 1, f);
+    fwrite(&data->isComplete, sizeof(int), 1, f);
+    fwrite(data->x, sizeof(double), data->count, f);
+    fwrite(data->y, sizeof(double), data->count, f);
+    ok = !ferror(f);
+    ok = (fclose(f) == 0) && ok;
+    if ( ok )
+    {
+        remove(fname);
+        ok = (rename(tmpName, fname) == 0);
+    }
+    if ( !ok ) remove(tmpName);
+}
+
+//=============================================================================
+
+void deleteData(TTableData* data)
+//
+//  Input:   data = pointer to data of a time series file
+//  Output:  none
+//  Purpose: frees the memory used by the data of a time series file.
+//
+{
+    FREE(data->x);
+    FREE(data->y);
+    free(data);
+}
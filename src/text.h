@@ -101,6 +101,12 @@
 #define  w_IGNORE_RDII       "IGNORE_RDII"                                     //(5.1.004)
 #define  w_MIN_ROUTE_STEP    "MINIMUM_STEP"                                    //(5.1.008)
 #define  w_NUM_THREADS       "THREADS"                                         //(5.1.008)
+#define  w_TSERIES_CACHE     "TIMESERIES_CACHE"
+#define  w_TRANSPOSED_OUTPUT "TRANSPOSED_OUTPUT"
+#define  w_COMPRESSED_OUTPUT "COMPRESSED_OUTPUT"
+#define  w_OUTPUT_SUMMARY    "OUTPUT_SUMMARY"
+#define  w_RESULTS_STREAM    "RESULTS_STREAM"
+#define  w_STREAM_PERIODS    "STREAM_PERIODS"
 
 // Flow Units
 #define  w_CFS               "CFS"
@@ -157,6 +163,7 @@
 #define  w_INTENSITY         "INTENSITY"
 #define  w_VOLUME            "VOLUME"
 #define  w_CUMULATIVE        "CUMULATIVE"
+#define  w_GRID              "GRID"
 
 // Unit Hydrograph Types
 #define  w_SHORT             "SHORT"
@@ -309,6 +316,19 @@
 #define  w_CONTROLS          "CONTROL"
 #define  w_NODESTATS         "NODESTATS"
 
+// Output Profile Variables
+#define  w_SNOW_DEPTH        "SNOW_DEPTH"
+#define  w_EVAP              "EVAP"
+#define  w_INFIL             "INFIL"
+#define  w_GW_FLOW           "GW_FLOW"
+#define  w_GW_ELEV           "GW_ELEV"
+#define  w_SOIL_MOIST        "SOIL_MOIST"
+#define  w_LAT_INFLOW        "LAT_INFLOW"
+#define  w_INFLOW            "INFLOW"
+#define  w_FLOODING          "FLOODING"
+#define  w_VELOCITY          "VELOCITY"
+#define  w_CAPACITY          "CAPACITY"
+
 // Interface File Types
 #define  w_RAINFALL          "RAINFALL"
 #define  w_RUNOFF            "RUNOFF"
@@ -317,6 +337,11 @@
 #define  w_ROUTING           "ROUTING"
 #define  w_INFLOWS           "INFLOWS"
 #define  w_OUTFLOWS          "OUTFLOWS"
+#define  w_CLIMATE           "CLIMATE"
+
+// Interface File Formats
+#define  w_TEXT              "TEXT"
+#define  w_BINARY            "BINARY"
 
 // Miscellaneous Keywords
 #define  w_OFF               "OFF"
@@ -433,3 +458,6 @@
 #define  ws_GWF              "[GWF"                                            //(5.1.007)
 #define  ws_ADJUST           "[ADJUSTMENT"                                     //(5.1.007)
 #define  ws_EVENT            "[EVENT"                                          //(5.1.011)
+#define  ws_RAINCELLS        "[RAINCELLS"
+#define  ws_OUTPUT_PROFILES  "[OUTPUT_PROFILES"
+#define  ws_OUTPUT_TOLERANCES "[OUTPUT_TOLERANCES"
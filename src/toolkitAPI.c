@@ -15,6 +15,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 
 #include "headers.h"
@@ -35,6 +36,14 @@ int  stats_getLinkStat(int index, SM_LinkStats *linkStats);
 int  stats_getPumpStat(int index, SM_PumpStats *pumpStats);
 int  stats_getSubcatchStat(int index, SM_SubcatchStats *subcatchStats);
 
+// Local Functions
+static int  checkIndexes(int type, const int *indexes, int count);
+static int  getNodeResult(int index, int type, double *result);
+static int  getLinkResult(int index, int type, double *result);
+static int  getSubcatchResult(int index, int type, double *result);
+static void setLinkSetting(int index, double targetSetting);
+static int  setNodeInflow(int index, double flowrate);
+
 //-----------------------------------------------------------------------------
 //  Extended API Functions
 //-----------------------------------------------------------------------------
@@ -825,29 +834,7 @@ int DLLEXPORT swmm_getNodeResult(int index, int type, double *result)
     }
     else
     {
-        switch (type)
-        {
-            case SM_TOTALINFLOW:
-                *result = Node[index].inflow * UCF(FLOW); break;
-            case SM_TOTALOUTFLOW:
-                *result = Node[index].outflow * UCF(FLOW); break;
-            case SM_LOSSES:
-                *result = Node[index].losses * UCF(FLOW); break;
-            case SM_NODEVOL:
-                *result = Node[index].newVolume * UCF(VOLUME); break;
-            case SM_NODEFLOOD:
-                *result = Node[index].overflow * UCF(FLOW); break;
-            case SM_NODEDEPTH:
-                *result = Node[index].newDepth * UCF(LENGTH); break;
-            case SM_NODEHEAD:
-                *result = (Node[index].newDepth
-                            + Node[index].invertElev) * UCF(LENGTH); break;
-            case SM_LATINFLOW:
-                *result = Node[index].newLatFlow * UCF(FLOW); break;
-            case SM_COUPINFLOW:
-                *result = Node[index].couplingInflow * UCF(FLOW); break;
-            default: errcode = ERR_API_OUTBOUNDS; break;
-        }
+        errcode = getNodeResult(index, type, result);
     }
     return(errcode);
 }
@@ -874,26 +861,7 @@ int DLLEXPORT swmm_getLinkResult(int index, int type, double *result)
     }
     else
     {
-        switch (type)
-        {
-            case SM_LINKFLOW:
-                *result = Link[index].newFlow * UCF(FLOW) ; break;
-            case SM_LINKDEPTH:
-                *result = Link[index].newDepth * UCF(LENGTH); break;
-            case SM_LINKVOL:
-                *result = Link[index].newVolume * UCF(VOLUME); break;
-            case SM_USSURFAREA:
-                *result = Link[index].surfArea1 * UCF(LENGTH) * UCF(LENGTH); break;
-            case SM_DSSURFAREA:
-                *result = Link[index].surfArea2 * UCF(LENGTH) * UCF(LENGTH); break;
-            case SM_SETTING:
-                *result = Link[index].setting; break;
-            case SM_TARGETSETTING:
-                *result = Link[index].targetSetting; break;
-            case SM_FROUDE:
-                *result = Link[index].froude; break;
-            default: errcode = ERR_API_OUTBOUNDS; break;
-        }
+        errcode = getLinkResult(index, type, result);
     }
     return(errcode);
 }
@@ -920,22 +888,232 @@ int DLLEXPORT swmm_getSubcatchResult(int index, int type, double *result)
     }
     else
     {
-        switch (type)
+        errcode = getSubcatchResult(index, type, result);
+    }
+    return(errcode);
+}
+
+
+int DLLEXPORT swmm_getNodeResults(int type, const int *indexes, int count,
+                                  double *results)
+//
+// Input:   type = Result Type (SM_NodeResult)
+//          indexes = Indexes of desired nodes (NULL for nodes 0 to count-1)
+//          count = Number of nodes
+// Output:  results = result data desired for each node (pre-allocated)
+// Return:  API Error
+// Purpose: Gets Simulated Value of many Nodes at Current Time in one call
+{
+    int i;
+    int errcode = 0;
+    // Check if Simulation is Running
+    if(swmm_IsStartedFlag() == FALSE)
+    {
+        errcode = ERR_API_SIM_NRUNNING;
+    }
+    // Check if object indexes are within bounds
+    else if (results == NULL && count > 0)
+    {
+        errcode = ERR_API_OUTBOUNDS;
+    }
+    else errcode = checkIndexes(NODE, indexes, count);
+    for (i = 0; i < count && errcode == 0; i++)
+    {
+        errcode = getNodeResult(indexes ? indexes[i] : i, type, &results[i]);
+    }
+    return(errcode);
+}
+
+
+int DLLEXPORT swmm_getLinkResults(int type, const int *indexes, int count,
+                                  double *results)
+//
+// Input:   type = Result Type (SM_LinkResult)
+//          indexes = Indexes of desired links (NULL for links 0 to count-1)
+//          count = Number of links
+// Output:  results = result data desired for each link (pre-allocated)
+// Return:  API Error
+// Purpose: Gets Simulated Value of many Links at Current Time in one call
+{
+    int i;
+    int errcode = 0;
+    // Check if Simulation is Running
+    if(swmm_IsStartedFlag() == FALSE)
+    {
+        errcode = ERR_API_SIM_NRUNNING;
+    }
+    // Check if object indexes are within bounds
+    else if (results == NULL && count > 0)
+    {
+        errcode = ERR_API_OUTBOUNDS;
+    }
+    else errcode = checkIndexes(LINK, indexes, count);
+    for (i = 0; i < count && errcode == 0; i++)
+    {
+        errcode = getLinkResult(indexes ? indexes[i] : i, type, &results[i]);
+    }
+    return(errcode);
+}
+
+
+int DLLEXPORT swmm_getSubcatchResults(int type, const int *indexes, int count,
+                                      double *results)
+//
+// Input:   type = Result Type (SM_SubcResult)
+//          indexes = Indexes of desired subcatchments (NULL for
+//                    subcatchments 0 to count-1)
+//          count = Number of subcatchments
+// Output:  results = result data desired for each subcatchment (pre-allocated)
+// Return:  API Error
+// Purpose: Gets Simulated Value of many Subcatchments at Current Time in one
+//          call
+{
+    int i;
+    int errcode = 0;
+    // Check if Simulation is Running
+    if(swmm_IsStartedFlag() == FALSE)
+    {
+        errcode = ERR_API_SIM_NRUNNING;
+    }
+    // Check if object indexes are within bounds
+    else if (results == NULL && count > 0)
+    {
+        errcode = ERR_API_OUTBOUNDS;
+    }
+    else errcode = checkIndexes(SUBCATCH, indexes, count);
+    for (i = 0; i < count && errcode == 0; i++)
+    {
+        errcode = getSubcatchResult(indexes ? indexes[i] : i, type,
+                                    &results[i]);
+    }
+    return(errcode);
+}
+
+
+int DLLEXPORT swmm_getStateView(int type, int result, int version,
+                                SM_StateView *view)
+//
+// Input:   type = Object Type (SM_NODE, SM_LINK or SM_SUBCATCH)
+//          result = Result Type (SM_NodeResult, SM_LinkResult or SM_SubcResult)
+//          version = version of SM_StateView known to caller
+// Output:  view = location, spacing & units of the result of each object
+// Return:  API Error
+// Purpose: Gets a read-only view of a Simulated Value of all objects of a
+//          type that is updated in place at each time step
+{
+    int    errcode = 0;
+    int    count = 0;
+    int    stride = 0;
+    char*  base = NULL;
+    size_t offset = 0;
+    double scale = 1.0;
+
+    // Check if Open
+    if (swmm_IsOpenFlag() == FALSE)
+    {
+        errcode = ERR_API_INPUTNOTOPEN;
+    }
+    // Check Output Pointer
+    else if (view == NULL)
+    {
+        errcode = ERR_API_OUTBOUNDS;
+    }
+    // Check that the caller's view structure is supported
+    else if (version != SM_STATEVIEW_VERSION)
+    {
+        errcode = ERR_API_VIEW_VERSION;
+    }
+    else if (type == SM_NODE)
+    {
+        switch (result)
+        {
+            case SM_TOTALINFLOW:
+                offset = offsetof(TNode, inflow); scale = UCF(FLOW); break;
+            case SM_TOTALOUTFLOW:
+                offset = offsetof(TNode, outflow); scale = UCF(FLOW); break;
+            case SM_LOSSES:
+                offset = offsetof(TNode, losses); scale = UCF(FLOW); break;
+            case SM_NODEVOL:
+                offset = offsetof(TNode, newVolume); scale = UCF(VOLUME); break;
+            case SM_NODEFLOOD:
+                offset = offsetof(TNode, overflow); scale = UCF(FLOW); break;
+            case SM_NODEDEPTH:
+                offset = offsetof(TNode, newDepth); scale = UCF(LENGTH); break;
+            case SM_LATINFLOW:
+                offset = offsetof(TNode, newLatFlow); scale = UCF(FLOW); break;
+            case SM_COUPINFLOW:
+                offset = offsetof(TNode, couplingInflow); scale = UCF(FLOW);
+                break;
+            default: errcode = ERR_API_OUTBOUNDS; break;
+        }
+        count = Nobjects[NODE];
+        stride = sizeof(TNode);
+        base = (char *)Node;
+    }
+    else if (type == SM_LINK)
+    {
+        switch (result)
+        {
+            case SM_LINKFLOW:
+                offset = offsetof(TLink, newFlow); scale = UCF(FLOW); break;
+            case SM_LINKDEPTH:
+                offset = offsetof(TLink, newDepth); scale = UCF(LENGTH); break;
+            case SM_LINKVOL:
+                offset = offsetof(TLink, newVolume); scale = UCF(VOLUME); break;
+            case SM_USSURFAREA:
+                offset = offsetof(TLink, surfArea1);
+                scale = UCF(LENGTH) * UCF(LENGTH); break;
+            case SM_DSSURFAREA:
+                offset = offsetof(TLink, surfArea2);
+                scale = UCF(LENGTH) * UCF(LENGTH); break;
+            case SM_SETTING:
+                offset = offsetof(TLink, setting); break;
+            case SM_TARGETSETTING:
+                offset = offsetof(TLink, targetSetting); break;
+            case SM_FROUDE:
+                offset = offsetof(TLink, froude); break;
+            default: errcode = ERR_API_OUTBOUNDS; break;
+        }
+        count = Nobjects[LINK];
+        stride = sizeof(TLink);
+        base = (char *)Link;
+    }
+    else if (type == SM_SUBCATCH)
+    {
+        switch (result)
         {
             case SM_SUBCRAIN:
-                *result = Subcatch[index].rainfall * UCF(RAINFALL); break;
+                offset = offsetof(TSubcatch, rainfall); scale = UCF(RAINFALL);
+                break;
             case SM_SUBCEVAP:
-                *result = Subcatch[index].evapLoss * UCF(EVAPRATE); break;
+                offset = offsetof(TSubcatch, evapLoss); scale = UCF(EVAPRATE);
+                break;
             case SM_SUBCINFIL:
-                *result = Subcatch[index].infilLoss * UCF(RAINFALL); break;
+                offset = offsetof(TSubcatch, infilLoss); scale = UCF(RAINFALL);
+                break;
             case SM_SUBCRUNON:
-                *result = Subcatch[index].runon * UCF(FLOW); break;
+                offset = offsetof(TSubcatch, runon); scale = UCF(FLOW); break;
             case SM_SUBCRUNOFF:
-                *result = Subcatch[index].newRunoff * UCF(FLOW); break;
+                offset = offsetof(TSubcatch, newRunoff); scale = UCF(FLOW);
+                break;
             case SM_SUBCSNOW:
-                *result = Subcatch[index].newSnowDepth * UCF(RAINDEPTH); break;
+                offset = offsetof(TSubcatch, newSnowDepth);
+                scale = UCF(RAINDEPTH); break;
             default: errcode = ERR_API_OUTBOUNDS; break;
         }
+        count = Nobjects[SUBCATCH];
+        stride = sizeof(TSubcatch);
+        base = (char *)Subcatch;
+    }
+    else errcode = ERR_API_WRONG_TYPE;
+
+    if (errcode == 0)
+    {
+        view->version = SM_STATEVIEW_VERSION;
+        view->count = count;
+        view->stride = stride;
+        view->data = base ? base + offset : NULL;
+        view->scale = scale;
     }
     return(errcode);
 }
@@ -1336,9 +1514,7 @@ int DLLEXPORT swmm_setLinkSetting(int index, double targetSetting)
 // Output:  returns API Error
 // Purpose: Sets Link open fraction (Weir, Orifice, Pump, and Outlet)
 {
-    DateTime currentTime;
     int errcode = 0;
-    char _rule_[11] = "ToolkitAPI";
 
     // Check if Open
     if (swmm_IsOpenFlag() == FALSE)
@@ -1352,21 +1528,7 @@ int DLLEXPORT swmm_setLinkSetting(int index, double targetSetting)
     }
     else
     {
-        // --- check that new setting lies within feasible limits
-        if (targetSetting < 0.0) targetSetting = 0.0;
-        if (Link[index].type != PUMP && targetSetting > 1.0) targetSetting = 1.0;
-
-        Link[index].targetSetting = targetSetting;
-
-        // Use internal function to apply the new setting
-        link_setSetting(index, 0.0);
-
-        // Add control action to RPT file if desired flagged
-        if (RptFlags.controls)
-        {
-            currentTime = getDateTime(NewRoutingTime);
-            report_writeControlAction(currentTime, Link[index].ID, targetSetting, _rule_);
-        }
+        setLinkSetting(index, targetSetting);
     }
     return(errcode);
 }
@@ -1393,46 +1555,78 @@ int DLLEXPORT swmm_setNodeInflow(int index, double flowrate)
     }
     else
     {
-        // Check to see if node has an assigned inflow object
-        TExtInflow* inflow;
+        errcode = setNodeInflow(index, flowrate);
+    }
+    return(errcode);
+}
 
-        // --- check if an external inflow object for this constituent already exists
-        inflow = Node[index].extInflow;
-        while (inflow)
-        {
-            if (inflow->param == -1) break;
-            inflow = inflow->next;
-        }
 
-        if (!inflow)
-        {
-            int param = -1;        // FLOW (-1) or Pollutant Index
-            int type = FLOW_INFLOW;// Type of inflow (FLOW)
-            int tSeries = -1;      // No Time Series
-            int basePat = -1;      // No Base Pattern
-            double cf = 1.0;       // Unit Convert (Converted during validation)
-            double sf = 1.0;       // Scaling Factor
-            double baseline = 0.0; // Baseline Inflow Rate
-
-            // Initializes Inflow Object
-            errcode = inflow_setExtInflow(index, param, type, tSeries,
-                basePat, cf, baseline, sf);
-
-            // Get The Inflow Object
-            if ( errcode == 0 )
-            {
-                inflow = Node[index].extInflow;
-            }
-        }
-        // Assign new flow rate
-        if ( errcode == 0 )
+int DLLEXPORT swmm_setLinkSettings(const int *indexes, int count,
+                                   const double *targetSettings)
+//
+// Input:   indexes = Indexes of desired links (NULL for links 0 to count-1)
+//          count = Number of links
+//          targetSettings = New Target Setting of each link
+// Output:  returns API Error
+// Purpose: Sets open fraction of many Links (Weir, Orifice, Pump, and Outlet)
+//          in one call
+{
+    int i;
+    int errcode = 0;
+
+    // Check if Open
+    if (swmm_IsOpenFlag() == FALSE)
+    {
+        errcode = ERR_API_INPUTNOTOPEN;
+    }
+    // Check if object indexes are within bounds
+    else if (targetSettings == NULL && count > 0)
+    {
+        errcode = ERR_API_OUTBOUNDS;
+    }
+    else errcode = checkIndexes(LINK, indexes, count);
+    if (errcode == 0)
+    {
+        for (i = 0; i < count; i++)
         {
-            inflow -> extIfaceInflow = flowrate;
+            setLinkSetting(indexes ? indexes[i] : i, targetSettings[i]);
         }
     }
     return(errcode);
 }
 
+
+int DLLEXPORT swmm_setNodeInflows(const int *indexes, int count,
+                                  const double *flowrates)
+//
+// Input:   indexes = Indexes of desired nodes (NULL for nodes 0 to count-1)
+//          count = Number of nodes
+//          flowrates = New Inflow Rate of each node
+// Output:  returns API Error
+// Purpose: Sets new inflow rate of many nodes in one call and holds them
+//          until set again (nodes set before an error keep their new rates)
+{
+    int i;
+    int errcode = 0;
+
+    // Check if Open
+    if (swmm_IsOpenFlag() == FALSE)
+    {
+        errcode = ERR_API_INPUTNOTOPEN;
+    }
+    // Check if object indexes are within bounds
+    else if (flowrates == NULL && count > 0)
+    {
+        errcode = ERR_API_OUTBOUNDS;
+    }
+    else errcode = checkIndexes(NODE, indexes, count);
+    for (i = 0; i < count && errcode == 0; i++)
+    {
+        errcode = setNodeInflow(indexes ? indexes[i] : i, flowrates[i]);
+    }
+    return(errcode);
+}
+
 int DLLEXPORT swmm_setOutfallStage(int index, double stage)
 //
 // Input:   index = Index of desired outfall
@@ -1775,3 +1969,210 @@ int DLLEXPORT swmm_openOpening(int nodeID, int idx)
     return errcode;
 }
 
+
+//-----------------------------------------------------------------------------
+//  Local Functions
+//-----------------------------------------------------------------------------
+
+int checkIndexes(int type, const int *indexes, int count)
+//
+// Input:   type = object type (SUBCATCH, NODE or LINK)
+//          indexes = Indexes of objects (NULL for objects 0 to count-1)
+//          count = Number of objects
+// Return:  API Error
+// Purpose: Checks that a list of object indexes lies within bounds
+{
+    int i;
+
+    if (count < 0 || (indexes == NULL && count > Nobjects[type]))
+    {
+        return(ERR_API_OBJECT_INDEX);
+    }
+    if (indexes == NULL) return(0);
+    for (i = 0; i < count; i++)
+    {
+        if (indexes[i] < 0 || indexes[i] >= Nobjects[type])
+        {
+            return(ERR_API_OBJECT_INDEX);
+        }
+    }
+    return(0);
+}
+
+
+int getNodeResult(int index, int type, double *result)
+//
+// Input:   index = Index of desired ID (within bounds)
+//          type = Result Type (SM_NodeResult)
+// Output:  result = result data desired (byref)
+// Return:  API Error
+// Purpose: Gets Node Simulated Value at Current Time
+{
+    int errcode = 0;
+
+    switch (type)
+    {
+        case SM_TOTALINFLOW:
+            *result = Node[index].inflow * UCF(FLOW); break;
+        case SM_TOTALOUTFLOW:
+            *result = Node[index].outflow * UCF(FLOW); break;
+        case SM_LOSSES:
+            *result = Node[index].losses * UCF(FLOW); break;
+        case SM_NODEVOL:
+            *result = Node[index].newVolume * UCF(VOLUME); break;
+        case SM_NODEFLOOD:
+            *result = Node[index].overflow * UCF(FLOW); break;
+        case SM_NODEDEPTH:
+            *result = Node[index].newDepth * UCF(LENGTH); break;
+        case SM_NODEHEAD:
+            *result = (Node[index].newDepth
+                        + Node[index].invertElev) * UCF(LENGTH); break;
+        case SM_LATINFLOW:
+            *result = Node[index].newLatFlow * UCF(FLOW); break;
+        case SM_COUPINFLOW:
+            *result = Node[index].couplingInflow * UCF(FLOW); break;
+        default: errcode = ERR_API_OUTBOUNDS; break;
+    }
+    return(errcode);
+}
+
+
+int getLinkResult(int index, int type, double *result)
+//
+// Input:   index = Index of desired ID (within bounds)
+//          type = Result Type (SM_LinkResult)
+// Output:  result = result data desired (byref)
+// Return:  API Error
+// Purpose: Gets Link Simulated Value at Current Time
+{
+    int errcode = 0;
+
+    switch (type)
+    {
+        case SM_LINKFLOW:
+            *result = Link[index].newFlow * UCF(FLOW) ; break;
+        case SM_LINKDEPTH:
+            *result = Link[index].newDepth * UCF(LENGTH); break;
+        case SM_LINKVOL:
+            *result = Link[index].newVolume * UCF(VOLUME); break;
+        case SM_USSURFAREA:
+            *result = Link[index].surfArea1 * UCF(LENGTH) * UCF(LENGTH); break;
+        case SM_DSSURFAREA:
+            *result = Link[index].surfArea2 * UCF(LENGTH) * UCF(LENGTH); break;
+        case SM_SETTING:
+            *result = Link[index].setting; break;
+        case SM_TARGETSETTING:
+            *result = Link[index].targetSetting; break;
+        case SM_FROUDE:
+            *result = Link[index].froude; break;
+        default: errcode = ERR_API_OUTBOUNDS; break;
+    }
+    return(errcode);
+}
+
+
+int getSubcatchResult(int index, int type, double *result)
+//
+// Input:   index = Index of desired ID (within bounds)
+//          type = Result Type (SM_SubcResult)
+// Output:  result = result data desired (byref)
+// Return:  API Error
+// Purpose: Gets Subcatchment Simulated Value at Current Time
+{
+    int errcode = 0;
+
+    switch (type)
+    {
+        case SM_SUBCRAIN:
+            *result = Subcatch[index].rainfall * UCF(RAINFALL); break;
+        case SM_SUBCEVAP:
+            *result = Subcatch[index].evapLoss * UCF(EVAPRATE); break;
+        case SM_SUBCINFIL:
+            *result = Subcatch[index].infilLoss * UCF(RAINFALL); break;
+        case SM_SUBCRUNON:
+            *result = Subcatch[index].runon * UCF(FLOW); break;
+        case SM_SUBCRUNOFF:
+            *result = Subcatch[index].newRunoff * UCF(FLOW); break;
+        case SM_SUBCSNOW:
+            *result = Subcatch[index].newSnowDepth * UCF(RAINDEPTH); break;
+        default: errcode = ERR_API_OUTBOUNDS; break;
+    }
+    return(errcode);
+}
+
+
+void setLinkSetting(int index, double targetSetting)
+//
+// Input:   index = Index of desired ID (within bounds)
+//          targetSetting = New Target Setting
+// Output:  none
+// Purpose: Sets Link open fraction (Weir, Orifice, Pump, and Outlet)
+{
+    DateTime currentTime;
+    char _rule_[11] = "ToolkitAPI";
+
+    // --- check that new setting lies within feasible limits
+    if (targetSetting < 0.0) targetSetting = 0.0;
+    if (Link[index].type != PUMP && targetSetting > 1.0) targetSetting = 1.0;
+
+    Link[index].targetSetting = targetSetting;
+
+    // Use internal function to apply the new setting
+    link_setSetting(index, 0.0);
+
+    // Add control action to RPT file if desired flagged
+    if (RptFlags.controls)
+    {
+        currentTime = getDateTime(NewRoutingTime);
+        report_writeControlAction(currentTime, Link[index].ID, targetSetting, _rule_);
+    }
+}
+
+
+int setNodeInflow(int index, double flowrate)
+//
+// Input:   index = Index of desired ID (within bounds)
+//          flowrate = New Inflow Rate
+// Output:  returns API Error
+// Purpose: Sets new node inflow rate and holds until set again
+{
+    int errcode = 0;
+
+    // Check to see if node has an assigned inflow object
+    TExtInflow* inflow;
+
+    // --- check if an external inflow object for this constituent already exists
+    inflow = Node[index].extInflow;
+    while (inflow)
+    {
+        if (inflow->param == -1) break;
+        inflow = inflow->next;
+    }
+
+    if (!inflow)
+    {
+        int param = -1;        // FLOW (-1) or Pollutant Index
+        int type = FLOW_INFLOW;// Type of inflow (FLOW)
+        int tSeries = -1;      // No Time Series
+        int basePat = -1;      // No Base Pattern
+        double cf = 1.0;       // Unit Convert (Converted during validation)
+        double sf = 1.0;       // Scaling Factor
+        double baseline = 0.0; // Baseline Inflow Rate
+
+        // Initializes Inflow Object
+        errcode = inflow_setExtInflow(index, param, type, tSeries,
+            basePat, cf, baseline, sf);
+
+        // Get The Inflow Object
+        if ( errcode == 0 )
+        {
+            inflow = Node[index].extInflow;
+        }
+    }
+    // Assign new flow rate
+    if ( errcode == 0 )
+    {
+        inflow -> extIfaceInflow = flowrate;
+    }
+    return(errcode);
+}
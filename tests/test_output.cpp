@@ -25,6 +25,22 @@
 // NOTE: Reference data for the unit tests is currently tied to SWMM 5.1.7
 #define DATA_PATH "./Example1.out"
 
+// Output files saved in other layouts by running the input file of the same
+// name in ./data (e.g. run-swmm Example1_profile.inp Example1_profile.rpt
+// Example1_profile.out), which must be re-run whenever the layout changes.
+// Example1 run with the TRANSPOSED_OUTPUT option
+#define TRANSPOSED_PATH "./Example1_transposed.out"
+// Example1 run with node depths & inflows saved every 2 hours and link
+// flows every 3 hours under [OUTPUT_PROFILES]
+#define PROFILE_PATH "./Example1_profile.out"
+// Example1 run with the COMPRESSED_OUTPUT option
+#define COMPRESSED_PATH "./Example1_compressed.out"
+// Example1 run with the OUTPUT_SUMMARY and TRANSPOSED_OUTPUT options
+#define SUMMARY_PATH "./Example1_summary.out"
+// Example1 run with the COMPRESSED_OUTPUT option and node depths, node TSS
+// and link flows rounded under [OUTPUT_TOLERANCES]
+#define TOLERANCE_PATH "./Example1_tolerance.out"
+
 using namespace std;
 
 // Custom test to check the minimum number of correct decimal digits between 
@@ -121,6 +137,50 @@ struct Fixture{
     int array_dim;
 };
 
+// Also opens an output file saved in another layout (f_handle) and, as the
+// results it is checked against, the file saved with transposed results
+// (t_handle).
+struct FileFixture : Fixture {
+    FileFixture(const char* file_path) {
+        f_handle = NULL;
+        t_handle = NULL;
+        SMO_init(&f_handle);
+        SMO_init(&t_handle);
+        BOOST_REQUIRE(SMO_open(f_handle, file_path) == 0);
+        BOOST_REQUIRE(SMO_open(t_handle, TRANSPOSED_PATH) == 0);
+
+        result = NULL;
+        result_dim = 0;
+    }
+    ~FileFixture() {
+        SMO_free((void**)&result);
+        SMO_close(&f_handle);
+        SMO_close(&t_handle);
+    }
+
+    SMO_Handle f_handle;
+    SMO_Handle t_handle;
+
+    float* result;
+    int result_dim;
+};
+
+struct TransposedFixture : FileFixture {
+    TransposedFixture() : FileFixture(TRANSPOSED_PATH) {}
+};
+struct ProfileFixture : FileFixture {
+    ProfileFixture() : FileFixture(PROFILE_PATH) {}
+};
+struct CompressedFixture : FileFixture {
+    CompressedFixture() : FileFixture(COMPRESSED_PATH) {}
+};
+struct SummaryFixture : FileFixture {
+    SummaryFixture() : FileFixture(SUMMARY_PATH) {}
+};
+struct ToleranceFixture : FileFixture {
+    ToleranceFixture() : FileFixture(TOLERANCE_PATH) {}
+};
+
 BOOST_AUTO_TEST_SUITE(test_output_fixture)
 
 BOOST_FIXTURE_TEST_CASE(test_getVersion, Fixture) {
@@ -345,4 +405,222 @@ BOOST_FIXTURE_TEST_CASE(test_getSystemResult, Fixture) {
     BOOST_CHECK(check_cdd(test_vec, ref_vec, 3));
 }
 
+BOOST_FIXTURE_TEST_CASE(test_getTransposedSeries, TransposedFixture) {
+    // series read from the transposed results must match the values
+    // stored in each reporting period
+    error = SMO_getNodeSeries(f_handle, 2, SMO_total_inflow, 0, 36, &array, &array_dim);
+    BOOST_REQUIRE(error == 0);
+    BOOST_REQUIRE(array_dim == 36);
+
+    for (int k = 0; k < array_dim; k++) {
+        error = SMO_getNodeResult(f_handle, k, 2, &result, &result_dim);
+        BOOST_REQUIRE(error == 0);
+        BOOST_CHECK_EQUAL(result[SMO_total_inflow], array[k]);
+        SMO_free((void**)&result);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(test_getProfileResults, ProfileFixture) {
+    SMO_view view;
+
+    // a value saved every 2 periods is held from the last period saved
+    error = SMO_getNodeSeries(f_handle, 2, SMO_total_inflow, 0, 36, &array, &array_dim);
+    BOOST_REQUIRE(error == 0);
+    BOOST_REQUIRE(array_dim == 36);
+    for (int k = 0; k < array_dim; k++) {
+        error = SMO_getNodeResult(t_handle, k - k % 2, 2, &result, &result_dim);
+        BOOST_REQUIRE(error == 0);
+        BOOST_CHECK_EQUAL(result[SMO_total_inflow], array[k]);
+        SMO_free((void**)&result);
+    }
+    SMO_free((void**)&array);
+
+    // values not saved are missing
+    error = SMO_getNodeResult(f_handle, 5, 2, &result, &result_dim);
+    BOOST_REQUIRE(error == 0);
+    BOOST_CHECK(isnan(result[SMO_hydraulic_head]));
+    SMO_free((void**)&result);
+
+    // results without a profile & system results are saved every period
+    error = SMO_getSystemSeries(f_handle, SMO_runoff_flow, 0, 36, &array, &array_dim);
+    BOOST_REQUIRE(error == 0);
+    for (int k = 0; k < array_dim; k++) {
+        error = SMO_getSystemResult(t_handle, k, 0, &result, &result_dim);
+        BOOST_REQUIRE(error == 0);
+        BOOST_CHECK_EQUAL(result[SMO_runoff_flow], array[k]);
+        SMO_free((void**)&result);
+    }
+
+    // no views of results saved under profiles
+    error = SMO_mapFile(f_handle);
+    BOOST_REQUIRE(error == 0);
+    error = SMO_getSeriesView(f_handle, SMO_link, 3, SMO_flow_rate_link, 0, 36, &view);
+    BOOST_CHECK(error == 439);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_getCompressedResults, CompressedFixture) {
+    SMO_view view;
+
+    // results restored from the compressed chunks match those saved
+    // uncompressed
+    error = SMO_getLinkSeries(f_handle, 3, SMO_flow_rate_link, 0, 36, &array, &array_dim);
+    BOOST_REQUIRE(error == 0);
+    BOOST_REQUIRE(array_dim == 36);
+    for (int k = 0; k < array_dim; k++) {
+        error = SMO_getLinkResult(t_handle, k, 3, &result, &result_dim);
+        BOOST_REQUIRE(error == 0);
+        BOOST_CHECK_EQUAL(result[SMO_flow_rate_link], array[k]);
+        SMO_free((void**)&result);
+    }
+
+    SMO_free((void**)&array);
+    error = SMO_getSystemResult(f_handle, 35, 0, &array, &array_dim);
+    BOOST_REQUIRE(error == 0);
+    error = SMO_getSystemResult(t_handle, 35, 0, &result, &result_dim);
+    BOOST_REQUIRE(error == 0);
+    BOOST_REQUIRE(array_dim == result_dim);
+    for (int k = 0; k < array_dim; k++)
+        BOOST_CHECK_EQUAL(result[k], array[k]);
+    SMO_free((void**)&result);
+
+    // compressed results cannot be viewed in place
+    error = SMO_mapFile(f_handle);
+    BOOST_REQUIRE(error == 0);
+    error = SMO_getSeriesView(f_handle, SMO_link, 3, SMO_flow_rate_link, 0, 36, &view);
+    BOOST_CHECK(error == 439);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_getRoundedResults, ToleranceFixture) {
+    struct Series { int type; int index; int attr; float tolerance; };
+    Series series[] = {
+        { SMO_node, 2, SMO_invert_depth, 0.01f },
+        { SMO_node, 9, SMO_invert_depth, 0.01f },
+        { SMO_node, 2, SMO_pollutant_conc_node, 0.5f },
+        { SMO_link, 3, SMO_flow_rate_link, 0.05f },
+        { SMO_link, 12, SMO_flow_rate_link, 0.05f }
+    };
+    int rounded = 0;
+
+    // results rounded before they were compressed stay within their
+    // tolerances of the results saved unrounded
+    for (int s = 0; s < 5; s++) {
+        for (int k = 0; k < 36; k++) {
+            if (series[s].type == SMO_node) {
+                error = SMO_getNodeResult(f_handle, k, series[s].index, &array, &array_dim);
+                BOOST_REQUIRE(error == 0);
+                error = SMO_getNodeResult(t_handle, k, series[s].index, &result, &result_dim);
+            }
+            else {
+                error = SMO_getLinkResult(f_handle, k, series[s].index, &array, &array_dim);
+                BOOST_REQUIRE(error == 0);
+                error = SMO_getLinkResult(t_handle, k, series[s].index, &result, &result_dim);
+            }
+            BOOST_REQUIRE(error == 0);
+            float x = array[series[s].attr];
+            float ref = result[series[s].attr];
+            BOOST_CHECK_LE(fabs(x - ref), series[s].tolerance * 1.0001);
+            if (x != ref) rounded++;
+            SMO_free((void**)&array);
+            SMO_free((void**)&result);
+        }
+    }
+    BOOST_CHECK(rounded > 0);
+
+    // results without a tolerance are saved unchanged
+    error = SMO_getNodeResult(f_handle, 20, 9, &array, &array_dim);
+    BOOST_REQUIRE(error == 0);
+    error = SMO_getNodeResult(t_handle, 20, 9, &result, &result_dim);
+    BOOST_REQUIRE(error == 0);
+    BOOST_CHECK_EQUAL(result[SMO_total_inflow], array[SMO_total_inflow]);
+    BOOST_CHECK_EQUAL(result[SMO_hydraulic_head], array[SMO_hydraulic_head]);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_getSummary, SummaryFixture) {
+    SMO_summary summary;
+    float minimum, maximum;
+    double mean = 0.0;
+    int maxPeriod = 0;
+
+    // the summary agrees with the series read from the same file
+    error = SMO_getNodeSeries(f_handle, 2, SMO_total_inflow, 0, 36, &array, &array_dim);
+    BOOST_REQUIRE(error == 0);
+    BOOST_REQUIRE(array_dim == 36);
+    minimum = maximum = array[0];
+    for (int k = 0; k < array_dim; k++) {
+        if (array[k] < minimum) minimum = array[k];
+        if (array[k] > maximum) {
+            maximum = array[k];
+            maxPeriod = k;
+        }
+        mean += array[k];
+    }
+    mean /= array_dim;
+
+    error = SMO_getSummary(f_handle, SMO_node, 2, SMO_total_inflow, &summary);
+    BOOST_REQUIRE(error == 0);
+    BOOST_CHECK_EQUAL(summary.minimum, minimum);
+    BOOST_CHECK_EQUAL(summary.maximum, maximum);
+    BOOST_CHECK_EQUAL(summary.maxPeriod, maxPeriod);
+    BOOST_CHECK_SMALL(summary.mean - mean, 1.0e-4);
+
+    error = SMO_getSummary(f_handle, SMO_node, 100, SMO_total_inflow, &summary);
+    BOOST_CHECK(error == 423);
+
+    // files saved without the option have no summary
+    error = SMO_getSummary(p_handle, SMO_node, 2, SMO_total_inflow, &summary);
+    BOOST_CHECK(error == 426);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_getSeriesView, Fixture) {
+    SMO_view view;
+
+    // views are only available once the file is mapped
+    error = SMO_getSeriesView(p_handle, SMO_link, 3, SMO_flow_rate_link, 0, 36, &view);
+    BOOST_CHECK(error == 425);
+
+    error = SMO_mapFile(p_handle);
+    BOOST_REQUIRE(error == 0);
+
+    error = SMO_getLinkSeries(p_handle, 3, SMO_flow_rate_link, 0, 36, &array, &array_dim);
+    BOOST_REQUIRE(error == 0);
+
+    error = SMO_getSeriesView(p_handle, SMO_link, 3, SMO_flow_rate_link, 0, 36, &view);
+    BOOST_REQUIRE(error == 0);
+    BOOST_REQUIRE(view.length == array_dim);
+
+    for (int k = 0; k < view.length; k++)
+        BOOST_CHECK_EQUAL(SMO_getViewValue(&view, k), array[k]);
+
+    error = SMO_unmapFile(p_handle);
+    BOOST_REQUIRE(error == 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_getBulkSeries, Fixture) {
+    const int n_links = 2, n_attrs = 2, length = 30;
+    int links[n_links] = {3, 1};
+    int attrs[n_attrs] = {SMO_flow_rate_link, SMO_flow_depth};
+    std::vector<float> matrix(n_links * n_attrs * length);
+
+    error = SMO_getBulkSeries(p_handle, SMO_link, links, n_links, attrs, n_attrs,
+        5, 5 + length, 2, &matrix[0]);
+    BOOST_REQUIRE(error == 0);
+
+    // each series in the matrix must match the one retrieved on its own
+    for (int e = 0; e < n_links; e++) {
+        for (int a = 0; a < n_attrs; a++) {
+            error = SMO_getLinkSeries(p_handle, links[e], (SMO_linkAttribute)attrs[a],
+                5, 5 + length, &array, &array_dim);
+            BOOST_REQUIRE(error == 0);
+
+            std::vector<float> test_vec(matrix.begin() + (e * n_attrs + a) * length,
+                matrix.begin() + (e * n_attrs + a + 1) * length);
+            std::vector<float> ref_vec(array, array + array_dim);
+            BOOST_CHECK_EQUAL_COLLECTIONS(ref_vec.begin(), ref_vec.end(),
+                test_vec.begin(), test_vec.end());
+
+            SMO_free((void**)&array);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,234 @@
+/*
+ *   test_stepping.cpp
+ *
+ *   Unit testing for advancing a simulation by many routing steps
+ *   (swmm_stepN, swmm_stepUntil and stop conditions) using Boost Test.
+ *
+ *   Runs Example1 one routing step at a time to find where its results
+ *   cross a threshold and checks that the multi-step calls stop there, and
+ *   checks where in each step the step callbacks are called.
+ */
+
+#define BOOST_TEST_MODULE "stepping"
+#include <boost/test/included/unit_test.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "swmm5.h"
+// toolkitAPI.h uses the engine's DateTime type without declaring it
+typedef double DateTime;
+#include "toolkitAPI.h"
+
+
+#define INPUT_PATH  "../swmm-nrtestsuite/tests/examples/Example1.inp"
+#define REPORT_PATH "./Example1_stepping.rpt"
+#define OUTPUT_PATH "./Example1_stepping.out"
+
+// Node 9 is the first node of Example1
+#define NODE_9 0
+#define RISE_DEPTH 0.2
+#define FALL_DEPTH 0.05
+
+using namespace std;
+
+// Starts a run of Example1 and closes it when done.
+struct Fixture {
+    Fixture() {
+        BOOST_REQUIRE(swmm_open((char*)INPUT_PATH, (char*)REPORT_PATH,
+                                (char*)OUTPUT_PATH) == 0);
+        BOOST_REQUIRE(swmm_start(0) == 0);
+        elapsedTime = 0.0;
+    }
+    ~Fixture() {
+        swmm_end();
+        swmm_close();
+        remove(REPORT_PATH);
+        remove(OUTPUT_PATH);
+    }
+
+    double elapsedTime;
+};
+
+// A stop condition and the time it became true in a run of single steps
+struct Event {
+    int condition;
+    double elapsedTime;
+};
+
+// Steps a run one routing step at a time, recording the times at which
+// node 9's depth rises to RISE_DEPTH (condition 0) or falls to FALL_DEPTH
+// (condition 1), and the time reached after each of the first 10 steps.
+static void stepSingly(vector<Event>& events, vector<double>& times)
+{
+    Fixture f;
+    double depth = 0.0;
+    bool isMet[2] = { false, true };
+
+    do {
+        BOOST_REQUIRE(swmm_step(&f.elapsedTime) == 0);
+        if (times.size() < 10) times.push_back(f.elapsedTime);
+        if (f.elapsedTime == 0.0) break;
+        swmm_getNodeResult(NODE_9, SM_NODEDEPTH, &depth);
+        bool met[2] = { depth >= RISE_DEPTH, depth <= FALL_DEPTH };
+        int fired = -1;
+        for (int i = 0; i < 2; i++) {
+            if (met[i] && !isMet[i] && fired < 0) fired = i;
+            isMet[i] = met[i];
+        }
+        if (fired >= 0) {
+            Event e = { fired, f.elapsedTime };
+            events.push_back(e);
+        }
+    } while (true);
+}
+
+// The points reached within a routing step and the calls to the engine
+// attempted from its callbacks
+struct StepLog {
+    vector<int> points;
+    vector<double> times;
+    vector<int> errors;
+};
+
+static void logStep(int point, double elapsedTime, void* userData)
+{
+    StepLog* log = (StepLog*)userData;
+    double t = 0.0;
+
+    log->points.push_back(point);
+    log->times.push_back(elapsedTime);
+
+    // the callback may not advance, end or close the run
+    if (log->errors.empty()) {
+        log->errors.push_back(swmm_step(&t));
+        log->errors.push_back(swmm_stepN(1, &t));
+        log->errors.push_back(swmm_end());
+        log->errors.push_back(swmm_close());
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE(test_stepping)
+
+BOOST_AUTO_TEST_CASE(test_stopConditions) {
+    vector<Event> events;
+    vector<double> times;
+    int condition;
+    char id[32];
+
+    stepSingly(events, times);
+    BOOST_REQUIRE(events.size() >= 2);
+    BOOST_CHECK_EQUAL(0, events[0].condition);
+    BOOST_CHECK_EQUAL(1, events[1].condition);
+
+    Fixture f;
+    BOOST_REQUIRE(swmm_getObjectId(SM_NODE, NODE_9, id) == 0);
+    BOOST_REQUIRE(strcmp(id, "9") == 0);
+
+    // the falling condition already holds when the run starts, so it only
+    // stops the run once it becomes true again
+    BOOST_REQUIRE(swmm_addStopCondition(SM_NODE, NODE_9, SM_NODEDEPTH, 1,
+                                        RISE_DEPTH) == 0);
+    BOOST_REQUIRE(swmm_addStopCondition(SM_NODE, NODE_9, SM_NODEDEPTH, -1,
+                                        FALL_DEPTH) == 0);
+    for (size_t k = 0; k < events.size(); k++) {
+        BOOST_REQUIRE(swmm_stepN(1000000, &f.elapsedTime) == 0);
+        BOOST_REQUIRE(swmm_getStopCondition(&condition) == 0);
+        BOOST_CHECK_EQUAL(events[k].condition, condition);
+        BOOST_CHECK_EQUAL(events[k].elapsedTime, f.elapsedTime);
+    }
+
+    // the last call runs to the end of the simulation
+    BOOST_REQUIRE(swmm_stepN(1000000, &f.elapsedTime) == 0);
+    BOOST_CHECK_EQUAL(0.0, f.elapsedTime);
+    BOOST_REQUIRE(swmm_getStopCondition(&condition) == 0);
+    BOOST_CHECK_EQUAL(-1, condition);
+}
+
+BOOST_AUTO_TEST_CASE(test_stepLimits) {
+    vector<Event> events;
+    vector<double> times;
+    int condition;
+
+    stepSingly(events, times);
+    BOOST_REQUIRE(times.size() == 10);
+
+    Fixture f;
+
+    // a step count takes exactly that many routing steps
+    BOOST_REQUIRE(swmm_stepN(4, &f.elapsedTime) == 0);
+    BOOST_CHECK_EQUAL(times[3], f.elapsedTime);
+    BOOST_REQUIRE(swmm_stepN(0, &f.elapsedTime) == 0);
+    BOOST_CHECK_EQUAL(times[3], f.elapsedTime);
+
+    // a target time is reached by the first step that gets to it
+    BOOST_REQUIRE(swmm_stepUntil(times[8], &f.elapsedTime) == 0);
+    BOOST_CHECK_EQUAL(times[8], f.elapsedTime);
+    BOOST_REQUIRE(swmm_stepUntil(times[8] + 1.0e-9, &f.elapsedTime) == 0);
+    BOOST_CHECK_EQUAL(times[9], f.elapsedTime);
+    BOOST_REQUIRE(swmm_getStopCondition(&condition) == 0);
+    BOOST_CHECK_EQUAL(-1, condition);
+
+    // a target time past the end of the run stops at the end
+    BOOST_REQUIRE(swmm_stepUntil(1000.0, &f.elapsedTime) == 0);
+    BOOST_CHECK_EQUAL(0.0, f.elapsedTime);
+}
+
+BOOST_AUTO_TEST_CASE(test_badStepLimits) {
+    Fixture f;
+
+    BOOST_CHECK_EQUAL(501, swmm_stepN(-1, &f.elapsedTime));
+
+    // the error ends the run
+    BOOST_CHECK_EQUAL(501, swmm_step(&f.elapsedTime));
+}
+
+BOOST_AUTO_TEST_CASE(test_stepCallbacks) {
+    StepLog log;
+    double startTime = 0.0;
+    double endTime = 0.0;
+    int reports = 0;
+
+    Fixture f;
+    for (int point = SM_BEFORECONTROLS; point <= SM_REPORTTIME; point++)
+        BOOST_REQUIRE(swmm_setStepCallback(point, logStep, &log) == 0);
+
+    do {
+        startTime = f.elapsedTime;
+        log.points.clear();
+        log.times.clear();
+        BOOST_REQUIRE(swmm_step(&f.elapsedTime) == 0);
+
+        // each routing step reaches the points in order, the first at the
+        // step's starting time and the others at its ending time
+        BOOST_REQUIRE(log.points.size() >= 3);
+        BOOST_CHECK_EQUAL(SM_BEFORECONTROLS, log.points[0]);
+        BOOST_CHECK_EQUAL(SM_AFTERROUTING, log.points[1]);
+        BOOST_CHECK_EQUAL(SM_AFTERQUALITY, log.points[2]);
+        BOOST_CHECK_CLOSE(startTime, log.times[0], 1.0e-9);
+        endTime = log.times[1];
+        BOOST_CHECK(endTime > startTime);
+        BOOST_CHECK_EQUAL(endTime, log.times[2]);
+        if (f.elapsedTime > 0.0) BOOST_CHECK_CLOSE(f.elapsedTime, endTime, 1.0e-9);
+
+        // a step that passes a reporting time then reaches it at that time
+        if (log.points.size() > 3) {
+            BOOST_REQUIRE(log.points.size() == 4);
+            BOOST_CHECK_EQUAL(SM_REPORTTIME, log.points[3]);
+            reports++;
+            BOOST_CHECK_CLOSE(reports / 24.0, log.times[3], 1.0e-9);
+            BOOST_CHECK(log.times[3] > startTime);
+            BOOST_CHECK(log.times[3] <= endTime);
+        }
+    } while (f.elapsedTime > 0.0);
+    BOOST_CHECK_EQUAL(36, reports);
+
+    // calls to run, end or close the simulation from a callback were
+    // refused without stopping the run
+    BOOST_REQUIRE(log.errors.size() == 4);
+    for (int k = 0; k < 4; k++) BOOST_CHECK_EQUAL(511, log.errors[k]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,214 @@
+/*
+ *   test_stream.cpp
+ *
+ *   Unit testing for the live results stream (RESULTS_STREAM option)
+ *   using Boost Test.
+ *
+ *   Runs Example1 while reading each reporting period from the stream's
+ *   shared memory and checks the periods against the binary output file.
+ */
+
+#define BOOST_TEST_MODULE "stream"
+#include <boost/test/included/unit_test.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+#endif
+
+#include "swmm5.h"
+#include "swmm_output.h"
+
+
+// Example1 run with RESULTS_STREAM swmm_test_stream & STREAM_PERIODS 8
+#define INPUT_PATH  "./Example1_stream.inp"
+#define REPORT_PATH "./Example1_stream.rpt"
+#define OUTPUT_PATH "./Example1_stream.out"
+#define STREAM_NAME "swmm_test_stream"
+
+#define STREAM_STAMP 516114527
+#define HEADER_BYTES 64
+
+// Loads a slot's period number with acquire ordering. Reading a period
+// also needs an acquire fence between the copy and the second load (see
+// readPeriod and src/stream.c).
+static long long loadAcquire(const long long* p)
+{
+#ifdef _WIN32
+    long long v = *(const volatile long long*)p;
+    MemoryBarrier();
+    return v;
+#else
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#endif
+}
+
+// Layout of the stream's header (see src/stream.c)
+struct StreamHeader {
+    int       stamp;
+    int       slots;
+    int       slotBytes;
+    int       status;
+    int       count[3];
+    int       results[4];
+    int       reportStep;
+    long long published;
+};
+
+// A reader attached to the stream's shared memory.
+struct StreamReader {
+    StreamReader() : data(NULL), bytes(0) {}
+    ~StreamReader() { detach(); }
+
+    bool attach() {
+#ifdef _WIN32
+        handle = OpenFileMappingA(FILE_MAP_READ, FALSE, STREAM_NAME);
+        if (handle == NULL) return false;
+        data = (char*)MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+        return data != NULL;
+#else
+        int fd = shm_open("/" STREAM_NAME, O_RDONLY, 0);
+        if (fd < 0) return false;
+        struct stat st;
+        void* p = MAP_FAILED;
+        if (fstat(fd, &st) == 0) {
+            bytes = (size_t)st.st_size;
+            p = mmap(NULL, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (p == MAP_FAILED) return false;
+        data = (char*)p;
+        return true;
+#endif
+    }
+
+    void detach() {
+        if (data == NULL) return;
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(handle);
+#else
+        munmap(data, bytes);
+#endif
+        data = NULL;
+    }
+
+    const StreamHeader* header() { return (const StreamHeader*)data; }
+
+    // Copies period n (counting from 1) into buffer, returning false if its
+    // slot no longer holds it or is being written.
+    bool readPeriod(long long n, std::vector<char>& buffer) {
+        const StreamHeader* h = header();
+        char* slot = data + HEADER_BYTES + (size_t)((n - 1) % h->slots) * h->slotBytes;
+        const long long* slotPeriod = (const long long*)slot;
+
+        long long before = loadAcquire(slotPeriod);
+        if (before != n) return false;
+        memcpy(&buffer[0], slot + sizeof(long long), buffer.size());
+#ifdef _WIN32
+        MemoryBarrier();
+#else
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#endif
+        long long after = loadAcquire(slotPeriod);
+        return after == n;
+    }
+
+    char* data;
+    size_t bytes;
+#ifdef _WIN32
+    HANDLE handle;
+#endif
+};
+
+
+BOOST_AUTO_TEST_SUITE(test_stream)
+
+BOOST_AUTO_TEST_CASE(test_publishedPeriods) {
+    StreamReader reader;
+    std::vector< std::vector<char> > periods;
+    std::vector<char> buffer;
+    long long taken = 0;
+    double elapsedTime = 0.0;
+    int error;
+
+    error = swmm_open((char*)INPUT_PATH, (char*)REPORT_PATH, (char*)OUTPUT_PATH);
+    BOOST_REQUIRE(error == 0);
+    error = swmm_start(1);
+    BOOST_REQUIRE(error == 0);
+
+    // the stream is described once it is opened by swmm_start
+    BOOST_REQUIRE(reader.attach());
+    const StreamHeader* h = reader.header();
+    BOOST_REQUIRE(h->stamp == STREAM_STAMP);
+    BOOST_CHECK_EQUAL(8, h->slots);
+    BOOST_CHECK_EQUAL(0, h->status);
+    BOOST_CHECK_EQUAL(3600, h->reportStep);
+    int periodBytes = 8 + 4 * (h->count[0] * h->results[0] +
+        h->count[1] * h->results[1] + h->count[2] * h->results[2] +
+        h->results[3]);
+    buffer.resize(periodBytes);
+
+    // take each period as soon as it is published
+    do {
+        error = swmm_step(&elapsedTime);
+        BOOST_REQUIRE(error == 0);
+        while (taken < loadAcquire(&h->published)) {
+            taken++;
+            BOOST_REQUIRE(reader.readPeriod(taken, buffer));
+            periods.push_back(buffer);
+        }
+    } while (elapsedTime > 0.0);
+    swmm_end();
+    BOOST_CHECK_EQUAL(1, h->status);
+    BOOST_CHECK_EQUAL(36, h->published);
+
+    // periods overwritten in the ring are no longer available
+    BOOST_CHECK(!reader.readPeriod(1, buffer));
+    BOOST_CHECK(reader.readPeriod(36, buffer));
+    BOOST_CHECK(buffer == periods[35]);
+
+    // closing the project removes the stream's name but not the mapping
+    swmm_close();
+    StreamReader late;
+    BOOST_CHECK(!late.attach());
+    BOOST_CHECK_EQUAL(1, h->status);
+
+    // the periods match those saved to the binary output file
+    SMO_Handle p_handle = NULL;
+    float* values = NULL;
+    float value;
+    int length = 0;
+    SMO_init(&p_handle);
+    error = SMO_open(p_handle, OUTPUT_PATH);
+    BOOST_REQUIRE(error == 0);
+    BOOST_REQUIRE(periods.size() == 36);
+    for (int k = 0; k < 36; k++) {
+        int offset = 8 + 4 * (h->count[0] * h->results[0]);
+        for (int j = 0; j < h->count[1]; j++) {
+            error = SMO_getNodeResult(p_handle, k, j, &values, &length);
+            BOOST_REQUIRE(error == 0);
+            for (int v = 0; v < length; v++) {
+                memcpy(&value, &periods[k][offset + 4 * v], sizeof(float));
+                BOOST_CHECK_EQUAL(values[v], value);
+            }
+            offset += 4 * length;
+            SMO_free((void**)&values);
+        }
+    }
+    SMO_close(&p_handle);
+
+    reader.detach();
+    remove(REPORT_PATH);
+    remove(OUTPUT_PATH);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,148 @@
+/*
+ *   test_toolkit.cpp
+ *
+ *   Unit testing for the toolkit API functions that get or set a value of
+ *   many objects in one call using Boost Test.
+ *
+ *   Runs Example1 and checks the bulk functions against the functions that
+ *   get or set a value of a single object.
+ */
+
+#define BOOST_TEST_MODULE "toolkit"
+#include <boost/test/included/unit_test.hpp>
+
+#include <stdio.h>
+#include <vector>
+
+#include "swmm5.h"
+// toolkitAPI.h uses the engine's DateTime type without declaring it
+typedef double DateTime;
+#include "toolkitAPI.h"
+
+
+#define INPUT_PATH  "../swmm-nrtestsuite/tests/examples/Example1.inp"
+#define REPORT_PATH "./Example1_toolkit.rpt"
+#define OUTPUT_PATH "./Example1_toolkit.out"
+
+// API error returned for an object index out of bounds (see swmm_getAPIError)
+#define OBJECT_INDEX_ERROR 108
+
+using namespace std;
+
+// Starts a run of Example1 and closes it when done.
+struct Fixture {
+    Fixture() {
+        BOOST_REQUIRE(swmm_open((char*)INPUT_PATH, (char*)REPORT_PATH,
+                                (char*)OUTPUT_PATH) == 0);
+        BOOST_REQUIRE(swmm_start(0) == 0);
+        BOOST_REQUIRE(swmm_countObjects(SM_NODE, &nNodes) == 0);
+        BOOST_REQUIRE(swmm_countObjects(SM_LINK, &nLinks) == 0);
+        elapsedTime = 0.0;
+    }
+    ~Fixture() {
+        swmm_end();
+        swmm_close();
+        remove(REPORT_PATH);
+        remove(OUTPUT_PATH);
+    }
+
+    int nNodes;
+    int nLinks;
+    double elapsedTime;
+};
+
+
+BOOST_AUTO_TEST_SUITE(test_toolkit)
+
+BOOST_FIXTURE_TEST_CASE(test_getBulkResults, Fixture) {
+    vector<double> results;
+    vector<int> indexes;
+    double value;
+    int step = 0;
+
+    // every other object, in reverse order
+    for (int j = nNodes - 1; j >= 0; j -= 2) indexes.push_back(j);
+
+    do {
+        BOOST_REQUIRE(swmm_step(&elapsedTime) == 0);
+        if (++step % 50 != 0) continue;
+
+        // all nodes & a list of nodes agree with single node results
+        results.resize(nNodes);
+        for (int type = SM_TOTALINFLOW; type <= SM_COUPINFLOW; type++) {
+            BOOST_REQUIRE(swmm_getNodeResults(type, NULL, nNodes, &results[0]) == 0);
+            for (int j = 0; j < nNodes; j++) {
+                BOOST_REQUIRE(swmm_getNodeResult(j, type, &value) == 0);
+                BOOST_CHECK_EQUAL(value, results[j]);
+            }
+            BOOST_REQUIRE(swmm_getNodeResults(type, &indexes[0],
+                          (int)indexes.size(), &results[0]) == 0);
+            for (size_t k = 0; k < indexes.size(); k++) {
+                BOOST_REQUIRE(swmm_getNodeResult(indexes[k], type, &value) == 0);
+                BOOST_CHECK_EQUAL(value, results[k]);
+            }
+        }
+
+        // all links agree with single link results
+        results.resize(nLinks);
+        for (int type = SM_LINKFLOW; type <= SM_FROUDE; type++) {
+            BOOST_REQUIRE(swmm_getLinkResults(type, NULL, nLinks, &results[0]) == 0);
+            for (int j = 0; j < nLinks; j++) {
+                BOOST_REQUIRE(swmm_getLinkResult(j, type, &value) == 0);
+                BOOST_CHECK_EQUAL(value, results[j]);
+            }
+        }
+    } while (elapsedTime > 0.0);
+    BOOST_CHECK(step > 50);
+}
+
+// Runs Example1 for 200 steps after setting an inflow at every node, one
+// node at a time or in one call, and returns the node depths reached.
+static vector<double> runWithInflows(bool inOneCall)
+{
+    Fixture f;
+    vector<double> flowrates(f.nNodes);
+    vector<double> depths(f.nNodes);
+
+    for (int j = 0; j < f.nNodes; j++) flowrates[j] = 0.5 + 0.1 * j;
+    if (inOneCall)
+        BOOST_REQUIRE(swmm_setNodeInflows(NULL, f.nNodes, &flowrates[0]) == 0);
+    else for (int j = 0; j < f.nNodes; j++)
+        BOOST_REQUIRE(swmm_setNodeInflow(j, flowrates[j]) == 0);
+    for (int k = 0; k < 200; k++)
+        BOOST_REQUIRE(swmm_step(&f.elapsedTime) == 0);
+    BOOST_REQUIRE(swmm_getNodeResults(SM_NODEDEPTH, NULL, f.nNodes,
+                                      &depths[0]) == 0);
+    return depths;
+}
+
+BOOST_AUTO_TEST_CASE(test_setBulkInflows) {
+    vector<double> single = runWithInflows(false);
+    vector<double> bulk = runWithInflows(true);
+
+    BOOST_REQUIRE(single.size() == bulk.size());
+    for (size_t j = 0; j < bulk.size(); j++)
+        BOOST_CHECK_EQUAL(single[j], bulk[j]);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_badBulkIndexes, Fixture) {
+    vector<double> values(nNodes + 1, 0.0);
+    int indexes[] = { 0, nNodes };
+
+    // an invalid index or count is rejected
+    BOOST_CHECK_EQUAL(OBJECT_INDEX_ERROR,
+        swmm_getNodeResults(SM_NODEDEPTH, indexes, 2, &values[0]));
+    BOOST_CHECK_EQUAL(OBJECT_INDEX_ERROR,
+        swmm_getNodeResults(SM_NODEDEPTH, NULL, nNodes + 1, &values[0]));
+    BOOST_CHECK_EQUAL(OBJECT_INDEX_ERROR,
+        swmm_getLinkResults(SM_LINKFLOW, NULL, -1, &values[0]));
+    BOOST_CHECK_EQUAL(OBJECT_INDEX_ERROR,
+        swmm_setNodeInflows(indexes, 2, &values[0]));
+    BOOST_CHECK_EQUAL(OBJECT_INDEX_ERROR,
+        swmm_setLinkSettings(indexes, 2, &values[0]));
+
+    // an empty list is accepted
+    BOOST_CHECK_EQUAL(0, swmm_getNodeResults(SM_NODEDEPTH, NULL, 0, NULL));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -18,6 +18,27 @@
 // This is an opaque pointer to struct. Do not access variables.
 typedef void* SMO_Handle;
 
+// A view of values held in a binary output file mapped into memory by
+// SMO_mapFile. Value k begins at byte data + k*stride and need not be
+// aligned on a 4-byte boundary, so read it with SMO_getViewValue (or memcpy).
+// A view remains valid until SMO_unmapFile or SMO_close is called on the
+// handle that produced it. Views are not available for files whose results
+// were saved under output profiles.
+typedef struct {
+	const char* data;           // address of first value
+	int length;                 // number of values
+	int stride;                 // bytes from one value to the next
+} SMO_view;
+
+// A summary of an element attribute's values over all reporting periods,
+// read by SMO_getSummary from files saved with the OUTPUT_SUMMARY option.
+typedef struct {
+	float minimum;              // smallest value
+	float maximum;              // largest value
+	float mean;                 // average value
+	int maxPeriod;              // index of first period with largest value
+} SMO_summary;
+
 typedef enum {
 	SMO_flow_rate,
 	SMO_concentration
@@ -142,6 +163,22 @@ int DLLEXPORT SMO_getLinkResult(SMO_Handle p_handle, int timeIndex,
 int DLLEXPORT SMO_getSystemResult(SMO_Handle p_handle, int timeIndex,
 	int dummyIndex, float** outValueArray, int* arrayLength);
 
+int DLLEXPORT SMO_mapFile(SMO_Handle p_handle);
+int DLLEXPORT SMO_unmapFile(SMO_Handle p_handle);
+int DLLEXPORT SMO_getSeriesView(SMO_Handle p_handle, SMO_elementType type,
+	int elementIndex, int attr, int startPeriod, int endPeriod, SMO_view* view);
+int DLLEXPORT SMO_getAttributeView(SMO_Handle p_handle, SMO_elementType type,
+	int timeIndex, int attr, SMO_view* view);
+float DLLEXPORT SMO_getViewValue(const SMO_view* view, int index);
+
+int DLLEXPORT SMO_getBulkSeries(SMO_Handle p_handle, SMO_elementType type,
+	const int* elementIndexes, int numElements, const int* attributes,
+	int numAttributes, int startPeriod, int endPeriod, int numThreads,
+	float* values);
+
+int DLLEXPORT SMO_getSummary(SMO_Handle p_handle, SMO_elementType type,
+	int elementIndex, int attr, SMO_summary* summary);
+
 void DLLEXPORT SMO_free(void** array);
 void DLLEXPORT SMO_clearError(SMO_Handle p_handle_in);
 int DLLEXPORT SMO_checkError(SMO_Handle p_handle_in, char** msg_buffer);
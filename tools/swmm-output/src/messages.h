@@ -21,10 +21,15 @@
 #define ERR422 "Input Error 422: reporting period index out of range"
 #define ERR423 "Input Error 423: element index out of range"
 #define ERR424 "Input Error 424: no memory allocated for results"
+#define ERR425 "Input Error 425: binary output file is not mapped"
+#define ERR426 "Input Error 426: binary output file has no summary"
 
 #define ERR434 "File Error 434: unable to open binary output file"
 #define ERR435 "File Error 435: invalid file - not created by SWMM"
 #define ERR436 "File Error 436: invalid file - contains no results"
+#define ERR437 "File Error 437: unable to map binary output file"
+#define ERR438 "File Error 438: unable to read binary output file"
+#define ERR439 "File Error 439: results cannot be viewed in place"
 
 #define ERR440 "ERROR 440: an unspecified error has occurred"
 
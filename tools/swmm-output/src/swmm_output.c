@@ -14,6 +14,13 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#endif
 #include "errormanager.h"
 #include "messages.h"
 //#include "datetime.h"
@@ -34,6 +41,13 @@
 
 #define NELEMENTTYPES  4 // Number of element types
 
+#define TRANSPOSED_STAMP  516114523  // Stamp at start of transposed results
+#define PROFILE_STAMP     516114524  // Stamp at start of output profiles
+#define COMPRESSED_STAMP  516114525  // Stamp at end of compressed results
+#define SUMMARY_STAMP     516114526  // Stamp at end of summary of results
+#define SUMMARYSIZE       16         // Bytes of summary of each value
+#define BULK_BUFFER_SIZE  33554432   // Bytes of periods read at once in bulk
+
 #define MEMCHECK(x)  (((x) == NULL) ? 414 : 0 )
 
 struct IDentry {
@@ -72,6 +86,34 @@ typedef struct {
     F_OFF ObjPropPos;				   // file position where object properties start
     F_OFF ResultsPos;                  // file position where results start
     F_OFF BytesPerPeriod;              // bytes used for results in each period
+    F_OFF EndPos;                      // file position where summary (or
+                                       // closing records when none) starts
+    F_OFF SummaryPos;                  // file position of summary (0 if none)
+
+    F_OFF TransposedPos;               // file position of transposed results
+    int   BlockPeriods;                // number of periods per transposed block
+
+    int    Nprofiles;                  // number of output profiles (0 if none)
+    int*   ProfilePeriods;             // periods between a profile's results
+    F_OFF* ProfileBytes;               // bytes of a profile's results per period
+    int*   ValueProfile;               // profile a value is saved under (or -1)
+    int*   ValueSlot;                  // position of value in profile's results
+
+    int    Nchunks;                    // number of compressed chunks (0 if none)
+    int    ChunkPeriods;               // reporting periods per chunk
+    F_OFF* ChunkPos;                   // file position of each chunk
+    F_OFF* ChunkStart;                 // position of chunk's results were they
+                                       // saved uncompressed
+    int    CachedChunk;                // chunk held in ChunkData (or -1)
+    char*  ChunkData;                  // results of the periods in a chunk
+    char*  ChunkWork;                  // chunk's bytes grouped by word place
+    char*  ChunkCode;                  // compressed chunk
+
+    const char* map;                   // file contents mapped into memory
+    F_OFF mapSize;                     // size of mapped file in bytes
+#ifdef _WIN32
+    HANDLE mapHandle;                  // file mapping object
+#endif
 
     error_handle_t* error_handle;
 } data_t;
@@ -83,6 +125,24 @@ typedef struct {
 void errorLookup(int errcode, char* errmsg, int length);
 int    validateFile(data_t* p_data);
 void   initElementNames(data_t* p_data);
+void   findTransposedResults(data_t* p_data);
+void   findSummary(data_t* p_data);
+int    readProfiles(data_t* p_data);
+void   freeProfiles(data_t* p_data);
+F_OFF  getPeriodPos(data_t* p_data, int timeIndex);
+float  getValue(data_t* p_data, int timeIndex, int valueIndex);
+int    readChunkIndex(data_t* p_data);
+void   freeChunks(data_t* p_data);
+int    loadChunk(data_t* p_data, int chunk);
+size_t readFileValues(data_t* p_data, F_OFF offset, void* values, size_t size,
+        size_t count);
+int    getTransposedSeries(data_t* p_data, int valueIndex, int startPeriod,
+        int length, float* series);
+size_t readValues(data_t* p_data, F_OFF offset, void* values, size_t size,
+        size_t count);
+int    getValueIndex(data_t* p_data, SMO_elementType type, int elementIndex,
+        int attr, int* valueIndex, int* elementCount);
+void   unmapFile(data_t* p_data);
 
 double getTimeValue(data_t* p_data, int timeIndex);
 float  getSubcatchValue(data_t* p_data, int timeIndex, int subcatchIndex, SMO_subcatchAttribute attr);
@@ -148,7 +208,11 @@ int DLLEXPORT SMO_close(SMO_Handle* p_handle)
         }
 
         dst_errormanager(p_data->error_handle);
-        
+
+        unmapFile(p_data);
+        freeProfiles(p_data);
+        freeChunks(p_data);
+
         if (p_data->file != NULL)
             fclose(p_data->file);
         
@@ -211,6 +275,10 @@ int DLLEXPORT SMO_open(SMO_Handle p_handle, const char* path)
             _fseek(p_data->file, p_data->LinkVars*RECORDSIZE, SEEK_CUR);
             fread(&(p_data->SysVars), RECORDSIZE, 1, p_data->file);     // # System variables
 
+            // --- read any output profiles that follow the system variable codes
+            _fseek(p_data->file, p_data->SysVars*RECORDSIZE, SEEK_CUR);
+            if (!readProfiles(p_data)) errorcode = 411;
+
             // --- read data just before start of output results
             offset = p_data->ResultsPos - 3 * RECORDSIZE;
             _fseek(p_data->file, offset, SEEK_SET);
@@ -223,6 +291,13 @@ int DLLEXPORT SMO_open(SMO_Handle p_handle, const char* path)
                             p_data->Nnodes*p_data->NodeVars +
                             p_data->Nlinks*p_data->LinkVars +
                             p_data->SysVars)*RECORDSIZE;
+
+            // --- check for a summary of results, then for compressed results
+            //     or results saved by time series just ahead of it
+            findSummary(p_data);
+            if (!readChunkIndex(p_data)) errorcode = 411;
+            else if (p_data->Nprofiles == 0 && p_data->Nchunks == 0)
+                findTransposedResults(p_data);
         }
     }
     // If error close the binary file
@@ -484,6 +559,14 @@ int DLLEXPORT SMO_getSubcatchSeries(SMO_Handle p_handle, int subcatchIndex,
             endPeriod <= startPeriod) errorcode = 422;
     // Check memory for outValues
     else if MEMCHECK(temp = newFloatArray(length = endPeriod - startPeriod)) errorcode = 411;
+    // read the series in blocks if results were also saved by time series
+    else if (p_data->TransposedPos > 0 &&
+            getTransposedSeries(p_data, subcatchIndex*p_data->SubcatchVars + attr,
+            startPeriod, length, temp))
+    {
+        *outValueSeries = temp;
+        *dim = length;
+    }
     else
     {
         // loop over and build time series
@@ -518,6 +601,14 @@ int DLLEXPORT SMO_getNodeSeries(SMO_Handle p_handle, int nodeIndex, SMO_nodeAttr
             endPeriod <= startPeriod) errorcode = 422;
     // Check memory for outValues
     else if MEMCHECK(temp = newFloatArray(length = endPeriod - startPeriod)) errorcode = 411;
+    // read the series in blocks if results were also saved by time series
+    else if (p_data->TransposedPos > 0 &&
+            getTransposedSeries(p_data, p_data->Nsubcatch*p_data->SubcatchVars
+            + nodeIndex*p_data->NodeVars + attr, startPeriod, length, temp))
+    {
+        *outValueSeries = temp;
+        *dim = length;
+    }
     else
     {
         // loop over and build time series
@@ -552,6 +643,15 @@ int DLLEXPORT SMO_getLinkSeries(SMO_Handle p_handle, int linkIndex, SMO_linkAttr
             endPeriod <= startPeriod) errorcode = 422;
     // Check memory for outValues
     else if MEMCHECK(temp = newFloatArray(length = endPeriod - startPeriod)) errorcode = 411;
+    // read the series in blocks if results were also saved by time series
+    else if (p_data->TransposedPos > 0 &&
+            getTransposedSeries(p_data, p_data->Nsubcatch*p_data->SubcatchVars
+            + p_data->Nnodes*p_data->NodeVars + linkIndex*p_data->LinkVars + attr,
+            startPeriod, length, temp))
+    {
+        *outValueSeries = temp;
+        *dim = length;
+    }
     else
     {
         // loop over and build time series
@@ -585,6 +685,15 @@ int DLLEXPORT SMO_getSystemSeries(SMO_Handle p_handle, SMO_systemAttribute attr,
             endPeriod <= startPeriod) errorcode = 422;
     // Check memory for outValues
     else if MEMCHECK(temp = newFloatArray(length = endPeriod - startPeriod)) errorcode = 411;
+    // read the series in blocks if results were also saved by time series
+    else if (p_data->TransposedPos > 0 &&
+            getTransposedSeries(p_data, p_data->Nsubcatch*p_data->SubcatchVars
+            + p_data->Nnodes*p_data->NodeVars + p_data->Nlinks*p_data->LinkVars
+            + attr, startPeriod, length, temp))
+    {
+        *outValueSeries = temp;
+        *dim = length;
+    }
     else
     {
         // loop over and build time series
@@ -720,7 +829,7 @@ int DLLEXPORT SMO_getSubcatchResult(SMO_Handle p_handle, int periodIndex,
 // Purpose: For a subcatchment at given time, get all attributes.
 //
 {
-    int errorcode = 0;
+    int k, errorcode = 0;
     float* temp;
     F_OFF offset;
     data_t* p_data;
@@ -738,8 +847,12 @@ int DLLEXPORT SMO_getSubcatchResult(SMO_Handle p_handle, int periodIndex,
         // add offset for subcatchment
         offset += (subcatchIndex*p_data->SubcatchVars)*RECORDSIZE;
 
-        _fseek(p_data->file, offset, SEEK_SET);
-        fread(temp, RECORDSIZE, p_data->SubcatchVars, p_data->file);
+        // --- values saved under output profiles are located one by one
+        if (p_data->Nprofiles > 0)
+            for (k = 0; k < p_data->SubcatchVars; k++)
+                temp[k] = getSubcatchValue(p_data, periodIndex, subcatchIndex, k);
+        else
+            readValues(p_data, offset, temp, RECORDSIZE, p_data->SubcatchVars);
 
         *outValueArray = temp;
         *arrayLength = p_data->SubcatchVars;
@@ -755,7 +868,7 @@ int DLLEXPORT SMO_getNodeResult(SMO_Handle p_handle, int periodIndex,
 //	Purpose: For a node at given time, get all attributes.
 //
 {
-    int errorcode = 0;
+    int k, errorcode = 0;
     float* temp;
     F_OFF offset;
     data_t* p_data;
@@ -773,8 +886,12 @@ int DLLEXPORT SMO_getNodeResult(SMO_Handle p_handle, int periodIndex,
         // add offset for subcatchment and node
         offset += (p_data->Nsubcatch*p_data->SubcatchVars + nodeIndex*p_data->NodeVars)*RECORDSIZE;
 
-        _fseek(p_data->file, offset, SEEK_SET);
-        fread(temp, RECORDSIZE, p_data->NodeVars, p_data->file);
+        // --- values saved under output profiles are located one by one
+        if (p_data->Nprofiles > 0)
+            for (k = 0; k < p_data->NodeVars; k++)
+                temp[k] = getNodeValue(p_data, periodIndex, nodeIndex, k);
+        else
+            readValues(p_data, offset, temp, RECORDSIZE, p_data->NodeVars);
 
         *outValueArray = temp;
         *arrayLength = p_data->NodeVars;
@@ -789,7 +906,7 @@ int DLLEXPORT SMO_getLinkResult(SMO_Handle p_handle, int periodIndex,
 //	Purpose: For a link at given time, get all attributes.
 //
 {
-    int errorcode = 0;
+    int k, errorcode = 0;
     float* temp;
     F_OFF offset;
     data_t* p_data;
@@ -808,8 +925,12 @@ int DLLEXPORT SMO_getLinkResult(SMO_Handle p_handle, int periodIndex,
         offset += (p_data->Nsubcatch*p_data->SubcatchVars
                 + p_data->Nnodes*p_data->NodeVars + linkIndex*p_data->LinkVars)*RECORDSIZE;
 
-        _fseek(p_data->file, offset, SEEK_SET);
-        fread(temp, RECORDSIZE, p_data->LinkVars, p_data->file);
+        // --- values saved under output profiles are located one by one
+        if (p_data->Nprofiles > 0)
+            for (k = 0; k < p_data->LinkVars; k++)
+                temp[k] = getLinkValue(p_data, periodIndex, linkIndex, k);
+        else
+            readValues(p_data, offset, temp, RECORDSIZE, p_data->LinkVars);
 
         *outValueArray = temp;
         *arrayLength = p_data->LinkVars;
@@ -824,7 +945,7 @@ int DLLEXPORT SMO_getSystemResult(SMO_Handle p_handle, int periodIndex,
 //	Purpose: For the system at given time, get all attributes.
 //
 {
-    int errorcode = 0;
+    int k, errorcode = 0;
     float* temp;
     F_OFF offset;
     data_t* p_data;
@@ -834,6 +955,7 @@ int DLLEXPORT SMO_getSystemResult(SMO_Handle p_handle, int periodIndex,
     if (p_data == NULL) errorcode = -1;
     else if (periodIndex < 0 || periodIndex >= p_data->Nperiods) errorcode = 422;
     else if MEMCHECK(temp = newFloatArray(p_data->SysVars)) errorcode = 411;
+    else
     {
         // calculate byte offset to start time for series
         offset = p_data->ResultsPos + (periodIndex)*p_data->BytesPerPeriod + 2 * RECORDSIZE;
@@ -841,8 +963,11 @@ int DLLEXPORT SMO_getSystemResult(SMO_Handle p_handle, int periodIndex,
         offset += (p_data->Nsubcatch*p_data->SubcatchVars + p_data->Nnodes*p_data->NodeVars
                 + p_data->Nlinks*p_data->LinkVars)*RECORDSIZE;
 
-        _fseek(p_data->file, offset, SEEK_SET);
-        fread(temp, RECORDSIZE, p_data->SysVars, p_data->file);
+        if (p_data->Nprofiles > 0)
+            for (k = 0; k < p_data->SysVars; k++)
+                temp[k] = getSystemValue(p_data, periodIndex, k);
+        else
+            readValues(p_data, offset, temp, RECORDSIZE, p_data->SysVars);
 
         *outValueArray = temp;
         *arrayLength = p_data->SysVars;
@@ -851,6 +976,296 @@ int DLLEXPORT SMO_getSystemResult(SMO_Handle p_handle, int periodIndex,
     return set_error(p_data->error_handle, errorcode);
 }
 
+int DLLEXPORT SMO_mapFile(SMO_Handle p_handle)
+//
+//  Purpose: Maps the open binary output file into memory. Queries are then
+//  answered from the mapped file and views of its values become available.
+//
+{
+    int errorcode = 0;
+    data_t* p_data;
+
+    p_data = (data_t*)p_handle;
+
+    if (p_data == NULL) return -1;
+    else if (p_data->file == NULL) errorcode = 411;
+    else if (p_data->map == NULL)
+    {
+        _fseek(p_data->file, 0L, SEEK_END);
+        p_data->mapSize = _ftell(p_data->file);
+#ifdef _WIN32
+        p_data->mapHandle = CreateFileMapping(
+                (HANDLE)_get_osfhandle(_fileno(p_data->file)), NULL,
+                PAGE_READONLY, 0, 0, NULL);
+        if (p_data->mapHandle != NULL)
+        {
+            p_data->map = (const char*)MapViewOfFile(p_data->mapHandle,
+                    FILE_MAP_READ, 0, 0, 0);
+            if (p_data->map == NULL)
+            {
+                CloseHandle(p_data->mapHandle);
+                p_data->mapHandle = NULL;
+            }
+        }
+#else
+        p_data->map = (const char*)mmap(NULL, (size_t)p_data->mapSize,
+                PROT_READ, MAP_SHARED, fileno(p_data->file), 0);
+        if (p_data->map == MAP_FAILED) p_data->map = NULL;
+#endif
+        if (p_data->map == NULL) errorcode = 437;
+    }
+
+    return set_error(p_data->error_handle, errorcode);
+}
+
+int DLLEXPORT SMO_unmapFile(SMO_Handle p_handle)
+//
+//  Purpose: Releases the memory mapping of the binary output file. Any views
+//  obtained from the mapping are no longer valid afterwards.
+//
+{
+    data_t* p_data;
+
+    p_data = (data_t*)p_handle;
+
+    if (p_data == NULL) return -1;
+    unmapFile(p_data);
+
+    return 0;
+}
+
+int DLLEXPORT SMO_getSeriesView(SMO_Handle p_handle, SMO_elementType type,
+        int elementIndex, int attr, int startPeriod, int endPeriod,
+        SMO_view* view)
+//
+//  Purpose: Returns a view of an element attribute's values over a range of
+//  reporting periods directly in the mapped binary output file.
+//
+{
+    int valueIndex, count, block, errorcode = 0;
+    F_OFF offset, nValues;
+    data_t* p_data;
+
+    p_data = (data_t*)p_handle;
+
+    if (p_data == NULL) return -1;
+    else if (p_data->map == NULL) errorcode = 425;
+    else if (p_data->Nprofiles > 0 || p_data->Nchunks > 0) errorcode = 439;
+    else if (startPeriod < 0 || endPeriod > p_data->Nperiods ||
+            endPeriod <= startPeriod) errorcode = 422;
+    else if ((errorcode = getValueIndex(p_data, type, elementIndex, attr,
+            &valueIndex, &count)) == 0)
+    {
+        view->length = endPeriod - startPeriod;
+        block = p_data->BlockPeriods;
+
+        // use the transposed results if the periods lie in a single block
+        if (p_data->TransposedPos > 0 &&
+                startPeriod / block == (endPeriod - 1) / block)
+        {
+            nValues = (p_data->BytesPerPeriod - DATESIZE) / RECORDSIZE;
+            count = block;
+            block = (startPeriod / block) * block;
+            if (block + count > p_data->Nperiods)
+                count = p_data->Nperiods - block;
+            offset = p_data->TransposedPos + block*nValues*RECORDSIZE
+                    + ((F_OFF)valueIndex*count + (startPeriod - block))*RECORDSIZE;
+            view->stride = RECORDSIZE;
+        }
+        else
+        {
+            offset = p_data->ResultsPos + startPeriod*p_data->BytesPerPeriod
+                    + DATESIZE + (F_OFF)valueIndex*RECORDSIZE;
+            view->stride = (int)p_data->BytesPerPeriod;
+        }
+        view->data = p_data->map + offset;
+    }
+
+    return set_error(p_data->error_handle, errorcode);
+}
+
+int DLLEXPORT SMO_getAttributeView(SMO_Handle p_handle, SMO_elementType type,
+        int periodIndex, int attr, SMO_view* view)
+//
+//  Purpose: Returns a view of an attribute's values for all elements of a
+//  given type at a reporting period directly in the mapped binary output file.
+//
+{
+    int valueIndex, count, errorcode = 0;
+    data_t* p_data;
+
+    p_data = (data_t*)p_handle;
+
+    if (p_data == NULL) return -1;
+    else if (p_data->map == NULL) errorcode = 425;
+    else if (p_data->Nprofiles > 0 || p_data->Nchunks > 0) errorcode = 439;
+    else if (periodIndex < 0 || periodIndex >= p_data->Nperiods) errorcode = 422;
+    else if ((errorcode = getValueIndex(p_data, type, 0, attr, &valueIndex,
+            &count)) == 0)
+    {
+        view->data = p_data->map + p_data->ResultsPos
+                + periodIndex*p_data->BytesPerPeriod + DATESIZE
+                + (F_OFF)valueIndex*RECORDSIZE;
+        view->length = count;
+        switch (type)
+        {
+        case SMO_subcatch: view->stride = p_data->SubcatchVars*RECORDSIZE; break;
+        case SMO_node:     view->stride = p_data->NodeVars*RECORDSIZE;     break;
+        case SMO_link:     view->stride = p_data->LinkVars*RECORDSIZE;     break;
+        default:           view->stride = p_data->SysVars*RECORDSIZE;
+        }
+    }
+
+    return set_error(p_data->error_handle, errorcode);
+}
+
+float DLLEXPORT SMO_getViewValue(const SMO_view* view, int index)
+//
+//  Purpose: Returns the value at a given position in a view. Views into the
+//  mapped file need not be aligned on 4-byte boundaries, so values are copied
+//  out rather than accessed through a float pointer.
+//
+{
+    float value;
+
+    memcpy(&value, view->data + (size_t)index*view->stride, sizeof(float));
+    return value;
+}
+
+int DLLEXPORT SMO_getBulkSeries(SMO_Handle p_handle, SMO_elementType type,
+        const int* elementIndexes, int numElements, const int* attributes,
+        int numAttributes, int startPeriod, int endPeriod, int numThreads,
+        float* values)
+//
+//  Purpose: Fills a caller-provided matrix with the time series of several
+//  attributes of several elements of one type in a single sequential pass
+//  over a range of reporting periods. The series of the a-th attribute of the
+//  e-th element starts at values[(e*numAttributes + a)*(endPeriod - startPeriod)]
+//  so values must hold numElements*numAttributes*(endPeriod - startPeriod)
+//  floats. The values of each block of periods read are distributed among
+//  numThreads threads.
+//
+{
+    int i, j, k, n, length, nSeries, blockPeriods, count, errorcode = 0;
+    int* valueIndex = NULL;
+    char* buffer = NULL;
+    const char* periods;
+    F_OFF offset;
+    data_t* p_data;
+
+    p_data = (data_t*)p_handle;
+
+    if (p_data == NULL) return -1;
+    else if (values == NULL) errorcode = 424;
+    else if (elementIndexes == NULL || numElements <= 0) errorcode = 423;
+    else if (attributes == NULL || numAttributes <= 0) errorcode = 421;
+    else if (startPeriod < 0 || endPeriod > p_data->Nperiods ||
+            endPeriod <= startPeriod) errorcode = 422;
+    else if MEMCHECK(valueIndex = newIntArray(numElements*numAttributes))
+        errorcode = 411;
+    else
+    {
+        // --- locate each series' value within a period
+        nSeries = numElements*numAttributes;
+        for (j = 0; j < nSeries && !errorcode; j++)
+            errorcode = getValueIndex(p_data, type,
+                    elementIndexes[j / numAttributes],
+                    attributes[j % numAttributes], &valueIndex[j], &count);
+
+        // --- values saved under output profiles are located one by one
+        length = endPeriod - startPeriod;
+        if (!errorcode && p_data->Nprofiles > 0)
+        {
+            for (j = 0; j < nSeries; j++)
+                for (i = 0; i < length; i++)
+                    values[(size_t)j*length + i] =
+                            getValue(p_data, startPeriod + i, valueIndex[j]);
+        }
+
+        // --- allocate a buffer for a block of periods unless file is mapped
+        blockPeriods = (int)(BULK_BUFFER_SIZE / p_data->BytesPerPeriod);
+        if (blockPeriods < 1) blockPeriods = 1;
+        if (blockPeriods > length) blockPeriods = length;
+        if (!errorcode && p_data->Nprofiles == 0 &&
+                (p_data->map == NULL || p_data->Nchunks > 0) &&
+                MEMCHECK(buffer = newCharArray(blockPeriods*(int)p_data->BytesPerPeriod)))
+            errorcode = 411;
+        if (numThreads < 1) numThreads = 1;
+
+        // --- read the periods in order, one block at a time
+        for (k = startPeriod; k < endPeriod && !errorcode &&
+                p_data->Nprofiles == 0; k += n)
+        {
+            n = endPeriod - k;
+            if (n > blockPeriods) n = blockPeriods;
+            offset = p_data->ResultsPos + k*p_data->BytesPerPeriod;
+            if (p_data->map != NULL && p_data->Nchunks == 0)
+                periods = p_data->map + offset;
+            else
+            {
+                if (readValues(p_data, offset, buffer,
+                        (size_t)p_data->BytesPerPeriod, n) != (size_t)n)
+                {
+                    errorcode = 438;
+                    break;
+                }
+                periods = buffer;
+            }
+
+            // --- copy each series' values for the block into the matrix
+#pragma omp parallel for num_threads(numThreads) private(i) schedule(static)
+            for (j = 0; j < nSeries; j++)
+            {
+                for (i = 0; i < n; i++)
+                    memcpy(&values[(size_t)j*length + (k - startPeriod) + i],
+                            periods + i*p_data->BytesPerPeriod + DATESIZE
+                            + (F_OFF)valueIndex[j]*RECORDSIZE, RECORDSIZE);
+            }
+        }
+    }
+    free(valueIndex);
+    free(buffer);
+
+    return set_error(p_data->error_handle, errorcode);
+}
+
+int DLLEXPORT SMO_getSummary(SMO_Handle p_handle, SMO_elementType type,
+    int elementIndex, int attr, SMO_summary* summary)
+//
+//  Purpose: Returns the minimum, maximum and mean of an element attribute
+//  over all reporting periods, and the first period with the maximum, from
+//  the summary saved in the file. The reporting periods are not read.
+//
+{
+    int errorcode = 0, valueIndex, count;
+    INT4 record[4];
+    data_t* p_data;
+
+    p_data = (data_t*)p_handle;
+
+    if (p_data == NULL) return -1;
+    else if (summary == NULL) errorcode = 424;
+    else if (p_data->SummaryPos == 0) errorcode = 426;
+    else if ((errorcode = getValueIndex(p_data, type, elementIndex, attr,
+            &valueIndex, &count)) == 0)
+    {
+        // --- the summary of a value is its minimum, maximum & mean
+        //     followed by the first period with the maximum
+        if (readFileValues(p_data, p_data->SummaryPos +
+                (F_OFF)valueIndex*SUMMARYSIZE, record, RECORDSIZE, 4) != 4)
+            errorcode = 438;
+        else
+        {
+            memcpy(&summary->minimum, &record[0], RECORDSIZE);
+            memcpy(&summary->maximum, &record[1], RECORDSIZE);
+            memcpy(&summary->mean, &record[2], RECORDSIZE);
+            summary->maxPeriod = record[3];
+        }
+    }
+
+    return set_error(p_data->error_handle, errorcode);
+}
+
 void DLLEXPORT SMO_free(void** array)
 //
 //  Purpose: Frees memory allocated by API calls
@@ -912,12 +1327,22 @@ void errorLookup(int errcode, char* dest_msg, int dest_len)
     break;
     case 424: msg = ERR424;
     break;
+    case 425: msg = ERR425;
+    break;
+    case 426: msg = ERR426;
+    break;
     case 434: msg = ERR434;
     break;
     case 435: msg = ERR435;
     break;
     case 436: msg = ERR436;
     break;
+    case 437: msg = ERR437;
+    break;
+    case 438: msg = ERR438;
+    break;
+    case 439: msg = ERR439;
+    break;
     default: msg = ERR440;
     }
 
@@ -978,95 +1403,615 @@ void initElementNames(data_t* p_data)
     }
 }
 
-double getTimeValue(data_t* p_data, int timeIndex)
+void findTransposedResults(data_t* p_data)
+//
+//  Purpose: Locates the copy of the results arranged by time series that
+//  follows the last reporting period, if the file contains one.
+//
 {
-    F_OFF offset;
-    double value;
+    INT4 stamp, blockPeriods;
+    F_OFF offset, fileEnd, nValues;
 
-    // --- compute offset into output file
-    offset = p_data->ResultsPos + timeIndex*p_data->BytesPerPeriod;
+    p_data->TransposedPos = 0;
+    p_data->BlockPeriods = 0;
+
+    // --- transposed results start right after the last period
+    offset = p_data->ResultsPos + p_data->Nperiods*p_data->BytesPerPeriod;
+    fileEnd = p_data->EndPos;
+    if (fileEnd <= offset) return;
 
-    // --- re-position the file and read the result
     _fseek(p_data->file, offset, SEEK_SET);
-    fread(&value, RECORDSIZE * 2, 1, p_data->file);
+    if (fread(&stamp, RECORDSIZE, 1, p_data->file) != 1 ||
+        fread(&blockPeriods, RECORDSIZE, 1, p_data->file) != 1) return;
+    if (stamp != TRANSPOSED_STAMP || blockPeriods <= 0) return;
 
-    return value;
+    // --- accept them only if they fill the space before the epilogue
+    nValues = (p_data->BytesPerPeriod - DATESIZE) / RECORDSIZE;
+    if (offset + 2*RECORDSIZE + p_data->Nperiods*nValues*RECORDSIZE != fileEnd)
+        return;
+
+    p_data->TransposedPos = offset + 2*RECORDSIZE;
+    p_data->BlockPeriods = blockPeriods;
 }
 
-float getSubcatchValue(data_t* p_data, int timeIndex, int subcatchIndex,
-        SMO_subcatchAttribute attr)
+int getTransposedSeries(data_t* p_data, int valueIndex, int startPeriod,
+        int length, float* series)
+//
+//  Purpose: Reads a value's time series from the transposed results with one
+//  read per block of periods. Returns 1 if successful, 0 if not.
+//
+{
+    int k, n, first, count;
+    F_OFF offset, nValues;
+
+    if (startPeriod + length > p_data->Nperiods) return 0;
+    nValues = (p_data->BytesPerPeriod - DATESIZE) / RECORDSIZE;
+    k = startPeriod;
+    while (k < startPeriod + length)
+    {
+        // --- find the block holding period k & its size
+        first = (k / p_data->BlockPeriods) * p_data->BlockPeriods;
+        n = p_data->BlockPeriods;
+        if (first + n > p_data->Nperiods) n = p_data->Nperiods - first;
+
+        // --- read the value's periods from k to the end of the block
+        count = first + n - k;
+        if (count > startPeriod + length - k) count = startPeriod + length - k;
+        offset = p_data->TransposedPos + first*nValues*RECORDSIZE
+                + ((F_OFF)valueIndex*n + (k - first))*RECORDSIZE;
+        if (readValues(p_data, offset, series + (k - startPeriod), RECORDSIZE,
+                count) != (size_t)count) return 0;
+        k += count;
+    }
+    return 1;
+}
+
+int readProfiles(data_t* p_data)
+//
+//  Purpose: Reads the output profiles that select which results were saved
+//  for each element and in which periods, if the file contains any. For each
+//  value of a full period it records the profile the value was saved under
+//  and its position among the profile's results. Returns 0 if out of memory.
+//
 {
+    INT4 stamp, n, type, nVars, k;
+    int i, j, first, vars, nValues, nElements;
+    int** profileVars;
+    int* profileVarCount;
+    int* profileCount;
     F_OFF offset;
-    float value;
 
-    // --- compute offset into output file
-    offset = p_data->ResultsPos + timeIndex*p_data->BytesPerPeriod + 2*RECORDSIZE;
-    // offset for subcatch
-    offset += RECORDSIZE*(subcatchIndex*p_data->SubcatchVars + attr);
+    p_data->Nprofiles = 0;
+    offset = _ftell(p_data->file);
+    if (offset + 3*RECORDSIZE >= p_data->ResultsPos) return 1;
+    if (fread(&stamp, RECORDSIZE, 1, p_data->file) != 1 ||
+        stamp != PROFILE_STAMP ||
+        fread(&n, RECORDSIZE, 1, p_data->file) != 1 || n <= 0) return 1;
+
+    nValues = p_data->Nsubcatch*p_data->SubcatchVars + p_data->Nnodes*p_data->NodeVars
+            + p_data->Nlinks*p_data->LinkVars;
+    nElements = p_data->Nsubcatch + p_data->Nnodes + p_data->Nlinks;
+    profileVars = (int**)calloc(n, sizeof(int*));
+    profileVarCount = (int*)calloc(n, sizeof(int));
+    profileCount = (int*)calloc(n, sizeof(int));
+    p_data->ProfilePeriods = (int*)calloc(n, sizeof(int));
+    p_data->ProfileBytes = (F_OFF*)calloc(n, sizeof(F_OFF));
+    p_data->ValueProfile = (int*)malloc((nValues + 1)*sizeof(int));
+    p_data->ValueSlot = (int*)calloc(nValues + 1, sizeof(int));
+    p_data->Nprofiles = n;
+    if (!profileVars || !profileVarCount || !profileCount ||
+        !p_data->ProfilePeriods || !p_data->ProfileBytes ||
+        !p_data->ValueProfile || !p_data->ValueSlot) n = -1;
+
+    // --- read the result variables saved under each profile
+    for (k = 0; k < n; k++)
+    {
+        fread(&type, RECORDSIZE, 1, p_data->file);
+        fread(&(p_data->ProfilePeriods[k]), RECORDSIZE, 1, p_data->file);
+        fread(&nVars, RECORDSIZE, 1, p_data->file);
+        if (p_data->ProfilePeriods[k] < 1) p_data->ProfilePeriods[k] = 1;
+        profileVarCount[k] = nVars;
+        if MEMCHECK(profileVars[k] = newIntArray(nVars + 1))
+        {
+            n = -1;
+            break;
+        }
+        fread(profileVars[k], RECORDSIZE, nVars, p_data->file);
+    }
 
-    // --- re-position the file and read the result
-    _fseek(p_data->file, offset, SEEK_SET);
-    fread(&value, RECORDSIZE, 1, p_data->file);
+    // --- locate the values of each element among its profile's results
+    if (n > 0)
+    {
+        for (i = 0; i < nValues; i++) p_data->ValueProfile[i] = -1;
+        for (j = 0; j < nElements; j++)
+        {
+            if (fread(&k, RECORDSIZE, 1, p_data->file) != 1 || k < 0 || k >= n)
+                continue;
+            if (j < p_data->Nsubcatch)
+            {
+                first = j*p_data->SubcatchVars;
+                vars = p_data->SubcatchVars;
+            }
+            else if (j < p_data->Nsubcatch + p_data->Nnodes)
+            {
+                first = p_data->Nsubcatch*p_data->SubcatchVars
+                        + (j - p_data->Nsubcatch)*p_data->NodeVars;
+                vars = p_data->NodeVars;
+            }
+            else
+            {
+                first = p_data->Nsubcatch*p_data->SubcatchVars
+                        + p_data->Nnodes*p_data->NodeVars
+                        + (j - p_data->Nsubcatch - p_data->Nnodes)*p_data->LinkVars;
+                vars = p_data->LinkVars;
+            }
+            for (i = 0; i < profileVarCount[k]; i++)
+            {
+                if (profileVars[k][i] < 0 || profileVars[k][i] >= vars) continue;
+                p_data->ValueProfile[first + profileVars[k][i]] = k;
+                p_data->ValueSlot[first + profileVars[k][i]] =
+                        profileCount[k]*profileVarCount[k] + i;
+            }
+            profileCount[k]++;
+        }
+        for (k = 0; k < n; k++)
+            p_data->ProfileBytes[k] =
+                    (F_OFF)profileCount[k]*profileVarCount[k]*RECORDSIZE;
+    }
 
-    return value;
+    for (k = 0; k < p_data->Nprofiles && profileVars; k++) free(profileVars[k]);
+    free(profileVars);
+    free(profileVarCount);
+    free(profileCount);
+    if (n < 0)
+    {
+        freeProfiles(p_data);
+        return 0;
+    }
+    return 1;
 }
 
-float getNodeValue(data_t* p_data, int timeIndex, int nodeIndex,
-        SMO_nodeAttribute attr)
+void freeProfiles(data_t* p_data)
+//
+//  Purpose: Frees the memory used for the output profiles.
+//
+{
+    free(p_data->ProfilePeriods);
+    free(p_data->ProfileBytes);
+    free(p_data->ValueProfile);
+    free(p_data->ValueSlot);
+    p_data->ProfilePeriods = NULL;
+    p_data->ProfileBytes = NULL;
+    p_data->ValueProfile = NULL;
+    p_data->ValueSlot = NULL;
+    p_data->Nprofiles = 0;
+}
+
+F_OFF getPeriodPos(data_t* p_data, int timeIndex)
+//
+//  Purpose: Returns the file position where a reporting period starts. When
+//  output profiles are used a period holds its date, the results of each
+//  profile saved in the period and the system results.
+//
+{
+    int k;
+    F_OFF offset;
+
+    if (p_data->Nprofiles == 0)
+        return p_data->ResultsPos + timeIndex*p_data->BytesPerPeriod;
+
+    offset = p_data->ResultsPos
+            + (F_OFF)timeIndex*(DATESIZE + p_data->SysVars*RECORDSIZE);
+    for (k = 0; k < p_data->Nprofiles; k++)
+    {
+        // --- a profile's results are saved in every n-th period from the first
+        offset += (F_OFF)((timeIndex + p_data->ProfilePeriods[k] - 1) /
+                p_data->ProfilePeriods[k])*p_data->ProfileBytes[k];
+    }
+    return offset;
+}
+
+float getValue(data_t* p_data, int timeIndex, int valueIndex)
+//
+//  Purpose: Reads one of the values of a reporting period, where valueIndex
+//  is its position among all values of a period saved without profiles. A
+//  value saved under a profile in fewer periods is taken from the last
+//  period in which it was saved, and one that was not saved is NaN.
+//
 {
+    int k, slot, nValues;
     F_OFF offset;
     float value;
 
-    // --- compute offset into output file
-    offset = p_data->ResultsPos + timeIndex*p_data->BytesPerPeriod + 2*RECORDSIZE;
-    // offset for node
-    offset += RECORDSIZE*(p_data->Nsubcatch*p_data->SubcatchVars + nodeIndex*p_data->NodeVars + attr);
+    if (p_data->Nprofiles == 0)
+        offset = p_data->ResultsPos + timeIndex*p_data->BytesPerPeriod
+                + DATESIZE + (F_OFF)valueIndex*RECORDSIZE;
+    else
+    {
+        nValues = p_data->Nsubcatch*p_data->SubcatchVars
+                + p_data->Nnodes*p_data->NodeVars + p_data->Nlinks*p_data->LinkVars;
+
+        // --- system values follow the results of all profiles
+        if (valueIndex >= nValues)
+        {
+            k = p_data->Nprofiles;
+            slot = valueIndex - nValues;
+        }
+        else
+        {
+            k = p_data->ValueProfile[valueIndex];
+            if (k < 0) return (float)NAN;
+            slot = p_data->ValueSlot[valueIndex];
+            timeIndex -= timeIndex % p_data->ProfilePeriods[k];
+        }
+        offset = getPeriodPos(p_data, timeIndex) + DATESIZE
+                + (F_OFF)slot*RECORDSIZE;
+        while (--k >= 0)
+        {
+            if (timeIndex % p_data->ProfilePeriods[k] == 0)
+                offset += p_data->ProfileBytes[k];
+        }
+    }
 
     // --- re-position the file and read the result
-    _fseek(p_data->file, offset, SEEK_SET);
-    fread(&value, RECORDSIZE, 1, p_data->file);
+    value = 0.0f;
+    readValues(p_data, offset, &value, RECORDSIZE, 1);
 
     return value;
 }
 
-float getLinkValue(data_t* p_data, int timeIndex, int linkIndex,
-        SMO_linkAttribute attr)
+void findSummary(data_t* p_data)
+//
+//  Purpose: Locates the summary of results written just ahead of the
+//  closing records, if the file contains one.
+//
 {
-    F_OFF offset;
-    float value;
+    INT4 trailer[2];
+    F_OFF offset, nValues;
 
-    // --- compute offset into output file
-    offset = p_data->ResultsPos + timeIndex*p_data->BytesPerPeriod + 2*RECORDSIZE;
-    // offset for link
-    offset += RECORDSIZE*(p_data->Nsubcatch*p_data->SubcatchVars + p_data->Nnodes*p_data->NodeVars +
-            linkIndex*p_data->LinkVars + attr);
+    p_data->SummaryPos = 0;
+    _fseek(p_data->file, -6 * RECORDSIZE, SEEK_END);
+    p_data->EndPos = _ftell(p_data->file);
+
+    // --- the summary of each value is followed by the number of values
+    //     and a stamp
+    nValues = (p_data->BytesPerPeriod - DATESIZE) / RECORDSIZE;
+    offset = p_data->EndPos - 2*RECORDSIZE - nValues*SUMMARYSIZE;
+    if (offset <= p_data->ResultsPos) return;
+    _fseek(p_data->file, p_data->EndPos - 2*RECORDSIZE, SEEK_SET);
+    if (fread(trailer, RECORDSIZE, 2, p_data->file) != 2 ||
+        trailer[1] != SUMMARY_STAMP || trailer[0] != nValues) return;
+
+    p_data->SummaryPos = offset;
+    p_data->EndPos = offset;
+}
 
-    // --- re-position the file and read the result
+int readChunkIndex(data_t* p_data)
+//
+//  Purpose: Reads the size of each chunk of compressed results, if the file
+//  contains compressed results, and allocates memory for restoring a chunk.
+//  Returns 0 if out of memory.
+//
+{
+    INT4 trailer[3], length;
+    int c;
+    F_OFF offset, bytes, maxBytes = 0, maxLength = 0;
+
+    p_data->Nchunks = 0;
+    p_data->CachedChunk = -1;
+
+    // --- the chunk sizes are followed by the periods per chunk, the number
+    //     of chunks and a stamp just ahead of any summary and the closing
+    //     records
+    offset = p_data->EndPos - 3 * RECORDSIZE;
     _fseek(p_data->file, offset, SEEK_SET);
-    fread(&value, RECORDSIZE, 1, p_data->file);
+    if (offset <= p_data->ResultsPos ||
+        fread(trailer, RECORDSIZE, 3, p_data->file) != 3 ||
+        trailer[2] != COMPRESSED_STAMP || trailer[0] <= 0 || trailer[1] <= 0)
+        return 1;
+    offset -= (F_OFF)trailer[1]*RECORDSIZE;
+    if (offset < p_data->ResultsPos) return 1;
+
+    p_data->ChunkPos = (F_OFF*)calloc(trailer[1] + 1, sizeof(F_OFF));
+    p_data->ChunkStart = (F_OFF*)calloc(trailer[1] + 1, sizeof(F_OFF));
+    if (!p_data->ChunkPos || !p_data->ChunkStart)
+    {
+        freeChunks(p_data);
+        return 0;
+    }
+    p_data->Nchunks = trailer[1];
+    p_data->ChunkPeriods = trailer[0];
 
-    return value;
+    // --- locate each chunk in the file & among the uncompressed results
+    _fseek(p_data->file, offset, SEEK_SET);
+    p_data->ChunkPos[0] = p_data->ResultsPos;
+    for (c = 0; c < p_data->Nchunks; c++)
+    {
+        length = 0;
+        fread(&length, RECORDSIZE, 1, p_data->file);
+        p_data->ChunkPos[c + 1] = p_data->ChunkPos[c] + length;
+        if (length > maxLength) maxLength = length;
+        p_data->ChunkStart[c] = getPeriodPos(p_data, c*p_data->ChunkPeriods);
+    }
+    p_data->ChunkStart[c] = getPeriodPos(p_data, p_data->Nperiods);
+    for (c = 0; c < p_data->Nchunks; c++)
+    {
+        bytes = p_data->ChunkStart[c + 1] - p_data->ChunkStart[c];
+        if (bytes > maxBytes) maxBytes = bytes;
+    }
+
+    // --- ignore an index that does not match the file
+    if (p_data->ChunkPos[p_data->Nchunks] != offset ||
+        (F_OFF)(p_data->Nchunks - 1)*p_data->ChunkPeriods >= p_data->Nperiods)
+    {
+        freeChunks(p_data);
+        return 1;
+    }
+
+    p_data->ChunkData = newCharArray((int)maxBytes);
+    p_data->ChunkWork = newCharArray((int)maxBytes);
+    p_data->ChunkCode = newCharArray((int)maxLength + 1);
+    if (!p_data->ChunkData || !p_data->ChunkWork || !p_data->ChunkCode)
+    {
+        freeChunks(p_data);
+        return 0;
+    }
+    return 1;
 }
 
-float getSystemValue(data_t* p_data, int timeIndex,
-        SMO_systemAttribute attr)
+void freeChunks(data_t* p_data)
+//
+//  Purpose: Frees the memory used for compressed results.
+//
 {
-    F_OFF offset;
-    float value;
+    free(p_data->ChunkPos);
+    free(p_data->ChunkStart);
+    free(p_data->ChunkData);
+    free(p_data->ChunkWork);
+    free(p_data->ChunkCode);
+    p_data->ChunkPos = NULL;
+    p_data->ChunkStart = NULL;
+    p_data->ChunkData = NULL;
+    p_data->ChunkWork = NULL;
+    p_data->ChunkCode = NULL;
+    p_data->Nchunks = 0;
+    p_data->CachedChunk = -1;
+}
+
+int loadChunk(data_t* p_data, int chunk)
+//
+//  Purpose: Restores the periods of a compressed chunk into ChunkData. Each
+//  chunk is run-length encoded (PackBits) after its bytes were grouped by
+//  their place within a 4-byte word and each word of a period was replaced
+//  by its exclusive-or with the same word of the previous period. Returns 1
+//  if successful, 0 if not.
+//
+{
+    int i, j, m, c, first, n;
+    F_OFF k, bytes, length, nWords, start, prevSize, size;
+    unsigned char* in = (unsigned char*)p_data->ChunkCode;
+    unsigned char* out = (unsigned char*)p_data->ChunkWork;
+    unsigned char* data = (unsigned char*)p_data->ChunkData;
+    unsigned int w, v;
+
+    if (chunk == p_data->CachedChunk) return 1;
+    p_data->CachedChunk = -1;
+    bytes = p_data->ChunkStart[chunk + 1] - p_data->ChunkStart[chunk];
+    length = p_data->ChunkPos[chunk + 1] - p_data->ChunkPos[chunk];
+    if (readFileValues(p_data, p_data->ChunkPos[chunk], in, 1, (size_t)length)
+            != (size_t)length) return 0;
+
+    // --- undo the run-length encoding
+    i = 0;
+    k = 0;
+    while (i < length && k < bytes)
+    {
+        c = in[i++];
+        if (c > 128)
+        {
+            m = 257 - c;
+            if (i >= length || k + m > bytes) return 0;
+            memset(out + k, in[i++], m);
+        }
+        else
+        {
+            m = c + 1;
+            if (i + m > length || k + m > bytes) return 0;
+            memcpy(out + k, in + i, m);
+            i += m;
+        }
+        k += m;
+    }
+    if (k < bytes) return 0;
+
+    // --- return bytes to their words
+    nWords = bytes / RECORDSIZE;
+    for (k = 0; k < nWords; k++)
+        for (i = 0; i < RECORDSIZE; i++)
+            data[k*RECORDSIZE + i] = out[i*nWords + k];
+
+    // --- add back the previous period to each word
+    first = chunk*p_data->ChunkPeriods;
+    n = p_data->ChunkPeriods;
+    if (first + n > p_data->Nperiods) n = p_data->Nperiods - first;
+    start = 0;
+    prevSize = 0;
+    for (j = 0; j < n; j++)
+    {
+        size = getPeriodPos(p_data, first + j + 1) - getPeriodPos(p_data, first + j);
+        if (j > 0)
+        {
+            for (k = 0; k < size && k < prevSize; k += RECORDSIZE)
+            {
+                memcpy(&w, data + start + k, RECORDSIZE);
+                memcpy(&v, data + start - prevSize + k, RECORDSIZE);
+                w ^= v;
+                memcpy(data + start + k, &w, RECORDSIZE);
+            }
+        }
+        start += size;
+        prevSize = size;
+    }
+    p_data->CachedChunk = chunk;
+    return 1;
+}
 
-    // --- compute offset into output file
-    offset = p_data->ResultsPos + timeIndex*p_data->BytesPerPeriod + 2*RECORDSIZE;
-    //  offset for system
-    offset += RECORDSIZE*(p_data->Nsubcatch*p_data->SubcatchVars + p_data->Nnodes*p_data->NodeVars +
-            p_data->Nlinks*p_data->LinkVars + attr);
+size_t readValues(data_t* p_data, F_OFF offset, void* values, size_t size,
+        size_t count)
+//
+//  Purpose: Reads values starting at a given position of the results, were
+//  they saved uncompressed, restoring them from the compressed chunks that
+//  hold them when results are compressed.
+//
+{
+    int lo, hi, c;
+    F_OFF n, bytes = (F_OFF)(size*count);
+    char* p = (char*)values;
 
-    // --- re-position the file and read the result
+    if (p_data->Nchunks == 0 || offset < p_data->ResultsPos)
+        return readFileValues(p_data, offset, values, size, count);
+
+    while (bytes > 0)
+    {
+        // --- find the chunk holding offset
+        if (offset >= p_data->ChunkStart[p_data->Nchunks]) return 0;
+        lo = 0;
+        hi = p_data->Nchunks - 1;
+        while (lo < hi)
+        {
+            c = (lo + hi + 1) / 2;
+            if (p_data->ChunkStart[c] <= offset) lo = c;
+            else hi = c - 1;
+        }
+        if (!loadChunk(p_data, lo)) return 0;
+
+        // --- copy as much of the values as the chunk holds
+        n = p_data->ChunkStart[lo + 1] - offset;
+        if (n > bytes) n = bytes;
+        memcpy(p, p_data->ChunkData + (offset - p_data->ChunkStart[lo]), (size_t)n);
+        p += n;
+        offset += n;
+        bytes -= n;
+    }
+    return count;
+}
+
+size_t readFileValues(data_t* p_data, F_OFF offset, void* values, size_t size,
+        size_t count)
+//
+//  Purpose: Reads values starting at a given file position, copying them
+//  from the mapped file when it is mapped.
+//
+{
+    if (p_data->map != NULL)
+    {
+        if (offset < 0 || offset + (F_OFF)(size*count) > p_data->mapSize)
+            return 0;
+        memcpy(values, p_data->map + offset, size*count);
+        return count;
+    }
     _fseek(p_data->file, offset, SEEK_SET);
-    fread(&value, RECORDSIZE, 1, p_data->file);
+    return fread(values, size, count, p_data->file);
+}
+
+int getValueIndex(data_t* p_data, SMO_elementType type, int elementIndex,
+        int attr, int* valueIndex, int* elementCount)
+//
+//  Purpose: Finds the position of an element attribute's value among all of
+//  the values saved for a reporting period, and the number of elements of
+//  the element's type.
+//
+{
+    int first = 0, vars;
+
+    switch (type)
+    {
+    case SMO_subcatch:
+        *elementCount = p_data->Nsubcatch;
+        vars = p_data->SubcatchVars;
+        break;
+    case SMO_node:
+        first = p_data->Nsubcatch*p_data->SubcatchVars;
+        *elementCount = p_data->Nnodes;
+        vars = p_data->NodeVars;
+        break;
+    case SMO_link:
+        first = p_data->Nsubcatch*p_data->SubcatchVars
+                + p_data->Nnodes*p_data->NodeVars;
+        *elementCount = p_data->Nlinks;
+        vars = p_data->LinkVars;
+        break;
+    case SMO_sys:
+        first = p_data->Nsubcatch*p_data->SubcatchVars
+                + p_data->Nnodes*p_data->NodeVars
+                + p_data->Nlinks*p_data->LinkVars;
+        *elementCount = 1;
+        vars = p_data->SysVars;
+        elementIndex = 0;
+        break;
+    default:
+        return 421;
+    }
+    if (attr < 0 || attr >= vars) return 421;
+    if (elementIndex < 0 || elementIndex >= *elementCount) return 423;
+    *valueIndex = first + elementIndex*vars + attr;
+    return 0;
+}
+
+void unmapFile(data_t* p_data)
+//
+//  Purpose: Removes the memory mapping of the binary output file, if any.
+//
+{
+    if (p_data->map == NULL) return;
+#ifdef _WIN32
+    UnmapViewOfFile(p_data->map);
+    CloseHandle(p_data->mapHandle);
+    p_data->mapHandle = NULL;
+#else
+    munmap((void*)p_data->map, (size_t)p_data->mapSize);
+#endif
+    p_data->map = NULL;
+    p_data->mapSize = 0;
+}
+
+double getTimeValue(data_t* p_data, int timeIndex)
+{
+    double value;
+
+    // --- re-position the file and read the period's date
+    readValues(p_data, getPeriodPos(p_data, timeIndex), &value, RECORDSIZE * 2, 1);
 
     return value;
 }
 
+float getSubcatchValue(data_t* p_data, int timeIndex, int subcatchIndex,
+        SMO_subcatchAttribute attr)
+{
+    return getValue(p_data, timeIndex, subcatchIndex*p_data->SubcatchVars + attr);
+}
+
+float getNodeValue(data_t* p_data, int timeIndex, int nodeIndex,
+        SMO_nodeAttribute attr)
+{
+    return getValue(p_data, timeIndex, p_data->Nsubcatch*p_data->SubcatchVars +
+            nodeIndex*p_data->NodeVars + attr);
+}
+
+float getLinkValue(data_t* p_data, int timeIndex, int linkIndex,
+        SMO_linkAttribute attr)
+{
+    return getValue(p_data, timeIndex, p_data->Nsubcatch*p_data->SubcatchVars +
+            p_data->Nnodes*p_data->NodeVars + linkIndex*p_data->LinkVars + attr);
+}
+
+float getSystemValue(data_t* p_data, int timeIndex,
+        SMO_systemAttribute attr)
+{
+    return getValue(p_data, timeIndex, p_data->Nsubcatch*p_data->SubcatchVars +
+            p_data->Nnodes*p_data->NodeVars + p_data->Nlinks*p_data->LinkVars + attr);
+}
+
 int _fopen(FILE **f, const char *name, const char *mode) {
     //
     //  Purpose: Substitute for fopen_s on platforms where it doesn't exist
@@ -229,6 +229,8 @@ SMO_nodeAttribute, SMO_linkAttribute, SMO_systemAttribute};
 /* INSERT EXCEPTION HANDLING FOR THESE FUNCTIONS */  
 
 int DLLEXPORT SMO_open(SMO_Handle p_handle, const char* path);
+int DLLEXPORT SMO_mapFile(SMO_Handle p_handle);
+int DLLEXPORT SMO_unmapFile(SMO_Handle p_handle);
 
 int DLLEXPORT SMO_getVersion(SMO_Handle p_handle, int* int_out);
 int DLLEXPORT SMO_getProjectSize(SMO_Handle p_handle, int** int_out, int* int_dim);